@@ -0,0 +1,367 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: AccountDictionary.h                              ||
+//  || Section: Account Dictionary                            ||
+//  || Dense 32-bit account ids kept next to the clients      ||
+//  || file, and the string arena they are interned in.       ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Durability.h"
+#include "HashIndex.h"
+#include "FileManager.h"
+#include <filesystem>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+//=====================================================
+//=================== String Arena ====================
+// A strStringArena interns strings without a string or a
+// hash node per entry:
+// 1. The text of every string lives back to back in one
+//    buffer; string id n spans Offsets[n]..Offsets[n+1]
+// 2. An open-addressing table (FNV-1a, at most half
+//    full) maps text to id + 1
+// Ids are dense and never change. Views returned by
+// getArenaString() are valid until the next string is
+// added.
+//=====================================================
+
+// Number of strings in an arena
+size_t getArenaCount(const strStringArena& arena) {
+    return arena.Offsets.size() - 1;
+}
+// Text of a string id
+string_view getArenaString(const strStringArena& arena, uint32_t id) {
+    return string_view(arena.Chars).substr(arena.Offsets[id], arena.Offsets[id + 1] - arena.Offsets[id]);
+}
+// Table slot holding text, or the empty slot where it belongs
+size_t findArenaSlot(const strStringArena& arena, string_view text) {
+    size_t mask = arena.Slots.size() - 1;
+    size_t slot = hashIndexKey(text) & mask;
+    while (arena.Slots[slot] != 0 && getArenaString(arena, arena.Slots[slot] - 1) != text) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+// Id of text, NoArenaId if not interned
+uint32_t findArenaId(const strStringArena& arena, string_view text) {
+    if (arena.Slots.empty()) {
+        return NoArenaId;
+    }
+    uint32_t entry = arena.Slots[findArenaSlot(arena, text)];
+    return entry == 0 ? NoArenaId : entry - 1;
+}
+// Double the table and re-insert every id
+void growArenaTable(strStringArena& arena) {
+    arena.Slots.assign(max<size_t>(16, arena.Slots.size() * 2), 0);
+    uint32_t count = static_cast<uint32_t>(getArenaCount(arena));
+    for (uint32_t id = 0; id < count; id++) {
+        arena.Slots[findArenaSlot(arena, getArenaString(arena, id))] = id + 1;
+    }
+}
+// Id of text, adding it if new
+uint32_t internArenaString(strStringArena& arena, string_view text) {
+    if ((getArenaCount(arena) + 1) * 2 > arena.Slots.size()) {
+        growArenaTable(arena);
+    }
+
+    size_t slot = findArenaSlot(arena, text);
+    if (arena.Slots[slot] == 0) {
+        arena.Chars.append(text.data(), text.size());
+        arena.Offsets.push_back(static_cast<uint32_t>(arena.Chars.size()));
+        arena.Slots[slot] = static_cast<uint32_t>(getArenaCount(arena));
+    }
+    return arena.Slots[slot] - 1;
+}
+// Make room for count more strings of about charsEach characters
+void reserveArena(strStringArena& arena, size_t count, size_t charsEach) {
+    arena.Chars.reserve(arena.Chars.size() + count * charsEach);
+    arena.Offsets.reserve(arena.Offsets.size() + count);
+    while ((getArenaCount(arena) + count) * 2 > arena.Slots.size()) {
+        growArenaTable(arena);
+    }
+}
+
+//=====================================================
+//================ Account Dictionary =================
+// Every account number has a dense 32-bit id, so the
+// per-account structures (history index, balance
+// columns) hold a uint32_t instead of a string:
+// 1. Ids are given in first-seen order: clients at load,
+//    then any account the ledger still names after its
+//    client was deleted. An id is never reused
+// 2. <Clients>.ids lists one account number per line;
+//    line n is id n. New ids are appended before anything
+//    that stores them (the transaction index sidecar) is
+//    written, so a stored id always resolves
+// 3. Processes share the file: the first new id takes
+//    the lock of <Clients>.ids.lock and reads the ids
+//    other processes appended since, the flush appends
+//    and releases it. Two processes never give one id
+//    to different accounts
+// 4. Loads of changed client files and of the sidecar
+//    read the ids appended since, too
+// 5. A missing or damaged file starts a new dictionary;
+//    the transaction index sidecar, whose ids belong to
+//    the old one, is dropped and rebuilt on next use
+//=====================================================
+
+// Build the dictionary file name for a clients file
+string getAccountDictionaryFileName(const string& clientsFileName) {
+    return clientsFileName + AccountIdsExtension;
+}
+// Empty the in-memory dictionary for a file (the lock, if held, stays)
+void clearAccountDictionary(const string& fileName) {
+    AccountIds.Accounts = strStringArena();
+    AccountIds.FileName = fileName;
+    AccountIds.PersistedCount = 0;
+    AccountIds.PersistedBytes = 0;
+}
+// Start an empty dictionary whose file is (re)written from id 0
+void resetAccountDictionary(const string& fileName) {
+    clearAccountDictionary(fileName);
+
+    ofstream out(fileName, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to create account id file: " + fileName, ERROR_LOG);
+    }
+
+    TransactionIndex = strTransactionIndex();
+    remove(getTransactionIndexFileName(TransactionsFileName).c_str());
+}
+// Read a dictionary file into memory (a missing or damaged one is started over)
+void loadAccountDictionary(const string& fileName) {
+    string content;
+    if (!readFileToString(fileName, content) || content.empty()) {
+        resetAccountDictionary(fileName);
+        return;
+    }
+
+    clearAccountDictionary(fileName);
+
+    // A last line without newline was cut off by a crash; its id was never used
+    content.resize(content.rfind('\n') == string::npos ? 0 : content.rfind('\n') + 1);
+    reserveArena(AccountIds.Accounts, countLines(content), 8);
+
+    bool valid = true;
+    forEachLine(content, [&](string_view line) {
+        line = trimView(line);
+        if (!valid || line.empty()) return;
+        size_t expected = getArenaCount(AccountIds.Accounts);
+        if (internArenaString(AccountIds.Accounts, line) != expected) {
+            valid = false;
+        }
+    });
+    if (!valid) {
+        logMessage("Account id file has a duplicate account, ids reassigned: " + fileName, CRITICAL);
+        resetAccountDictionary(fileName);
+        return;
+    }
+
+    AccountIds.PersistedCount = getArenaCount(AccountIds.Accounts);
+    AccountIds.PersistedBytes = content.size();
+    logMessage("Loaded " + formatInt(AccountIds.PersistedCount) + " account ids", INFO);
+}
+// Load the dictionary of the clients file once per process
+void ensureAccountDictionary(const string& clientsFileName = ClientsFileName) {
+    string fileName = getAccountDictionaryFileName(clientsFileName);
+    if (AccountIds.FileName != fileName) {
+        loadAccountDictionary(fileName);
+    }
+}
+// Read the dictionary file again, dropping what was built on the ids held so far
+void reloadAccountDictionary() {
+    loadAccountDictionary(AccountIds.FileName);
+    TransactionIndex = strTransactionIndex();
+    clearRecentTransactions();
+}
+// Whether this process holds the dictionary lock
+bool isAccountDictionaryLocked() {
+#ifdef _WIN32
+    return AccountIds.Lock != INVALID_HANDLE_VALUE;
+#else
+    return AccountIds.Lock >= 0;
+#endif
+}
+// Release the dictionary lock (no-op if not held)
+void unlockAccountDictionary() {
+#ifdef _WIN32
+    if (AccountIds.Lock != INVALID_HANDLE_VALUE) {
+        CloseHandle(AccountIds.Lock);
+    }
+    AccountIds.Lock = INVALID_HANDLE_VALUE;
+#else
+    if (AccountIds.Lock >= 0) {
+        close(AccountIds.Lock);
+    }
+    AccountIds.Lock = -1;
+#endif
+}
+// Take the ids other processes appended since the file was read. Under the lock a line cut off
+// by a crash is removed, so the next append does not continue it
+void readAccountDictionaryTail() {
+    // Ids not yet in the file exist only under the lock, while nobody else can append
+    if (getArenaCount(AccountIds.Accounts) != AccountIds.PersistedCount) {
+        return;
+    }
+
+    ifstream file(AccountIds.FileName, ios::binary | ios::ate);
+    long long size = file.is_open() ? static_cast<long long>(file.tellg()) : -1;
+    if (size == static_cast<long long>(AccountIds.PersistedBytes)) {
+        return;
+    }
+    if (size < static_cast<long long>(AccountIds.PersistedBytes)) {
+        logMessage("Account id file was replaced by another process, reloading: " + AccountIds.FileName, WARNING);
+        reloadAccountDictionary();
+        return;
+    }
+
+    string tail(static_cast<size_t>(size - AccountIds.PersistedBytes), '\0');
+    file.seekg(static_cast<streamoff>(AccountIds.PersistedBytes));
+    file.read(&tail[0], static_cast<streamsize>(tail.size()));
+    if (!file) {
+        return;
+    }
+
+    size_t complete = tail.rfind('\n') == string::npos ? 0 : tail.rfind('\n') + 1;
+    bool valid = true;
+    forEachLine(string_view(tail).substr(0, complete), [&](string_view line) {
+        line = trimView(line);
+        if (!valid || line.empty()) return;
+        size_t expected = getArenaCount(AccountIds.Accounts);
+        if (internArenaString(AccountIds.Accounts, line) != expected) {
+            valid = false;
+        }
+    });
+    if (!valid) {
+        logMessage("Account id file has a duplicate account, ids reassigned: " + AccountIds.FileName, CRITICAL);
+        resetAccountDictionary(AccountIds.FileName);
+        clearRecentTransactions();
+        return;
+    }
+    AccountIds.PersistedCount = getArenaCount(AccountIds.Accounts);
+    AccountIds.PersistedBytes += complete;
+
+    if (complete < tail.size() && isAccountDictionaryLocked()) {
+        error_code error;
+        filesystem::resize_file(AccountIds.FileName, AccountIds.PersistedBytes, error);
+        logMessage("Removed a cut-off line from account id file: " + AccountIds.FileName,
+            error ? ERROR_LOG : WARNING);
+    }
+}
+// Take the dictionary lock (waiting for another process's flush) and catch up with its ids
+void lockAccountDictionary() {
+    if (isAccountDictionaryLocked()) {
+        return;
+    }
+
+    string lockFileName = AccountIds.FileName + AccountIdsLockExtension;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(lockFileName.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    OVERLAPPED overlapped = {};
+    if (file != INVALID_HANDLE_VALUE && !LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped)) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+    AccountIds.Lock = file;
+#else
+    int fd = open(lockFileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    AccountIds.Lock = fd;
+#endif
+    if (!isAccountDictionaryLocked()) {
+        logMessage("Failed to lock account id file: " + lockFileName, ERROR_LOG);
+    }
+    readAccountDictionaryTail();
+}
+// Take the ids other processes appended since the dictionary was read (after their files changed)
+void refreshAccountDictionary() {
+    ensureAccountDictionary();
+    readAccountDictionaryTail();
+}
+// Number of account ids given so far
+size_t getAccountIdCount() {
+    ensureAccountDictionary();
+    return getArenaCount(AccountIds.Accounts);
+}
+// Id of an account number, NoAccountId if it has none
+uint32_t getAccountId(string_view accountNumber) {
+    ensureAccountDictionary();
+    return findArenaId(AccountIds.Accounts, accountNumber);
+}
+// Id of an account number, giving it a new id if needed (NoAccountId for ""); flushAccountDictionary() stores it
+// and releases the lock a new id takes
+uint32_t internAccountId(string_view accountNumber) {
+    ensureAccountDictionary();
+    if (accountNumber.empty()) {
+        return NoAccountId;
+    }
+    uint32_t id = findArenaId(AccountIds.Accounts, accountNumber);
+    if (id != NoArenaId) {
+        return id;
+    }
+
+    // Another process may have given the account its id already
+    lockAccountDictionary();
+    return internArenaString(AccountIds.Accounts, accountNumber);
+}
+// Account number of an id ("" for NoAccountId or an unknown id)
+string_view getAccountNumberById(uint32_t id) {
+    ensureAccountDictionary();
+    return id < getArenaCount(AccountIds.Accounts) ? getArenaString(AccountIds.Accounts, id) : string_view();
+}
+// Append the ids given since the last flush to the dictionary file and release the lock, false on failure
+// (the unstored ids are then dropped with everything built on them)
+bool flushAccountDictionary() {
+    size_t count = getArenaCount(AccountIds.Accounts);
+    if (AccountIds.PersistedCount >= count) {
+        unlockAccountDictionary();
+        return true;
+    }
+
+    string lines;
+    for (size_t id = AccountIds.PersistedCount; id < count; id++) {
+        lines += getArenaString(AccountIds.Accounts, static_cast<uint32_t>(id));
+        lines += '\n';
+    }
+
+    ofstream out(AccountIds.FileName, ios::binary | ios::app);
+    out << lines;
+    out.close();
+    if (!out) {
+        logMessage("Failed to append to account id file: " + AccountIds.FileName, ERROR_LOG);
+        unlockAccountDictionary();
+        reloadAccountDictionary();
+        return false;
+    }
+    noteDurableWrite(AccountIds.FileName, AccountIds.PersistedCount == 0);
+    AccountIds.PersistedCount = count;
+    AccountIds.PersistedBytes += lines.size();
+    unlockAccountDictionary();
+    return true;
+}
+// Give every loaded client an id and store the new ones
+void registerClientAccounts(const vector<strClient>& vClients) {
+    refreshAccountDictionary();
+    size_t known = getArenaCount(AccountIds.Accounts);
+    if (vClients.size() > known) {
+        reserveArena(AccountIds.Accounts, vClients.size() - known, 8);
+    }
+    for (const strClient& client : vClients) {
+        internAccountId(client.AccountNumber);
+    }
+    flushAccountDictionary();
+}
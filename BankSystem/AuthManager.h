@@ -13,6 +13,7 @@
 #include "InputManager.h"
 #include "FileManager.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include "Session.h"
 #include "UserManager.h"
 
@@ -25,6 +26,7 @@ void showMainMenu(vector<strClient>& vClients);
 
 // Hash password securely using libsodium
 string hashPassword(const string& password) {
+    strMetricTimer timer(METRIC_HASH_PASSWORD);
     char hashed[crypto_pwhash_STRBYTES];
 
     if (crypto_pwhash_str(
@@ -64,8 +66,10 @@ void login() {
         string name = readNonEmptyString("Please Enter UserName? ");
         string password = readNonEmptyString("Please Enter Password? ");
 
+        chrono::steady_clock::time_point started = chrono::steady_clock::now();
         strUser* user = findUserByUsername(name, vUsers);
         found = verifyUserPassword(password, user);
+        recordMetric(METRIC_LOGIN, started);
 
         if (found) {
             logLoginAttempt(user->UserName, true);
@@ -0,0 +1,264 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: BatchManager.h                                   ||
+//  || Section: Batch Transactions                            ||
+//  || Headless engine that applies a file of deposits,       ||
+//  || withdrawals and transfers and commits them at once.    ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Session.h"
+#include "Logger.h"
+#include "Durability.h"
+#include "FileManager.h"
+#include "Journal.h"
+#include "PermissionManager.h"
+#include "ClientManager.h"
+#include "TransactionManager.h"
+
+//=====================================================
+//================ Batch Transactions =================
+// One operation per line, the description is optional:
+//   DEPOSIT#//#Account#//#Amount#//#Description
+//   WITHDRAW#//#Account#//#Amount#//#Description
+//   TRANSFER#//#From#//#To#//#Amount#//#Description
+// 1. Each line is checked with the same rules as the
+//    screens, against balances left by earlier lines
+// 2. Failed lines are reported and skipped
+// 3. Applied lines are committed once: one batched ledger
+//    append, then one Clients.txt write (a checkpoint)
+//=====================================================
+
+// Parse one batch line into an operation, false with error if malformed
+bool parseBatchOperation(string_view line, size_t lineNumber, strBatchOperation& operation, string& error) {
+    string_view fields[5];
+    size_t count = splitFieldViews(line, Separator, fields, 5);
+
+    string_view type = count > 0 ? trimView(fields[0]) : string_view();
+    size_t accountFields;
+    if (type == "DEPOSIT") {
+        operation.Type = DEPOSIT;
+        accountFields = 1;
+    }
+    else if (type == "WITHDRAW") {
+        operation.Type = WITHDRAWAL;
+        accountFields = 1;
+    }
+    else if (type == "TRANSFER") {
+        operation.Type = TRANSFER;
+        accountFields = 2;
+    }
+    else {
+        error = "Unknown operation type: " + string(type);
+        return false;
+    }
+
+    size_t amountField = 1 + accountFields;
+    if (count < amountField + 1 || count > amountField + 2) {
+        error = "Expected " + formatInt(static_cast<int>(amountField + 1)) + " or " +
+            formatInt(static_cast<int>(amountField + 2)) + " fields, found " + formatInt(static_cast<int>(count));
+        return false;
+    }
+
+    operation.LineNumber = lineNumber;
+    operation.FromAccount = string(trimView(fields[1]));
+    operation.ToAccount = string(trimView(fields[accountFields]));
+    operation.Description = count > amountField + 1 ? string(trimView(fields[amountField + 1])) : "";
+
+    if (parseMoneyField(fields[amountField], operation.Amount) != errc() || operation.Amount <= 0) {
+        error = "Invalid amount! Please enter a positive value.";
+        return false;
+    }
+    return true;
+}
+// Validate and apply one operation to the in-memory clients, return error message or "" if applied
+string applyBatchOperation(const strBatchOperation& operation, vector<strClient>& vClients, Transaction& transaction) {
+    if (operation.Type == TRANSFER) {
+        strClient* fromClient = nullptr;
+        strClient* toClient = nullptr;
+        string error = checkTransferAccounts(operation.FromAccount, operation.ToAccount, fromClient, toClient, vClients);
+        if (!error.empty()) return error;
+
+        Money transferFee = calculateTransferFee(operation.Amount);
+        error = checkTransferAmount(operation.Amount, transferFee, fromClient);
+        if (!error.empty()) return error;
+
+        executeTransfer(fromClient, toClient, operation.Amount, transferFee);
+        string description = operation.Description.empty() ? "Transfer to " + toClient->Name : operation.Description;
+        transaction = createTransferTransaction(operation.FromAccount, operation.ToAccount,
+            operation.Amount, transferFee, description);
+        return "";
+    }
+
+    strClient* client = findClientByAccountNumber(operation.FromAccount, vClients);
+    if (operation.Type == WITHDRAWAL) {
+        string error = checkWithdrawAmount(client, operation.Amount);
+        if (!error.empty()) return error;
+
+        client->AccountBalance -= operation.Amount;
+        transaction = operation.Description.empty() ?
+            createWithdrawTransaction(operation.FromAccount, operation.Amount) :
+            createWithdrawTransaction(operation.FromAccount, operation.Amount, operation.Description);
+        return "";
+    }
+
+    if (client == nullptr) {
+        return "Account " + operation.FromAccount + " not found. Please check the account number.";
+    }
+    client->AccountBalance += operation.Amount;
+    transaction = operation.Description.empty() ?
+        createDepositTransaction(operation.FromAccount, operation.Amount) :
+        createDepositTransaction(operation.FromAccount, operation.Amount, operation.Description);
+    return "";
+}
+// Balance changes of applied transactions, as journal legs
+vector<strJournalLeg> buildBatchJournalLegs(const vector<Transaction>& transactions) {
+    vector<strJournalLeg> legs;
+    legs.reserve(transactions.size() * 2);
+    for (const Transaction& transaction : transactions) {
+        switch (transaction.Type) {
+        case DEPOSIT:    legs.push_back({ transaction.FromAccount, transaction.Amount }); break;
+        case WITHDRAWAL: legs.push_back({ transaction.FromAccount, -transaction.Amount }); break;
+        case TRANSFER:
+            legs.push_back({ transaction.FromAccount, -(transaction.Amount + transaction.Fees) });
+            legs.push_back({ transaction.ToAccount, transaction.Amount });
+            break;
+        case REVERSAL:   break;   // Not a batch operation
+        }
+    }
+    return legs;
+}
+// Commit applied transactions: ledger first, then a single clients file write
+bool commitBatchTransactions(vector<strClient>& vClients, const vector<Transaction>& transactions) {
+    if (transactions.empty()) {
+        return true;
+    }
+
+    try {
+        saveTransactionsToFile(transactions);
+    }
+    catch (const exception& e) {
+        logMessage(string("Batch commit failed: ") + e.what(), CRITICAL);
+        return false;
+    }
+    // The whole batch shares one ledger sync, before any balance is persisted
+    commitDurableWrites();
+
+    // The ledger already holds the batch, so a failed clients write falls back to one journal record
+    if (!saveClientsToFileAtomic(ClientsFileName, vClients)) {
+        logMessage("Batch commit failed to save clients file, journaling balances: " + ClientsFileName, ERROR_LOG);
+        if (!appendBalanceJournal(ClientsFileName, transactions.front().TransactionID, buildBatchJournalLegs(transactions))) {
+            logMessage("Batch balances were not persisted: " + ClientsFileName, CRITICAL);
+            return false;
+        }
+        commitDurableWrites();
+    }
+
+    for (const Transaction& transaction : transactions) {
+        logTransaction(transaction);
+    }
+    return true;
+}
+// Apply a batch file to the clients and commit the applied lines once
+strBatchReport runBatchFile(const string& batchFileName, vector<strClient>& vClients) {
+    strBatchReport report;
+    string content;
+    if (!readFileToString(batchFileName, content)) {
+        report.Failures.push_back({ 0, "Cannot open batch file: " + batchFileName });
+        return report;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    vector<Transaction> transactions;
+    size_t lineNumber = 0;
+
+    forEachLine(content, [&](string_view line) {
+        lineNumber++;
+        line = trimView(line);
+        if (line.empty()) return;
+        report.Operations++;
+
+        strBatchOperation operation;
+        Transaction transaction;
+        string error;
+        if (parseBatchOperation(line, lineNumber, operation, error)) {
+            error = applyBatchOperation(operation, vClients, transaction);
+        }
+        if (!error.empty()) {
+            report.Failures.push_back({ lineNumber, error });
+            return;
+        }
+        transactions.push_back(move(transaction));
+    });
+
+    chrono::steady_clock::time_point applied = chrono::steady_clock::now();
+    report.ApplySeconds = chrono::duration<double>(applied - start).count();
+
+    report.Committed = commitBatchTransactions(vClients, transactions);
+    report.Applied = report.Committed ? transactions.size() : 0;
+    report.CommitSeconds = chrono::duration<double>(chrono::steady_clock::now() - applied).count();
+    return report;
+}
+// Print batch summary, throughput and per-line failures
+void showBatchReport(const string& batchFileName, const strBatchReport& report) {
+    double totalSeconds = report.ApplySeconds + report.CommitSeconds;
+
+    cout << "\nBatch File: " << batchFileName << "\n";
+    cout << "Operations: " << report.Operations << "\n";
+    cout << "Applied   : " << report.Applied << "\n";
+    cout << "Failed    : " << report.Failures.size() << "\n";
+    cout << "Apply Time: " << formatDouble(report.ApplySeconds * 1000, 2) << " ms\n";
+    cout << "Commit    : " << formatDouble(report.CommitSeconds * 1000, 2) << " ms\n";
+    if (totalSeconds > 0) {
+        cout << "Throughput: " << formatDouble(report.Operations / totalSeconds, 0) << " ops/s\n";
+    }
+
+    for (const pair<size_t, string>& failure : report.Failures) {
+        cout << RED << "  Line " << failure.first << ": " << failure.second << RESET << "\n";
+    }
+
+    if (!report.Committed) {
+        showErrorMessage("Batch was not committed. Check system log for details.");
+    }
+    else if (report.Failures.empty()) {
+        showSuccessMessage("Batch committed successfully!");
+    }
+    else {
+        showErrorMessage("Batch committed with " + formatInt(static_cast<int>(report.Failures.size())) + " failed lines.");
+    }
+}
+// Headless entry point: needs a saved session with transaction permission; returns process exit code
+int runBatchMode(const string& batchFileName) {
+    strUser sessionUser;
+    vector<strUser> vUsers = loadUsersDataFromFile(UsersFileName);
+    if (vUsers.empty() || !loadCurrentUserSession(sessionUser)) {
+        showErrorMessage("Batch mode needs an active session. Please login first.");
+        return 1;
+    }
+
+    CurrentUser = sessionUser;
+    if (!hasPermission(Permission::pTransactions)) {
+        showErrorMessage("Access Denied, \nYou dont Have Permission To Do this,\nPlease Conact Your Admin.");
+        logUserAction("BATCH_DENIED", "File: " + batchFileName);
+        return 1;
+    }
+
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    strBatchReport report = runBatchFile(batchFileName, vClients);
+
+    for (const pair<size_t, string>& failure : report.Failures) {
+        logUserAction("BATCH_LINE_FAILED", "Line " + to_string(failure.first) + ": " + failure.second);
+    }
+    logUserAction("BATCH", "File: " + batchFileName + " - Applied: " + to_string(report.Applied) +
+        " - Failed: " + to_string(report.Failures.size()));
+
+    showBatchReport(batchFileName, report);
+    logDurabilityCounters();
+    flushLogger();
+
+    if (!report.Committed) return 1;
+    return report.Failures.empty() ? 0 : 2;
+}
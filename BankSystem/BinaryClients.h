@@ -0,0 +1,652 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: BinaryClients.h                                  ||
+//  || Section: Binary Client File                            ||
+//  || Optional fixed-width clients file: slots updated in    ||
+//  || place, a free-list, and text format conversion.        ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Durability.h"
+#include "FileManager.h"
+#include "HashIndex.h"
+#include "ClientStore.h"
+#include "Journal.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//=====================================================
+//================ Binary Client File =================
+// With --storage binary the clients live in Clients.dat
+// instead of Clients.txt:
+// 1. A versioned header, then one BinaryClientSlotSize
+//    slot per client (sector aligned): the balance is an
+//    int64 of cents and every slot has its own CRC-32
+// 2. A deposit or withdrawal rewrites its one slot with a
+//    single positioned write; a save rewrites only the
+//    slots whose content changed
+// 3. Deleted slots are chained into a free-list (head in
+//    the header) and reused by the next added client
+// 4. Postings touching several slots (transfers) are
+//    journaled first; each slot keeps the last journal
+//    sequence it holds, so a replay after a crash applies
+//    only the legs that did not reach their slot
+// Loading maps the file read-only. --convert-clients
+// converts between this format and the "#//#" text.
+//=====================================================
+
+// Binary file name for a clients file: Clients.txt -> Clients.dat (a .dat name is kept)
+string getBinaryClientsFileName(const string& fileName) {
+    size_t extensionSize = BinaryClientsExtension.size();
+    if (fileName.size() >= extensionSize &&
+        fileName.compare(fileName.size() - extensionSize, extensionSize, BinaryClientsExtension) == 0) {
+        return fileName;
+    }
+    size_t dot = fileName.find_last_of('.');
+    size_t slash = fileName.find_last_of("/\\");
+    bool hasExtension = dot != string::npos && (slash == string::npos || dot > slash);
+    return (hasExtension ? fileName.substr(0, dot) : fileName) + BinaryClientsExtension;
+}
+// File that holds the clients in the current storage format
+string getClientsDataFileName(const string& fileName) {
+    return ClientFile.Format == CLIENTS_BINARY ? getBinaryClientsFileName(fileName) : fileName;
+}
+// Parse "text" or "binary", false if not recognized
+bool parseClientFileFormat(const string& text, ClientFileFormat& format) {
+    if (text == "text") {
+        format = CLIENTS_TEXT;
+        return true;
+    }
+    if (text == "binary") {
+        format = CLIENTS_BINARY;
+        return true;
+    }
+    return false;
+}
+// Copy text into a fixed-width NUL padded field, false if it does not fit
+bool copySlotField(char* field, size_t width, const string& text) {
+    if (text.size() > width) {
+        return false;
+    }
+    memset(field, 0, width);
+    memcpy(field, text.data(), text.size());
+    return true;
+}
+// Read a fixed-width NUL padded field
+string readSlotField(const char* field, size_t width) {
+    const char* end = static_cast<const char*>(memchr(field, '\0', width));
+    return string(field, end ? static_cast<size_t>(end - field) : width);
+}
+// CRC-32 of a header or slot with its Checksum field taken as 0
+template <typename Record>
+uint32_t computeRecordChecksum(Record record) {
+    record.Checksum = 0;
+    return computeCRC32(reinterpret_cast<const char*>(&record), sizeof(record));
+}
+// Hash of a slot's content (checksum left out), to skip rewriting unchanged clients
+size_t hashBinaryClientSlot(strBinaryClientSlot slot) {
+    slot.Checksum = 0;
+    return hash<string_view>()(string_view(reinterpret_cast<const char*>(&slot), sizeof(slot)));
+}
+// Fill a live slot from a client (checksum set when written); error names a field too long for its slot
+bool buildBinaryClientSlot(const strClient& client, uint64_t sequence, strBinaryClientSlot& slot, string& error) {
+    memset(&slot, 0, sizeof(slot));
+    slot.Balance = client.AccountBalance;
+    slot.Sequence = sequence;
+    slot.Live = 1;
+
+    const char* field = nullptr;
+    if (!copySlotField(slot.AccountNumber, sizeof(slot.AccountNumber), client.AccountNumber)) field = "account number";
+    else if (!copySlotField(slot.PinCode, sizeof(slot.PinCode), client.PinCode)) field = "pin code";
+    else if (!copySlotField(slot.Name, sizeof(slot.Name), client.Name)) field = "name";
+    else if (!copySlotField(slot.Phone, sizeof(slot.Phone), client.Phone)) field = "phone";
+    if (field != nullptr) {
+        error = "Client " + client.AccountNumber + ": " + field + " too long for a binary client slot";
+        return false;
+    }
+    return true;
+}
+// Free slot linked to the next free one (+1, 0 = end)
+strBinaryClientSlot buildFreeClientSlot(uint64_t nextFree) {
+    strBinaryClientSlot slot;
+    memset(&slot, 0, sizeof(slot));
+    slot.NextFree = nextFree;
+    return slot;
+}
+// Copy a live slot into a client
+strClient readBinaryClientSlot(const strBinaryClientSlot& slot) {
+    strClient client;
+    client.AccountNumber = readSlotField(slot.AccountNumber, sizeof(slot.AccountNumber));
+    client.PinCode = readSlotField(slot.PinCode, sizeof(slot.PinCode));
+    client.Name = readSlotField(slot.Name, sizeof(slot.Name));
+    client.Phone = readSlotField(slot.Phone, sizeof(slot.Phone));
+    client.AccountBalance = slot.Balance;
+    return client;
+}
+// Header for the current slot counts and free-list head
+strBinaryClientHeader buildBinaryClientHeader() {
+    strBinaryClientHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, BinaryClientsMagic, sizeof(header.Magic));
+    header.Version = BinaryClientsVersion;
+    header.SlotSize = BinaryClientSlotSize;
+    header.SlotCount = ClientFile.SlotCount;
+    header.LiveCount = ClientFile.LiveCount;
+    header.FreeHead = ClientFile.FreeSlots.empty() ? 0 : ClientFile.FreeSlots.back() + 1;
+    header.Checksum = computeRecordChecksum(header);
+    return header;
+}
+// File offset of a client slot (the header fills slot -1)
+long long getClientSlotOffset(uint64_t slot) {
+    return static_cast<long long>((slot + 1) * BinaryClientSlotSize);
+}
+// Close the positioned-write handle
+void closeBinaryClientFile() {
+    if (ClientFile.Fd >= 0) {
+#ifdef _WIN32
+        _close(ClientFile.Fd);
+#else
+        close(ClientFile.Fd);
+#endif
+    }
+    ClientFile.Fd = -1;
+}
+// Forget the slots of the loaded file
+void resetBinaryClientFile(const string& fileName) {
+    closeBinaryClientFile();
+    ClientFile.FileName = fileName;
+    ClientFile.Unusable = false;
+    ClientFile.SlotCount = 0;
+    ClientFile.LiveCount = 0;
+    ClientFile.FreeSlots.clear();
+    ClientFile.Slots.clear();
+}
+// Write bytes at a file offset with one positioned write, false on failure
+bool writeBinaryClientBytes(long long offset, const void* data, size_t size) {
+    if (ClientFile.Fd < 0) {
+#ifdef _WIN32
+        ClientFile.Fd = _open(ClientFile.FileName.c_str(), _O_RDWR | _O_BINARY);
+#else
+        ClientFile.Fd = open(ClientFile.FileName.c_str(), O_RDWR | O_CLOEXEC);
+#endif
+        if (ClientFile.Fd < 0) {
+            logMessage("Cannot open binary clients file for writing: " + ClientFile.FileName, ERROR_LOG);
+            return false;
+        }
+    }
+
+#ifdef _WIN32
+    bool written = _lseeki64(ClientFile.Fd, offset, SEEK_SET) == offset &&
+        _write(ClientFile.Fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+#else
+    bool written = pwrite(ClientFile.Fd, data, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+#endif
+    if (!written) {
+        logMessage("Binary clients write failed at offset " + to_string(offset) + ": " + ClientFile.FileName, ERROR_LOG);
+        return false;
+    }
+    ClientFile.SlotWrites++;
+    noteDurableWrite(ClientFile.FileName);
+    return true;
+}
+// Seal a slot with its checksum and write it in place
+bool writeBinaryClientSlot(uint64_t slot, strBinaryClientSlot record) {
+    record.Checksum = computeRecordChecksum(record);
+    return writeBinaryClientBytes(getClientSlotOffset(slot), &record, sizeof(record));
+}
+// Write the header in place
+bool writeBinaryClientHeader() {
+    strBinaryClientHeader header = buildBinaryClientHeader();
+    return writeBinaryClientBytes(0, &header, sizeof(header));
+}
+// Write a complete binary clients file (tmp, then rename) and adopt its slots; false on failure
+bool writeBinaryClientsFile(const string& fileName, const vector<strClient>& vClients, uint64_t sequence) {
+    string tempFile = fileName + ".tmp";
+    ofstream out(tempFile, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open temp file for writing: " + tempFile, ERROR_LOG);
+        return false;
+    }
+
+    resetBinaryClientFile(fileName);
+    strBinaryClientHeader header = buildBinaryClientHeader();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const strClient& client : vClients) {
+        if (client.MarkForDelete) continue;
+
+        strBinaryClientSlot slot;
+        string error;
+        if (!buildBinaryClientSlot(client, sequence, slot, error)) {
+            logMessage(error, ERROR_LOG);
+            out.close();
+            remove(tempFile.c_str());
+            resetBinaryClientFile(fileName);
+            return false;
+        }
+        ClientFile.Slots[client.AccountNumber] = { ClientFile.SlotCount, sequence, hashBinaryClientSlot(slot), 0 };
+        ClientFile.SlotCount++;
+        slot.Checksum = computeRecordChecksum(slot);
+        out.write(reinterpret_cast<const char*>(&slot), sizeof(slot));
+    }
+    ClientFile.LiveCount = ClientFile.SlotCount;
+
+    header = buildBinaryClientHeader();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        logMessage("Failed to write binary clients file: " + tempFile, ERROR_LOG);
+        remove(tempFile.c_str());
+        return false;
+    }
+    syncBeforeRename(tempFile);
+
+#ifdef _WIN32
+    remove(fileName.c_str());
+#endif
+
+    if (rename(tempFile.c_str(), fileName.c_str()) != 0) {
+        logMessage("Failed to rename temp file to actual file: " + fileName, ERROR_LOG);
+        return false;
+    }
+    syncAfterRename(fileName);
+    return true;
+}
+// Rewrite every free slot so the on-disk chain matches the free-list
+bool relinkBinaryFreeList() {
+    bool written = true;
+    for (size_t i = 0; i < ClientFile.FreeSlots.size(); i++) {
+        uint64_t nextFree = (i == 0) ? 0 : ClientFile.FreeSlots[i - 1] + 1;
+        written = writeBinaryClientSlot(ClientFile.FreeSlots[i], buildFreeClientSlot(nextFree)) && written;
+    }
+    return written;
+}
+// Replay journal records on top of binary slots; a leg is applied only if its slot does not hold it yet
+void replayBinaryJournal(const string& fileName, vector<strClient>& vClients, uint64_t lastSequence) {
+    JournalState = strJournalState();
+    JournalState.LastSequence = static_cast<long long>(lastSequence);
+    JournalState.CheckpointSequence = JournalState.LastSequence;
+
+    string journalFile = getJournalFileName(fileName);
+    if (!fileHasContent(journalFile)) {
+        return;
+    }
+
+    ifstream journal(journalFile);
+    string line;
+    long long sequence = 0;
+    string transactionID;
+    vector<strJournalLeg> legs;
+    int corruptRecords = 0;
+    int appliedLegs = 0;
+    while (getline(journal, line)) {
+        if (trimView(line).empty()) continue;
+
+        if (!deserializeJournalRecord(line, sequence, transactionID, legs)) {
+            corruptRecords++;
+            logMessage("Skipped corrupt journal record: " + line, WARNING);
+            continue;
+        }
+        JournalState.LastSequence = max(JournalState.LastSequence, sequence);
+        JournalState.PendingEntries++;
+
+        for (const strJournalLeg& leg : legs) {
+            auto slot = ClientFile.Slots.find(leg.AccountNumber);
+            strClient* client = findInHashIndex(ClientIndex, vClients, leg.AccountNumber);
+            if (client == nullptr || slot == ClientFile.Slots.end()) {
+                logMessage("Journal record " + transactionID + " references unknown account: " +
+                    leg.AccountNumber, WARNING);
+                continue;
+            }
+            if (static_cast<long long>(slot->second.Sequence) >= sequence) {
+                continue;
+            }
+            client->AccountBalance += leg.Delta;
+            appliedLegs++;
+        }
+    }
+
+    logMessage("Replayed " + formatInt(JournalState.PendingEntries) + " journal records on binary clients (" +
+        formatInt(appliedLegs) + " legs not yet in their slots, " + formatInt(corruptRecords) + " corrupt)", INFO);
+}
+// Load clients from a binary file; the free-list is checked against the slots and the journal replayed on top
+vector<strClient> loadClientsFromBinaryFile(const string& fileName) {
+    vector<strClient> vClients;
+    resetBinaryClientFile(fileName);
+
+    // Stamps taken before reading, after the watch is drained: a change during the load forces the next refresh
+    beginClientStoreSync(fileName);
+    strFileStamp clientsStamp = readFileStamp(fileName);
+    strFileStamp journalStamp = readFileStamp(getJournalFileName(fileName));
+
+    strMappedFile mapped;
+    if (!mapFileReadOnly(fileName, mapped, true)) {
+        logMessage("Clients file not found: " + fileName + " (will create new)", INFO);
+        replayBinaryJournal(fileName, vClients, 0);
+        markClientStoreSynced(fileName, vClients, clientsStamp, journalStamp);
+        return vClients;
+    }
+
+    strBinaryClientHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, mapped.Data, min(mapped.Size, sizeof(header)));
+    if (mapped.Size < sizeof(header) || memcmp(header.Magic, BinaryClientsMagic, sizeof(header.Magic)) != 0 ||
+        header.Version != BinaryClientsVersion || header.SlotSize != BinaryClientSlotSize) {
+        logMessage("Not a version " + to_string(BinaryClientsVersion) + " binary clients file: " + fileName, CRITICAL);
+        unmapFile(mapped);
+        // Writing slot 0 and a new header would destroy it; it stays read-only until converted or replaced
+        ClientFile.FileName.clear();
+        ClientFile.Unusable = true;
+        return vClients;
+    }
+    bool headerValid = computeRecordChecksum(header) == header.Checksum;
+
+    // A slot cut short by a crash while growing the file is ignored
+    size_t slotCount = mapped.Size / BinaryClientSlotSize - 1;
+    vector<char> kinds(slotCount, 0);                 // 0 = failed checksum, 1 = free, 2 = client
+    vector<uint64_t> links(slotCount, 0);             // NextFree of free slots, Sequence of clients
+    vector<size_t> hashes(slotCount, 0);
+    vClients.resize(slotCount);
+
+    // Slots are checked and decoded in parallel, one range per core
+    size_t rangeCount = max<size_t>(1, min<size_t>(max(1u, thread::hardware_concurrency()), slotCount / 65536));
+    runInParallel(rangeCount, [&](size_t range) {
+        for (size_t i = slotCount * range / rangeCount; i < slotCount * (range + 1) / rangeCount; i++) {
+            strBinaryClientSlot slot;
+            memcpy(&slot, mapped.Data + getClientSlotOffset(i), sizeof(slot));
+            if (computeRecordChecksum(slot) != slot.Checksum) continue;
+            if (slot.Live != 1) {
+                kinds[i] = 1;
+                links[i] = slot.NextFree;
+                continue;
+            }
+            kinds[i] = 2;
+            links[i] = slot.Sequence;
+            hashes[i] = hashBinaryClientSlot(slot);
+            vClients[i] = readBinaryClientSlot(slot);
+        }
+    });
+
+    unordered_map<uint64_t, uint64_t> nextFree;
+    vector<uint64_t> freeSlots;
+    uint64_t lastSequence = 0;
+    int corruptSlots = 0;
+    size_t liveCount = 0;
+    ClientFile.Slots.reserve(slotCount);
+    for (size_t i = 0; i < slotCount; i++) {
+        if (kinds[i] == 0) {
+            // Kept off the free-list, so the damaged slot is never overwritten
+            corruptSlots++;
+            logMessage("Binary client slot " + to_string(i) + " failed its checksum: " + fileName, CRITICAL);
+        }
+        else if (kinds[i] == 1) {
+            nextFree[i] = links[i];
+            freeSlots.push_back(i);
+        }
+        else {
+            ClientFile.Slots[vClients[i].AccountNumber] = { i, links[i], hashes[i], 0 };
+            lastSequence = max(lastSequence, links[i]);
+            if (i != liveCount) vClients[liveCount] = move(vClients[i]);
+            liveCount++;
+        }
+    }
+    vClients.resize(liveCount);
+    unmapFile(mapped);
+    ClientFile.SlotCount = slotCount;
+    ClientFile.LiveCount = vClients.size();
+
+    // Follow the on-disk chain; if a crash left it out of step with the slots, relink it
+    vector<uint64_t> chain;
+    uint64_t next = headerValid ? header.FreeHead : 0;
+    while (next != 0 && chain.size() < freeSlots.size() && nextFree.count(next - 1)) {
+        chain.push_back(next - 1);
+        next = nextFree[next - 1];
+        nextFree.erase(chain.back());
+    }
+    bool chainIntact = next == 0 && chain.size() == freeSlots.size();
+    if (chainIntact) {
+        ClientFile.FreeSlots.assign(chain.rbegin(), chain.rend());
+    }
+    else {
+        ClientFile.FreeSlots.assign(freeSlots.rbegin(), freeSlots.rend());
+        logMessage("Relinking binary clients free-list (" + to_string(freeSlots.size()) + " free slots): " + fileName, WARNING);
+        relinkBinaryFreeList();
+    }
+    if (!chainIntact || !headerValid || header.SlotCount != ClientFile.SlotCount || header.LiveCount != ClientFile.LiveCount) {
+        writeBinaryClientHeader();
+    }
+
+    logMessage("Loaded " + formatInt(vClients.size()) + " clients from binary file (" +
+        to_string(ClientFile.FreeSlots.size()) + " free slots, " + formatInt(corruptSlots) + " corrupt)", INFO);
+
+    replayBinaryJournal(fileName, vClients, lastSequence);
+    markClientStoreSynced(fileName, vClients, clientsStamp, journalStamp);
+    return vClients;
+}
+// Make sure fileName is the loaded binary file, creating an empty one if missing; false if unusable
+bool prepareBinaryClientFile(const string& fileName) {
+    if (ClientFile.Unusable) {
+        logMessage("Not writing " + fileName + ": it is not a version " + to_string(BinaryClientsVersion) +
+            " binary clients file (convert or replace it first)", ERROR_LOG);
+        return false;
+    }
+    if (getFileSize(fileName) < static_cast<long long>(BinaryClientSlotSize)) {
+        return writeBinaryClientsFile(fileName, {}, static_cast<uint64_t>(JournalState.LastSequence));
+    }
+    if (ClientFile.FileName != fileName) {
+        logMessage("Binary clients file was not loaded before writing: " + fileName, ERROR_LOG);
+        return false;
+    }
+    return true;
+}
+// Store a client in the free-list head slot, or a new slot at the end; false on failure
+bool storeNewBinaryClient(const strClient& client, uint64_t sequence) {
+    strBinaryClientSlot slot;
+    string error;
+    if (!buildBinaryClientSlot(client, sequence, slot, error)) {
+        logMessage(error, ERROR_LOG);
+        return false;
+    }
+
+    bool reused = !ClientFile.FreeSlots.empty();
+    uint64_t index = reused ? ClientFile.FreeSlots.back() : ClientFile.SlotCount;
+    if (!writeBinaryClientSlot(index, slot)) {
+        return false;
+    }
+    if (reused) ClientFile.FreeSlots.pop_back();
+    else ClientFile.SlotCount++;
+    ClientFile.LiveCount++;
+    ClientFile.Slots[client.AccountNumber] = { index, sequence, hashBinaryClientSlot(slot), ClientFile.SaveMarks };
+    return true;
+}
+// Put a client's slot at the head of the free-list
+bool freeBinaryClientSlot(unordered_map<string, strBinarySlotRef>::iterator slot) {
+    uint64_t index = slot->second.Slot;
+    uint64_t nextFree = ClientFile.FreeSlots.empty() ? 0 : ClientFile.FreeSlots.back() + 1;
+    if (!writeBinaryClientSlot(index, buildFreeClientSlot(nextFree))) {
+        return false;
+    }
+    ClientFile.FreeSlots.push_back(index);
+    ClientFile.LiveCount--;
+    ClientFile.Slots.erase(slot);
+    return true;
+}
+// Add one client to the binary file (used instead of appending a text line)
+bool appendBinaryClient(const string& fileName, const strClient& client) {
+    if (!prepareBinaryClientFile(fileName)) {
+        return false;
+    }
+    if (ClientFile.Slots.count(client.AccountNumber)) {
+        logMessage("Binary clients file already has account: " + client.AccountNumber, ERROR_LOG);
+        return false;
+    }
+    return storeNewBinaryClient(client, static_cast<uint64_t>(JournalState.LastSequence)) &&
+        writeBinaryClientHeader() && commitDurableWrites();
+}
+// Save clients in place: rewrite changed slots, free deleted ones, store new ones; false on failure
+bool saveClientsToBinaryFile(const string& fileName, const vector<strClient>& vClients) {
+    if (!prepareBinaryClientFile(fileName)) {
+        return false;
+    }
+
+    uint64_t mark = ++ClientFile.SaveMarks;
+    uint64_t sequence = static_cast<uint64_t>(JournalState.LastSequence);
+    bool saved = true;
+    bool hasDeleted = false;
+    long long writesBefore = ClientFile.SlotWrites;
+
+    for (const strClient& client : vClients) {
+        if (client.MarkForDelete) {
+            hasDeleted = true;
+            continue;
+        }
+
+        auto slot = ClientFile.Slots.find(client.AccountNumber);
+        if (slot == ClientFile.Slots.end()) {
+            saved = storeNewBinaryClient(client, sequence) && saved;
+            continue;
+        }
+        slot->second.SaveMark = mark;
+
+        strBinaryClientSlot record;
+        string error;
+        if (!buildBinaryClientSlot(client, slot->second.Sequence, record, error)) {
+            logMessage(error, ERROR_LOG);
+            saved = false;
+            continue;
+        }
+        if (hashBinaryClientSlot(record) == slot->second.ContentHash) {
+            continue;
+        }
+
+        // The balance in memory includes every journal record so far
+        buildBinaryClientSlot(client, sequence, record, error);
+        if (writeBinaryClientSlot(slot->second.Slot, record)) {
+            slot->second.Sequence = sequence;
+            slot->second.ContentHash = hashBinaryClientSlot(record);
+        }
+        else {
+            saved = false;
+        }
+    }
+
+    // Accounts no longer in the vector, or marked for delete, give their slots back
+    for (auto slot = ClientFile.Slots.begin(); slot != ClientFile.Slots.end(); ) {
+        if (slot->second.SaveMark == mark) {
+            ++slot;
+            continue;
+        }
+        auto next = std::next(slot);
+        saved = freeBinaryClientSlot(slot) && saved;
+        hasDeleted = true;
+        slot = next;
+    }
+    saved = writeBinaryClientHeader() && saved;
+
+    // Every slot now holds the journal's changes: once they are on disk the journal can go
+    saved = commitDurableWrites(true) && saved;
+    if (saved && fileHasContent(getJournalFileName(fileName))) {
+        truncateBalanceJournal(fileName);
+    }
+
+    // A reload would drop deleted clients, so only an unchanged vector is in sync
+    if (hasDeleted) {
+        invalidateClientStore();
+    }
+    else {
+        markClientStoreSynced(fileName, vClients);
+    }
+
+    logMessage("Clients saved in place (" + formatInt(vClients.size()) + " records, " +
+        to_string(ClientFile.SlotWrites - writesBefore) + " slot writes)", saved ? INFO : ERROR_LOG);
+    return saved;
+}
+// Persist a posting in place: one slot write per leg, journaled first when it has several legs
+void commitBinaryBalanceChange(vector<strClient>& vClients, const string& transactionID,
+    const vector<strJournalLeg>& legs) {
+    string fileName = getBinaryClientsFileName(ClientsFileName);
+    bool wasCurrent = isClientStoreCurrent(ClientsFileName, vClients);
+
+    // One slot write cannot be torn by a crash into a half posting; several can, so the journal covers them
+    bool written = prepareBinaryClientFile(fileName) &&
+        (legs.size() < 2 || appendBalanceJournal(fileName, transactionID, legs));
+    uint64_t sequence = static_cast<uint64_t>(JournalState.LastSequence);
+
+    for (size_t i = 0; i < legs.size() && written; i++) {
+        strClient* client = findInHashIndex(ClientIndex, vClients, legs[i].AccountNumber);
+        auto slot = ClientFile.Slots.find(legs[i].AccountNumber);
+        strBinaryClientSlot record;
+        string error;
+        written = client != nullptr && slot != ClientFile.Slots.end() &&
+            buildBinaryClientSlot(*client, sequence, record, error) && writeBinaryClientSlot(slot->second.Slot, record);
+        if (written) {
+            slot->second.Sequence = sequence;
+            slot->second.ContentHash = hashBinaryClientSlot(record);
+        }
+    }
+
+    // The posting's ledger line and slot writes reach the disk together (per Durability.Mode)
+    commitDurableWrites();
+    if (!written) {
+        logMessage("In-place balance write failed for " + transactionID + ", saving clients", ERROR_LOG);
+        saveClientsToFile(ClientsFileName, vClients);
+        return;
+    }
+    if (wasCurrent) {
+        markClientStoreSynced(ClientsFileName, vClients);
+    }
+
+    if (JournalState.PendingEntries >= JournalCheckpointInterval) {
+        logMessage("Journal truncated after " + formatInt(JournalState.PendingEntries) + " records", INFO);
+        commitDurableWrites(true);
+        truncateBalanceJournal(fileName);
+    }
+}
+// Convert the clients file between text and binary (--convert-clients to-binary|to-text); returns the exit code
+int convertClientsFile(const string& direction) {
+    ClientFileFormat target;
+    if (direction == "to-binary") target = CLIENTS_BINARY;
+    else if (direction == "to-text") target = CLIENTS_TEXT;
+    else {
+        showErrorMessage("Unknown conversion: " + direction + " (use to-binary or to-text)");
+        return 1;
+    }
+
+    ClientFile.Format = (target == CLIENTS_BINARY) ? CLIENTS_TEXT : CLIENTS_BINARY;
+    string source = getClientsDataFileName(ClientsFileName);
+    if (getFileSize(source) <= 0) {
+        showErrorMessage("Nothing to convert: " + source + " is missing or empty");
+        return 1;
+    }
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+
+    ClientFile.Format = target;
+    string destination = getClientsDataFileName(ClientsFileName);
+
+    // The destination's journal and checkpoint describe the file being replaced
+    remove(getJournalFileName(destination).c_str());
+    remove(getCheckpointFileName(destination).c_str());
+    JournalState = strJournalState();
+
+    bool converted = (target == CLIENTS_BINARY) ? writeBinaryClientsFile(destination, vClients, 0) :
+        saveClientsToFileAtomic(destination, vClients);
+    if (!converted) {
+        showErrorMessage("Conversion failed, see " + LogFileName + " for details.");
+        return 1;
+    }
+
+    logMessage("Converted " + formatInt(vClients.size()) + " clients: " + source + " -> " + destination, INFO);
+    showSuccessMessage("Converted " + formatInt(vClients.size()) + " clients: " + source + " -> " + destination);
+    return 0;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: ClientColumns.h                                  ||
+//  || Section: Client Columns                                ||
+//  || Structure-of-arrays view of the clients, with balance  ||
+//  || aggregation kernels for the reports.                   ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "AccountDictionary.h"
+
+//=====================================================
+//================== Client Columns ===================
+// strClient carries four strings and a transactions
+// vector, so a loop that only needs the balance still
+// pulls whole records through the cache. The columns
+// keep each field contiguous:
+// 1. Balances: one Money per client, in vector order
+// 2. AccountIds: the client's id in the account
+//    dictionary, 4 bytes instead of a string
+// 3. Names interned in a string arena: one id per
+//    client, distinct names stored once
+// The kernels keep BalanceKernelLanes independent
+// accumulators over the balance column; the compiler
+// turns the lane loops into SSE2 / AVX2 instructions
+// (no intrinsics, so every platform builds the same
+// code). Balances are cents, far from overflow, so a
+// comparison can be the sign bit of a subtraction.
+// The columns are a snapshot: rebuild after edits.
+//=====================================================
+
+// Build the columns from a client set
+void buildClientColumns(const vector<strClient>& vClients, strClientColumns& columns) {
+    columns = strClientColumns();
+    columns.Balances.reserve(vClients.size());
+    columns.AccountIds.reserve(vClients.size());
+    columns.NameIds.reserve(vClients.size());
+
+    for (const strClient& client : vClients) {
+        columns.Balances.push_back(client.AccountBalance);
+        columns.AccountIds.push_back(internAccountId(client.AccountNumber));
+        columns.NameIds.push_back(internArenaString(columns.Names, client.Name));
+    }
+    flushAccountDictionary();
+}
+// Number of clients in the columns
+size_t getColumnCount(const strClientColumns& columns) {
+    return columns.Balances.size();
+}
+// Account number of the client at position
+string_view getColumnAccount(const strClientColumns& columns, size_t position) {
+    return getAccountNumberById(columns.AccountIds[position]);
+}
+// Name of the client at position
+string_view getColumnName(const strClientColumns& columns, size_t position) {
+    return getArenaString(columns.Names, columns.NameIds[position]);
+}
+// Sum of balances
+Money sumBalanceColumn(const Money* balances, size_t count) {
+    Money lanes[BalanceKernelLanes] = {};
+    size_t i = 0;
+    for (; i + BalanceKernelLanes <= count; i += BalanceKernelLanes) {
+        for (size_t lane = 0; lane < BalanceKernelLanes; lane++) {
+            lanes[lane] += balances[i + lane];
+        }
+    }
+
+    Money total = 0;
+    for (; i < count; i++) total += balances[i];
+    for (Money lane : lanes) total += lane;
+    return total;
+}
+// Smallest balance (0 if empty)
+Money minBalanceColumn(const Money* balances, size_t count) {
+    if (count == 0) return 0;
+    Money lanes[BalanceKernelLanes];
+    fill(begin(lanes), end(lanes), balances[0]);
+    size_t i = 0;
+    for (; i + BalanceKernelLanes <= count; i += BalanceKernelLanes) {
+        for (size_t lane = 0; lane < BalanceKernelLanes; lane++) {
+            lanes[lane] = balances[i + lane] < lanes[lane] ? balances[i + lane] : lanes[lane];
+        }
+    }
+
+    Money minimum = lanes[0];
+    for (; i < count; i++) minimum = min(minimum, balances[i]);
+    for (Money lane : lanes) minimum = min(minimum, lane);
+    return minimum;
+}
+// Largest balance (0 if empty)
+Money maxBalanceColumn(const Money* balances, size_t count) {
+    if (count == 0) return 0;
+    Money lanes[BalanceKernelLanes];
+    fill(begin(lanes), end(lanes), balances[0]);
+    size_t i = 0;
+    for (; i + BalanceKernelLanes <= count; i += BalanceKernelLanes) {
+        for (size_t lane = 0; lane < BalanceKernelLanes; lane++) {
+            lanes[lane] = balances[i + lane] > lanes[lane] ? balances[i + lane] : lanes[lane];
+        }
+    }
+
+    Money maximum = lanes[0];
+    for (; i < count; i++) maximum = max(maximum, balances[i]);
+    for (Money lane : lanes) maximum = max(maximum, lane);
+    return maximum;
+}
+// 1 if balance < threshold, else 0 (sign bit of the difference; needs no 64-bit vector compare)
+inline uint64_t isBalanceBelow(Money balance, Money threshold) {
+    return static_cast<uint64_t>(balance - threshold) >> 63;
+}
+// Number of balances below a threshold
+size_t countBalancesBelow(const Money* balances, size_t count, Money threshold) {
+    uint64_t lanes[BalanceKernelLanes] = {};
+    size_t i = 0;
+    for (; i + BalanceKernelLanes <= count; i += BalanceKernelLanes) {
+        for (size_t lane = 0; lane < BalanceKernelLanes; lane++) {
+            lanes[lane] += isBalanceBelow(balances[i + lane], threshold);
+        }
+    }
+
+    size_t below = 0;
+    for (; i < count; i++) below += isBalanceBelow(balances[i], threshold);
+    for (uint64_t lane : lanes) below += static_cast<size_t>(lane);
+    return below;
+}
+// Clients per BalanceBucketBounds range, from one pass counting balances below each bound
+void countBalanceBuckets(const Money* balances, size_t count, size_t buckets[BalanceBucketCount]) {
+    const size_t boundCount = BalanceBucketCount - 1;
+    uint64_t lanes[boundCount][BalanceKernelLanes] = {};
+    size_t i = 0;
+    for (; i + BalanceKernelLanes <= count; i += BalanceKernelLanes) {
+        for (size_t bound = 0; bound < boundCount; bound++) {
+            for (size_t lane = 0; lane < BalanceKernelLanes; lane++) {
+                lanes[bound][lane] += isBalanceBelow(balances[i + lane], BalanceBucketBounds[bound]);
+            }
+        }
+    }
+
+    size_t below[boundCount] = {};
+    for (size_t bound = 0; bound < boundCount; bound++) {
+        for (size_t tail = i; tail < count; tail++) below[bound] += isBalanceBelow(balances[tail], BalanceBucketBounds[bound]);
+        for (uint64_t lane : lanes[bound]) below[bound] += static_cast<size_t>(lane);
+    }
+
+    buckets[0] = below[0];
+    for (size_t bound = 1; bound < boundCount; bound++) {
+        buckets[bound] = below[bound] - below[bound - 1];
+    }
+    buckets[boundCount] = count - below[boundCount - 1];
+}
+// Total, extremes, negatives and buckets of a balance column
+strBalanceSummary summarizeBalanceColumn(const vector<Money>& balances) {
+    strBalanceSummary summary;
+    summary.Count = balances.size();
+    summary.Total = sumBalanceColumn(balances.data(), balances.size());
+    summary.Minimum = minBalanceColumn(balances.data(), balances.size());
+    summary.Maximum = maxBalanceColumn(balances.data(), balances.size());
+    summary.Negative = countBalancesBelow(balances.data(), balances.size(), 0);
+    countBalanceBuckets(balances.data(), balances.size(), summary.Buckets);
+    return summary;
+}
+// Label of a balance bucket, e.g. "$100.00 - $1000.00"
+string getBalanceBucketLabel(size_t bucket) {
+    if (bucket == 0) {
+        return "below " + formatCurrency(BalanceBucketBounds[0]);
+    }
+    if (bucket == BalanceBucketCount - 1) {
+        return formatCurrency(BalanceBucketBounds[bucket - 1]) + " and above";
+    }
+    return formatCurrency(BalanceBucketBounds[bucket - 1]) + " - " + formatCurrency(BalanceBucketBounds[bucket]);
+}
@@ -10,21 +10,21 @@
 
 #include "Globals.h"
 #include "Utilities.h"
+#include "ScreenRenderer.h"
 #include "InputManager.h"
 #include "FileManager.h"
+#include "ClientStore.h"
+#include "RecentTransactions.h"
+#include "HashIndex.h"
 #include "Logger.h"
 
 //=====================================================
 //==================== Client Manager =================
 //=====================================================
 
-// Search for a client by account number, return pointer to client if found
+// Search for a client by account number (hash index), return pointer to client if found
 strClient* findClientByAccountNumber(const string& accountNumber, vector<strClient>& vClients) {
-    for (auto& c : vClients) {
-        if (c.AccountNumber == accountNumber)
-            return &c;
-    }
-    return nullptr;
+    return findInHashIndex(ClientIndex, vClients, accountNumber);
 }
 // Mark client for deletion using pointer
 bool markClientForDelete(strClient* client) {
@@ -47,41 +47,48 @@ void showClientCard(const strClient& client) {
     cout << "|  Phone          : " << left << setw(39) << client.Phone << "|\n";
     cout << "|  Balance        : " << left << setw(39) << formatCurrency(client.AccountBalance) << "|\n";
 
+    size_t total = 0;
+    vector<Transaction> recent = getRecentTransactions(client.AccountNumber, total);
+    if (!recent.empty()) {
+        cout << "+" << string(58, '-') << "+\n";
+        cout << "|  " << left << setw(56) << ("Recent Activity (" + to_string(total) + " total)") << "|\n";
+        size_t shown = min(recent.size(), RecentCardRows);
+        for (size_t i = recent.size(); i > recent.size() - shown; i--) {
+            const Transaction& txn = recent[i - 1];
+            const char* type = getTransactionTypeName(txn.Type);
+            cout << "|  " << left << setw(18) << txn.Timestamp.substr(0, 16) << setw(10) << type
+                << right << setw(16) << formatCurrency(txn.Amount) << string(12, ' ') << "|\n";
+        }
+    }
+
     showBorderLine(58, '=');
 }
 // Display all clients in table format
 void showAllClientsReport(const vector<strClient>& vClients) {
-    clearScreen();
-    showScreenHeader("Clients List");
-
-    cout << "Total Clients: " << vClients.size() << "\n\n";
+    beginScreen("Clients List");
+    string& out = ScreenBuffer.Text;
+    out += "Total Clients: " + to_string(vClients.size()) + "\n\n";
 
     if (vClients.size() == 0) {
+        writeScreenBuffer();
         showErrorMessage("No clients available in the system!");
         backToMenu();
         return;
     }
 
-    showBorderLine(105, '-', CYAN);
-    cout << CYAN << "| " << left << setw(18) << "Account Number"
-        << "| " << setw(12) << "PIN Code"
-        << "| " << setw(30) << "Client Name"
-        << "| " << setw(15) << "Phone"
-        << "| " << setw(21) << "Balance" << "|\n";
-    showBorderLine(105, '-', CYAN);
-
-    for (const strClient& Client : vClients) {
-        string balanceColor = (Client.AccountBalance >= 0) ? GREEN : RED;
-        cout << CYAN << "| " << RESET << left << setw(18) << Client.AccountNumber
-            << CYAN << "| " << RESET << setw(12) << Client.PinCode
-            << CYAN << "| " << RESET << setw(30) << Client.Name
-            << CYAN << "| " << RESET << setw(15) << Client.Phone
-            << CYAN << "| " << RESET << balanceColor << setw(21)
-            << fixed << setprecision(2) << formatCurrency(Client.AccountBalance)
-            << CYAN << "|\n" << RESET;
-    }
-
-    showBorderLine(105, '-', CYAN);
+    vector<strTableColumn> columns = {
+        { "Account Number", 18 }, { "PIN Code", 12 }, { "Client Name", 30 }, { "Phone", 15 }, { "Balance", 21 } };
+    showPagedTable(columns, vClients.size(), [&](string& row, size_t i) {
+        const strClient& client = vClients[i];
+        appendTextCell(row, client.AccountNumber, 18);
+        appendTextCell(row, client.PinCode, 12);
+        appendTextCell(row, client.Name, 30);
+        appendTextCell(row, client.Phone, 15);
+        appendMoneyCell(row, client.AccountBalance, 21, client.AccountBalance >= 0 ? GREEN : RED);
+        appendRowEnd(row);
+    });
+
+    writeScreenBuffer();
     backToMenu();
 }
 // Add client with unique account number
@@ -98,7 +105,7 @@ void addNewClient(vector<strClient>& vClients) {
 
     newClient = readClientData(accountNumber);
     vClients.push_back(newClient);
-    appendLineToFile(ClientsFileName, serializeClientRecord(newClient));
+    appendClientToFile(ClientsFileName, newClient);
     showSuccessMessage("Client Added Successfully!");
 
     logUserAction("ADD_CLIENT", "Account: " + newClient.AccountNumber + " - Name: " + newClient.Name);
@@ -123,8 +130,12 @@ void showAddClientScreen(vector<strClient>& vClients) {
         }
 
         strClient newClient = readClientData(accountNumber);
+        bool wasCurrent = isClientStoreCurrent(ClientsFileName, vClients);
         vClients.push_back(newClient);
-        appendLineToFile(ClientsFileName, serializeClientRecord(newClient));
+        appendClientToFile(ClientsFileName, newClient);
+        if (wasCurrent) {
+            markClientStoreSynced(ClientsFileName, vClients);
+        }
         showSuccessMessage("Client Added Successfully!");
         pressEnterToContinue();
     }
@@ -142,7 +153,7 @@ bool deleteClient(const string& accountNumber, vector<strClient>& vClients) {
     if (confirmAction("Are you sure you want delete this client ?")) {
         markClientForDelete(client);
         saveClientsToFile(ClientsFileName, vClients);
-        vClients = loadClientsDataFromFile(ClientsFileName);
+        refreshClientsFromFile(ClientsFileName, vClients);
         showSuccessMessage("Client Deleted Successfully.");
         logUserAction("DELETE_CLIENT", "Account: " + accountNumber);
         return true;
@@ -176,7 +187,7 @@ bool updateClient(const string& accountNumber, vector<strClient>& vClients) {
     if (confirmAction("Are you sure you want update this client ?")) {
         *client = readClientData(accountNumber);
         saveClientsToFile(ClientsFileName, vClients);
-        vClients = loadClientsDataFromFile(ClientsFileName);
+        refreshClientsFromFile(ClientsFileName, vClients);
         showSuccessMessage("Client Updated Successfully.");
         logUserAction("UPDATE_CLIENT", "Account: " + accountNumber);
         return true;
@@ -0,0 +1,173 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: ClientStore.h                                    ||
+//  || Section: Client Store Cache                            ||
+//  || Tracks whether the in-memory clients still match the   ||
+//  || files on disk, so menus reload only after a change.    ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "FileManager.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+//=====================================================
+//================ Client Store Cache =================
+// A loaded or saved vector is "in sync" with the clients
+// file and its journal, remembered like the hash index
+// remembers its vector (data() + size):
+// 1. Loads, full saves, journal appends and added clients
+//    record the stamps (size, mtime, inode) they left
+// 2. refreshClientsFromFile() reloads only if the vector
+//    or a stamp differs; atomic saves replace the file,
+//    so the inode acts as a generation counter
+// 3. On Linux an inotify watch on the data folder lets
+//    the check skip stat() while no event names the files
+// 4. The watch is started and drained before a load takes
+//    its stamps, so a write made during the load leaves
+//    an event and the next check compares the stamps
+//=====================================================
+
+// Forget the synced vector so the next refresh reloads
+void invalidateClientStore() {
+    ClientStore.Owner = nullptr;
+    ClientStore.Count = 0;
+}
+// File name without its folder
+string getBaseFileName(const string& fileName) {
+    size_t slash = fileName.find_last_of("/\\");
+    return slash == string::npos ? fileName : fileName.substr(slash + 1);
+}
+// Stop watching the data folder
+void stopClientStoreWatch() {
+#ifdef __linux__
+    if (ClientStore.WatchFd >= 0) {
+        close(ClientStore.WatchFd);
+    }
+#endif
+    ClientStore.WatchFd = -1;
+}
+// Watch the folder of the clients file for changes (Linux only, falls back to stat)
+void startClientStoreWatch(const string& fileName) {
+    stopClientStoreWatch();
+#ifdef __linux__
+    if (!ClientStoreUseInotify) {
+        return;
+    }
+
+    size_t slash = fileName.find_last_of('/');
+    string folder = slash == string::npos ? "." : fileName.substr(0, max<size_t>(slash, 1));
+
+    int watchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watchFd < 0) {
+        return;
+    }
+    uint32_t events = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB;
+    if (inotify_add_watch(watchFd, folder.c_str(), events) < 0) {
+        close(watchFd);
+        logMessage("Client store watch unavailable, using stat checks: " + folder, WARNING);
+        return;
+    }
+    ClientStore.WatchFd = watchFd;
+#endif
+}
+// Read pending watch events; note any that name the clients file or its journal
+void drainClientStoreWatch() {
+#ifdef __linux__
+    if (ClientStore.WatchFd < 0) {
+        return;
+    }
+
+    string clientsName = getBaseFileName(ClientStore.FileName);
+    string journalName = getBaseFileName(getJournalFileName(ClientStore.FileName));
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    ssize_t length;
+    while ((length = read(ClientStore.WatchFd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t position = 0; position < length; ) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + position);
+            if ((event->mask & IN_Q_OVERFLOW) ||
+                (event->len > 0 && (clientsName == event->name || journalName == event->name))) {
+                ClientStore.Changed = true;
+            }
+            position += sizeof(inotify_event) + event->len;
+        }
+    }
+#endif
+}
+// Watch the clients file and consume the events queued so far; call before taking the stamps a sync records
+void beginClientStoreSync(const string& fileName) {
+    string dataFileName = getClientsDataFileName(fileName);
+    if (ClientStore.FileName != dataFileName) {
+        ClientStore.FileName = dataFileName;
+        startClientStoreWatch(dataFileName);
+    }
+    drainClientStoreWatch();
+    ClientStore.Changed = false;
+}
+// Record that vClients matches the clients file and journal with the given stamps
+void markClientStoreSynced(const string& fileName, const vector<strClient>& vClients,
+    const strFileStamp& clientsStamp, const strFileStamp& journalStamp) {
+    string dataFileName = getClientsDataFileName(fileName);
+    if (ClientStore.FileName != dataFileName) {
+        // Not begun: the watch starts after the stamps were taken, so the next check compares them once
+        beginClientStoreSync(dataFileName);
+        ClientStore.Changed = true;
+    }
+
+    // Events since beginClientStoreSync() are kept: they may be writes the stamps predate
+    ClientStore.Owner = vClients.data();
+    ClientStore.Count = vClients.size();
+    ClientStore.ClientsStamp = clientsStamp;
+    ClientStore.JournalStamp = journalStamp;
+}
+// Record that vClients matches the clients file and journal as they are now
+void markClientStoreSynced(const string& fileName, const vector<strClient>& vClients) {
+    string dataFileName = getClientsDataFileName(fileName);
+    beginClientStoreSync(dataFileName);
+    markClientStoreSynced(dataFileName, vClients, readFileStamp(dataFileName), readFileStamp(getJournalFileName(dataFileName)));
+}
+// Check whether vClients still matches the files on disk
+bool isClientStoreCurrent(const string& fileName, const vector<strClient>& vClients) {
+    string dataFileName = getClientsDataFileName(fileName);
+    if (ClientStore.Owner == nullptr || ClientStore.FileName != dataFileName ||
+        ClientStore.Owner != vClients.data() || ClientStore.Count != vClients.size()) {
+        return false;
+    }
+
+    drainClientStoreWatch();
+    if (ClientStore.WatchFd >= 0 && !ClientStore.Changed) {
+        return true;
+    }
+
+    ClientStore.StatChecks++;
+    if (!sameFileStamp(ClientStore.ClientsStamp, readFileStamp(dataFileName)) ||
+        !sameFileStamp(ClientStore.JournalStamp, readFileStamp(getJournalFileName(dataFileName)))) {
+        return false;
+    }
+    ClientStore.Changed = false;
+    return true;
+}
+// Reload clients only if the file or journal changed since vClients was loaded or saved
+void refreshClientsFromFile(const string& fileName, vector<strClient>& vClients) {
+    if (isClientStoreCurrent(fileName, vClients)) {
+        ClientStore.ReloadsAvoided++;
+        return;
+    }
+    ClientStore.Reloads++;
+    loadClientsDataFromFile(fileName, vClients);
+}
+// Log how many reloads the cache saved
+void logClientStoreCounters() {
+    logMessage("Client store: " + to_string(ClientStore.Reloads) + " reloads, " +
+        to_string(ClientStore.ReloadsAvoided) + " avoided, " +
+        to_string(ClientStore.StatChecks) + " stat checks", INFO);
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: ConcurrentLedger.h                               ||
+//  || Section: Concurrent Ledger                             ||
+//  || Thread-safe deposit / withdraw / transfer over an      ||
+//  || owned client set, with striped per-account locks.      ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "HashIndex.h"
+#include "FileManager.h"
+#include "TransactionManager.h"
+
+//=====================================================
+//================= Concurrent Ledger =================
+// The ledger owns its clients; callers pass account
+// numbers, never strClient pointers:
+// 1. The hash index is built once when the ledger is
+//    opened, so lookups from many threads only read it
+// 2. Each client is guarded by one lock stripe; a
+//    transfer takes both stripes in ascending order, so
+//    two transfers can never wait on each other in a cycle
+// 3. Posting functions do not log and do not touch
+//    CurrentUser; they return "" or an error message
+// Accounts cannot be added or removed while posting.
+//=====================================================
+
+// Take ownership of a client set and build its index and lock stripes
+void openConcurrentLedger(strConcurrentLedger& ledger, vector<strClient> vClients,
+    size_t stripeCount = ConcurrentLedgerStripes) {
+    ledger.Clients = move(vClients);
+    rebuildHashIndex(ledger.Index, ledger.Clients);
+    ledger.Stripes = vector<strAccountLock>(max<size_t>(1, min(stripeCount, ledger.Clients.size())));
+}
+// Find client by account number (read-only lookup, safe from any thread)
+strClient* findConcurrentClient(strConcurrentLedger& ledger, const string& accountNumber) {
+    return findInHashIndex(ledger.Index, ledger.Clients, accountNumber);
+}
+// Stripe index guarding a client of the ledger
+size_t getAccountStripe(const strConcurrentLedger& ledger, const strClient* client) {
+    return static_cast<size_t>(client - ledger.Clients.data()) % ledger.Stripes.size();
+}
+// Deposit amount to an account
+string concurrentDeposit(strConcurrentLedger& ledger, const string& accountNumber, Money amount) {
+    if (amount <= 0) {
+        return "Invalid amount! Please enter a positive value.";
+    }
+
+    strClient* client = findConcurrentClient(ledger, accountNumber);
+    if (client == nullptr) {
+        return "Account " + accountNumber + " not found. Please check the account number.";
+    }
+
+    lock_guard<mutex> guard(ledger.Stripes[getAccountStripe(ledger, client)].Lock);
+    client->AccountBalance += amount;
+    return "";
+}
+// Withdraw amount from an account, checked against the balance under the lock
+string concurrentWithdraw(strConcurrentLedger& ledger, const string& accountNumber, Money amount) {
+    strClient* client = findConcurrentClient(ledger, accountNumber);
+    if (client == nullptr) {
+        return "Account " + accountNumber + " not found. Please check the account number.";
+    }
+
+    lock_guard<mutex> guard(ledger.Stripes[getAccountStripe(ledger, client)].Lock);
+    string error = checkWithdrawAmount(client, amount);
+    if (error.empty()) {
+        client->AccountBalance -= amount;
+    }
+    return error;
+}
+// Transfer amount plus fee between two accounts, locking both stripes in ascending order
+string concurrentTransfer(strConcurrentLedger& ledger, const string& fromAccount, const string& toAccount,
+    Money amount) {
+    if (amount <= 0) {
+        return "Invalid amount! Please enter a positive value.";
+    }
+
+    strClient* fromClient = findConcurrentClient(ledger, fromAccount);
+    if (fromClient == nullptr) {
+        return "Your account not found!";
+    }
+    strClient* toClient = findConcurrentClient(ledger, toAccount);
+    if (toClient == nullptr) {
+        return "Recipient account not found!";
+    }
+    if (fromClient == toClient) {
+        return "Cannot transfer to the same account!";
+    }
+
+    size_t firstStripe = getAccountStripe(ledger, fromClient);
+    size_t secondStripe = getAccountStripe(ledger, toClient);
+    if (firstStripe > secondStripe) {
+        swap(firstStripe, secondStripe);
+    }
+
+    unique_lock<mutex> firstGuard(ledger.Stripes[firstStripe].Lock);
+    unique_lock<mutex> secondGuard;
+    if (secondStripe != firstStripe) {
+        secondGuard = unique_lock<mutex>(ledger.Stripes[secondStripe].Lock);
+    }
+
+    Money fee = calculateTransferFee(amount);
+    string error = checkTransferAmount(amount, fee, fromClient);
+    if (error.empty()) {
+        executeTransfer(fromClient, toClient, amount, fee);
+    }
+    return error;
+}
+// Consistent copy of all clients (takes every stripe in ascending order)
+vector<strClient> snapshotConcurrentLedger(strConcurrentLedger& ledger) {
+    vector<unique_lock<mutex>> guards;
+    guards.reserve(ledger.Stripes.size());
+    for (strAccountLock& stripe : ledger.Stripes) {
+        guards.emplace_back(stripe.Lock);
+    }
+    return ledger.Clients;
+}
+// Save a consistent snapshot of the ledger's clients
+void saveConcurrentLedger(strConcurrentLedger& ledger, const string& fileName) {
+    saveClientsToFile(fileName, snapshotConcurrentLedger(ledger));
+}
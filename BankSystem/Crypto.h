@@ -65,11 +65,47 @@ vector<unsigned char> getEncryptionKey() {
 
     return key;
 }
+// Wipe and free the cached key (registered with atexit)
+void releaseCachedEncryptionKey() {
+    if (SessionCache.Key != nullptr) {
+        sodium_free(SessionCache.Key);
+        SessionCache.Key = nullptr;
+    }
+}
+// Encryption key kept in locked, read-only sodium memory; loaded from disk once
+const unsigned char* getCachedEncryptionKey() {
+    if (SessionCache.Key != nullptr) {
+        return SessionCache.Key;
+    }
+
+    unsigned char* lockedKey = static_cast<unsigned char*>(sodium_malloc(crypto_secretbox_KEYBYTES));
+    if (lockedKey == nullptr) {
+        throw runtime_error("Cannot allocate secure memory for encryption key");
+    }
+
+    vector<unsigned char> key = getEncryptionKey();
+    memcpy(lockedKey, key.data(), crypto_secretbox_KEYBYTES);
+    sodium_memzero(key.data(), key.size());
+    sodium_mprotect_readonly(lockedKey);
+
+    static bool releaseRegistered = false;
+    if (!releaseRegistered) {
+        atexit(releaseCachedEncryptionKey);
+        releaseRegistered = true;
+    }
+
+    SessionCache.Key = lockedKey;
+    return SessionCache.Key;
+}
 // Encrypt plaintext using libsodium secretbox
 string encryptData(const string& plaintext, const vector<unsigned char>& key) {
     if (key.size() != crypto_secretbox_KEYBYTES) {
         throw runtime_error("Invalid key size for encryption");
     }
+    return encryptData(plaintext, key.data());
+}
+// Encrypt plaintext using libsodium secretbox (key of crypto_secretbox_KEYBYTES)
+string encryptData(const string& plaintext, const unsigned char* key) {
     if (plaintext.empty()) {
         throw runtime_error("Cannot encrypt empty data");
     }
@@ -84,7 +120,7 @@ string encryptData(const string& plaintext, const vector<unsigned char>& key) {
             reinterpret_cast<const unsigned char*>(plaintext.c_str()),
             plaintext.size(),
             nonce.data(),
-            key.data()) != 0) {
+            key) != 0) {
             throw runtime_error("Encryption operation failed");
         }
 
@@ -103,6 +139,10 @@ string decryptData(const string& encryptedData, const vector<unsigned char>& key
     if (key.size() != crypto_secretbox_KEYBYTES) {
         throw runtime_error("Invalid key size");
     }
+    return decryptData(encryptedData, key.data());
+}
+// Decrypt ciphertext using libsodium secretbox (key of crypto_secretbox_KEYBYTES)
+string decryptData(const string& encryptedData, const unsigned char* key) {
     if (encryptedData.size() < crypto_secretbox_NONCEBYTES + crypto_secretbox_MACBYTES) {
         throw runtime_error("Encrypted data too short");
     }
@@ -119,7 +159,7 @@ string decryptData(const string& encryptedData, const vector<unsigned char>& key
         ciphertext.data(),
         ciphertext.size(),
         nonce.data(),
-        key.data()) != 0) {
+        key) != 0) {
         throw runtime_error("Decryption failed - tampered or corrupted data");
     }
 
@@ -0,0 +1,225 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: Durability.h                                     ||
+//  || Section: Durability                                    ||
+//  || When ledger, journal and data file writes reach the    ||
+//  || disk: never forced, per commit, or group commit.       ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//=====================================================
+//==================== Durability =====================
+// Appends call noteDurableWrite(file); a posting calls
+// commitDurableWrites() once its ledger and journal lines
+// are written, and returns only when they are on disk:
+// 1. none : nothing is synced (previous behavior)
+// 2. fsync: every commit syncs the files it wrote
+// 3. group: commits arriving while a sync runs are all
+//    covered by the next one; a leader that is not alone
+//    also waits WindowMicros for stragglers, so one
+//    fdatasync per dirty file covers many commits
+// A single thread can also defer its commits with
+// begin/endDurableGroup() (the server loop), so
+// back-to-back postings share one sync; other threads
+// keep committing as usual. A commit fails if any sync
+// round that covered its writes failed. Atomic file
+// replacements sync the temp file before the rename and
+// the folder after it.
+//=====================================================
+
+// Display name of a durability mode
+string getDurabilityModeName(DurabilityMode mode) {
+    switch (mode) {
+    case DURABILITY_NONE:  return "none";
+    case DURABILITY_FSYNC: return "fsync";
+    default:               return "group";
+    }
+}
+// Parse "none", "fsync", "group" or "group:<window micros>", false if not recognized
+bool parseDurabilityMode(const string& text, DurabilityMode& mode, long long& windowMicros) {
+    if (text == "none") {
+        mode = DURABILITY_NONE;
+        return true;
+    }
+    if (text == "fsync") {
+        mode = DURABILITY_FSYNC;
+        return true;
+    }
+    if (text.compare(0, 5, "group") != 0) {
+        return false;
+    }
+
+    mode = DURABILITY_GROUP;
+    if (text.size() == 5) {
+        return true;
+    }
+    const char* first = text.data() + 6;
+    const char* last = text.data() + text.size();
+    return text[5] == ':' && from_chars(first, last, windowMicros).ptr == last && windowMicros >= 0;
+}
+// Set the durability mode for this process
+void setDurabilityMode(DurabilityMode mode, long long windowMicros = GroupCommitWindowMicros) {
+    lock_guard<mutex> guard(Durability.Lock);
+    Durability.Mode = mode;
+    Durability.WindowMicros = windowMicros;
+}
+// Flush a file's data to disk (metadata too unless dataOnly), false on failure
+bool syncFileToDisk(const string& fileName, bool dataOnly) {
+#ifdef _WIN32
+    (void)dataOnly;
+    int fd = _open(fileName.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool synced = _commit(fd) == 0;
+    _close(fd);
+    return synced;
+#else
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+#if defined(__linux__)
+    bool synced = (dataOnly ? fdatasync(fd) : fsync(fd)) == 0;
+#else
+    (void)dataOnly;
+    bool synced = fsync(fd) == 0;
+#endif
+    close(fd);
+    return synced;
+#endif
+}
+// Folder holding a file ("." for a bare name)
+string getFolderName(const string& fileName) {
+    size_t slash = fileName.find_last_of("/\\");
+    return slash == string::npos ? "." : fileName.substr(0, max<size_t>(slash, 1));
+}
+// Flush the folder entry of a file (after a create or rename); no-op on Windows
+bool syncFolderToDisk(const string& fileName) {
+#ifdef _WIN32
+    (void)fileName;
+    return true;
+#else
+    int fd = open(getFolderName(fileName).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    close(fd);
+    return synced;
+#endif
+}
+// Add a file to the dirty list once
+void addDirtyFile(const string& fileName) {
+    if (find(Durability.DirtyFiles.begin(), Durability.DirtyFiles.end(), fileName) == Durability.DirtyFiles.end()) {
+        Durability.DirtyFiles.push_back(fileName);
+    }
+}
+// Remember that a file was appended to (and maybe created) and must be synced by the next commit
+void noteDurableWrite(const string& fileName, bool created = false) {
+    lock_guard<mutex> guard(Durability.Lock);
+    if (Durability.Mode == DURABILITY_NONE) {
+        return;
+    }
+    addDirtyFile(fileName);
+#ifndef _WIN32
+    // A new file also needs its folder entry on disk (a folder syncs like a file on POSIX)
+    if (created) {
+        addDirtyFile(getFolderName(fileName));
+    }
+#endif
+    Durability.WriteTicket++;
+}
+// Return once every write noted so far is on disk (leader/follower group commit); false if a sync failed.
+// Inside a begin/endDurableGroup() scope it returns at once, unless evenInGroup.
+bool commitDurableWrites(bool evenInGroup = false) {
+    unique_lock<mutex> lock(Durability.Lock);
+    if (Durability.Mode == DURABILITY_NONE || (Durability.GroupDepth > 0 && !evenInGroup)) {
+        return true;
+    }
+
+    long long target = Durability.WriteTicket;
+    Durability.Commits++;
+    Durability.Committers++;
+
+    while (Durability.SyncedTicket < target) {
+        if (Durability.SyncRunning) {
+            Durability.Synced.wait(lock);
+            continue;
+        }
+
+        // This commit leads the next sync round; alone, it does not wait for anyone
+        Durability.SyncRunning = true;
+        if (Durability.Mode == DURABILITY_GROUP && Durability.WindowMicros > 0 && Durability.Committers > 1) {
+            long long window = Durability.WindowMicros;
+            lock.unlock();
+            this_thread::sleep_for(chrono::microseconds(window));
+            lock.lock();
+        }
+
+        vector<string> files;
+        files.swap(Durability.DirtyFiles);
+        long long covered = Durability.WriteTicket;
+        lock.unlock();
+
+        bool roundSynced = true;
+        for (const string& file : files) {
+            if (!syncFileToDisk(file, true)) {
+                logMessage("Failed to sync to disk: " + file, CRITICAL);
+                roundSynced = false;
+            }
+        }
+
+        lock.lock();
+        // Followers covered by this round see the failure too; their writes were in the files that failed
+        if (!roundSynced) {
+            Durability.FailedTicket = max(Durability.FailedTicket, covered);
+        }
+        Durability.SyncedTicket = max(Durability.SyncedTicket, covered);
+        Durability.SyncRunning = false;
+        Durability.Syncs++;
+        Durability.Synced.notify_all();
+    }
+    Durability.Committers--;
+    return Durability.FailedTicket < target;
+}
+// Defer this thread's commits until the matching endDurableGroup()
+void beginDurableGroup() {
+    Durability.GroupDepth++;
+}
+// Close a deferred group; the outermost one commits everything written inside it
+bool endDurableGroup() {
+    if (--Durability.GroupDepth > 0) {
+        return true;
+    }
+    return commitDurableWrites();
+}
+// Before renaming a temp file over a data file: make its content, and every noted write, durable
+void syncBeforeRename(const string& tempFile) {
+    if (Durability.Mode == DURABILITY_NONE) {
+        return;
+    }
+    commitDurableWrites(true);
+    if (!syncFileToDisk(tempFile, false)) {
+        logMessage("Failed to sync to disk: " + tempFile, CRITICAL);
+    }
+}
+// After renaming: make the new directory entry durable
+void syncAfterRename(const string& fileName) {
+    if (Durability.Mode != DURABILITY_NONE && !syncFolderToDisk(fileName)) {
+        logMessage("Failed to sync folder of: " + fileName, WARNING);
+    }
+}
+// Log mode, commits and sync rounds
+void logDurabilityCounters() {
+    lock_guard<mutex> guard(Durability.Lock);
+    logMessage("Durability " + getDurabilityModeName(Durability.Mode) + ": " + to_string(Durability.Commits) +
+        " commits, " + to_string(Durability.Syncs) + " sync rounds", INFO);
+}
@@ -11,26 +11,133 @@
 #include "Globals.h"
 #include "Utilities.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Durability.h"
+#include "HashIndex.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Forward declare journal functions (defined in Journal.h)
+string getJournalFileName(const string& clientsFileName);
+bool fileHasContent(const string& fileName);
+bool writeJournalCheckpoint(const string& clientsFileName, const string& tempFile);
+void truncateBalanceJournal(const string& clientsFileName);
+void replayBalanceJournal(const string& clientsFileName, vector<strClient>& vClients);
+
+// Forward declare client store sync (defined in ClientStore.h)
+void invalidateClientStore();
+void beginClientStoreSync(const string& fileName);
+void markClientStoreSynced(const string& fileName, const vector<strClient>& vClients,
+    const strFileStamp& clientsStamp, const strFileStamp& journalStamp);
+void markClientStoreSynced(const string& fileName, const vector<strClient>& vClients);
+
+// Forward declare binary client storage (defined in BinaryClients.h)
+string getBinaryClientsFileName(const string& fileName);
+string getClientsDataFileName(const string& fileName);
+vector<strClient> loadClientsFromBinaryFile(const string& fileName);
+bool saveClientsToBinaryFile(const string& fileName, const vector<strClient>& vClients);
+bool appendBinaryClient(const string& fileName, const strClient& client);
+void commitBinaryBalanceChange(vector<strClient>& vClients, const string& transactionID,
+    const vector<strJournalLeg>& legs);
+
+// Forward declare account ids (defined in AccountDictionary.h)
+void registerClientAccounts(const vector<strClient>& vClients);
+
+// Forward declare transaction index file name (defined in TransactionIndex.h)
+string getTransactionIndexFileName(const string& ledgerFileName);
+
+// Forward declare recent transactions cache (defined in RecentTransactions.h)
+void clearRecentTransactions();
+void noteRecentTransaction(const Transaction& transaction);
+
+// Forward declare ledger appends (defined in Ledger.h)
+void appendLedgerRecord(const string& ledgerFileName, const Transaction& transaction, const string& line,
+    long long& offset, long long& nextOffset);
+void appendLedgerRecords(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<string>& lines, vector<long long>& offsets);
+
+// Forward declare index appends (defined in TransactionIndex.h)
+void appendToTransactionIndex(const string& ledgerFileName, long long offset, long long nextOffset,
+    const Transaction& transaction);
+void appendRecordsToTransactionIndex(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<long long>& offsets);
+
+// Forward declare transaction ID table appends (defined in TransactionIdIndex.h)
+void appendTransactionIds(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<long long>& offsets);
 
 //=====================================================
 //==================== File Manager ===================
 //=====================================================
 
+// Find delimiter in text from position, memchr jumps between candidate first chars
+size_t findDelimiter(string_view text, string_view delim, size_t from) {
+    if (delim.empty() || text.size() < delim.size()) return string_view::npos;
+
+    const char* data = text.data();
+    const char* last = data + text.size() - delim.size();
+    const char* p = data + from;
+
+    while (p <= last) {
+        p = static_cast<const char*>(memchr(p, delim[0], last - p + 1));
+        if (p == nullptr) return string_view::npos;
+        if (memcmp(p, delim.data(), delim.size()) == 0) return p - data;
+        p++;
+    }
+    return string_view::npos;
+}
+// Call fieldHandler(field) for every field view of a line (empty fields skipped)
+template <typename FieldHandler>
+void forEachFieldView(string_view line, string_view delim, FieldHandler fieldHandler) {
+    size_t start = 0;
+    size_t pos;
+
+    while ((pos = findDelimiter(line, delim, start)) != string_view::npos) {
+        if (pos > start) {
+            fieldHandler(line.substr(start, pos - start));
+        }
+        start = pos + delim.size();
+    }
+    if (start < line.size()) {
+        fieldHandler(line.substr(start));
+    }
+}
+// Split line into field views (empty fields skipped), store up to maxFields, return total count
+size_t splitFieldViews(string_view line, string_view delim, string_view* fields, size_t maxFields) {
+    size_t count = 0;
+    forEachFieldView(line, delim, [&](string_view field) {
+        if (count < maxFields) fields[count] = field;
+        count++;
+    });
+    return count;
+}
+// Parse integer from trimmed view (accepts leading '+', like stoi)
+errc parseIntField(string_view field, int& value) {
+    field = trimView(field);
+    if (!field.empty() && field[0] == '+') field.remove_prefix(1);
+    from_chars_result result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec;
+}
 // Split string into tokens using delimiter
-vector<string> splitStringByDelimiter(string S1, string delim = Separator) {
+vector<string> splitStringByDelimiter(const string& S1, const string& delim = Separator) {
     vector<string> split;
-    size_t pos = 0;
-    string sWord;
+    string_view line(S1);
+    size_t start = 0;
+    size_t pos;
 
-    while ((pos = S1.find(delim)) != string::npos) {
-        sWord = S1.substr(0, pos);
-        if (sWord != "") {
-            split.push_back(sWord);
+    while ((pos = findDelimiter(line, delim, start)) != string_view::npos) {
+        if (pos > start) {
+            split.emplace_back(line.substr(start, pos - start));
         }
-        S1.erase(0, pos + delim.length());
+        start = pos + delim.length();
     }
-    if (S1 != "") {
-        split.push_back(S1);
+    if (start < line.size()) {
+        split.emplace_back(line.substr(start));
     }
     return split;
 }
@@ -41,40 +148,62 @@ string serializeClientRecord(const strClient& clientData, const string& seperato
     Line += clientData.PinCode + seperator;
     Line += clientData.Name + seperator;
     Line += clientData.Phone + seperator;
-    Line += formatDouble(clientData.AccountBalance);
+    Line += formatMoney(clientData.AccountBalance);
     return Line;
 }
-// Convert file line to Client struct
-strClient deserializeClientRecord(const string& Line, const string& seperator = Separator) {
-    strClient Client;
-    vector<string> vClientData = splitStringByDelimiter(Line, seperator);
-
-    if (vClientData.size() < 5) {
-        logMessage("Invalid client record: expected 5 fields, got " +
-            formatInt(vClientData.size()), ERROR_LOG);
+// Empty a client record for reuse, keeping its string buffers
+void clearClientRecord(strClient& Client) {
+    Client.AccountNumber.clear();
+    Client.PinCode.clear();
+    Client.Name.clear();
+    Client.Phone.clear();
+    Client.AccountBalance = 0;
+    Client.MarkForDelete = false;
+}
+// Parse file line into Client struct without logging, error explains a failure.
+// Client may hold an earlier record (reloads parse over the previous load); nothing of it survives a failure
+bool parseClientRecord(string_view Line, strClient& Client, string& error, string_view seperator = Separator) {
+    string_view vClientData[5];
+    size_t fieldCount = splitFieldViews(Line, seperator, vClientData, 5);
+
+    if (fieldCount < 5) {
+        error = "Invalid client record: expected 5 fields, got " + formatInt(fieldCount);
+        clearClientRecord(Client);
         Client.MarkForDelete = true;
-        return Client;
+        return false;
     }
 
-    try {
-        Client.AccountNumber = trim(vClientData[0]);
-        Client.PinCode = trim(vClientData[1]);
-        Client.Name = trim(vClientData[2]);
-        Client.Phone = trim(vClientData[3]);
-        Client.AccountBalance = stod(vClientData[4]);
-        Client.MarkForDelete = false;
-        return Client;
-    }
-    catch (const invalid_argument& e) {
-        logMessage("Invalid number format in balance field: " + vClientData[4], ERROR_LOG);
+    Client.AccountNumber = trimView(vClientData[0]);
+    Client.PinCode = trimView(vClientData[1]);
+    Client.Name = trimView(vClientData[2]);
+    Client.Phone = trimView(vClientData[3]);
+
+    errc status = parseMoneyField(vClientData[4], Client.AccountBalance);
+    if (status != errc()) {
+        Client.AccountBalance = 0;
+    }
+    if (status == errc::invalid_argument) {
+        error = "Invalid number format in balance field: " + string(vClientData[4]);
         Client.MarkForDelete = true;
-        return Client;
+        return false;
     }
-    catch (const out_of_range& e) {
-        logMessage("Balance value out of range: " + vClientData[4], ERROR_LOG);
+    if (status == errc::result_out_of_range) {
+        error = "Balance value out of range: " + string(vClientData[4]);
         Client.MarkForDelete = true;
-        return Client;
+        return false;
+    }
+
+    Client.MarkForDelete = false;
+    return true;
+}
+// Convert file line to Client struct
+strClient deserializeClientRecord(string_view Line, string_view seperator = Separator) {
+    strClient Client;
+    string error;
+    if (!parseClientRecord(Line, Client, error, seperator)) {
+        logMessage(error, ERROR_LOG);
     }
+    return Client;
 }
 // Convert User struct to file line
 string serializeUserRecord(const strUser& userInfo, const string& separator = Separator) {
@@ -85,65 +214,79 @@ string serializeUserRecord(const strUser& userInfo, const string& separator = Se
     return line;
 }
 // Convert file line to User struct
-strUser deserializeUserRecord(string Line, const string& seperator = Separator) {
+strUser deserializeUserRecord(string_view Line, string_view seperator = Separator) {
     strUser userInfo;
-    vector<string> vUsersData = splitStringByDelimiter(Line, seperator);
+    string_view vUsersData[3];
+    size_t fieldCount = splitFieldViews(Line, seperator, vUsersData, 3);
 
-    if (vUsersData.size() < 3) {
+    if (fieldCount < 3) {
         logMessage("Invalid user record: expected 3 fields, got " +
-            formatInt(vUsersData.size()), ERROR_LOG);
+            formatInt(fieldCount), ERROR_LOG);
         userInfo.MarkForDelete = true;
         return userInfo;
     }
 
-    try {
-        userInfo.UserName = trim(vUsersData[0]);
-        userInfo.Password = trim(vUsersData[1]);
-        userInfo.Permissions = stoi(vUsersData[2]);
-        userInfo.MarkForDelete = false;
-        return userInfo;
-    }
-    catch (const invalid_argument& e) {
-        logMessage("Invalid permissions format: " + vUsersData[2], ERROR_LOG);
+    userInfo.UserName = trimView(vUsersData[0]);
+    userInfo.Password = trimView(vUsersData[1]);
+
+    errc status = parseIntField(vUsersData[2], userInfo.Permissions);
+    if (status == errc::invalid_argument) {
+        logMessage("Invalid permissions format: " + string(vUsersData[2]), ERROR_LOG);
         userInfo.MarkForDelete = true;
         return userInfo;
     }
-    catch (const out_of_range& e) {
-        logMessage("Permissions value out of range: " + vUsersData[2], ERROR_LOG);
+    if (status == errc::result_out_of_range) {
+        logMessage("Permissions value out of range: " + string(vUsersData[2]), ERROR_LOG);
         userInfo.MarkForDelete = true;
         return userInfo;
     }
-}
-// Convert file line to Transaction struct
-Transaction deserializeTransactionRecord(const string& line, const string& separator = Separator) {
-    Transaction txn;
-    vector<string> vTxnData = splitStringByDelimiter(line, separator);
 
-    if (vTxnData.size() < 8) {
-        logMessage("Invalid transaction record: expected 8 fields, got " +
-            formatInt(vTxnData.size()), ERROR_LOG);
-        return txn;
+    userInfo.MarkForDelete = false;
+    return userInfo;
+}
+// Parse file line into Transaction struct without logging, error explains a failure
+bool parseTransactionRecord(string_view line, Transaction& txn, string& error, string_view separator = Separator) {
+    string_view vTxnData[8];
+    size_t fieldCount = splitFieldViews(line, separator, vTxnData, 8);
+
+    if (fieldCount < 8) {
+        error = "Invalid transaction record: expected 8 fields, got " + formatInt(fieldCount);
+        txn = Transaction();
+        return false;
     }
 
-    try {
-        txn.TransactionID = trim(vTxnData[0]);
-        txn.Type = static_cast<TransactionType>(stoi(vTxnData[1]));
-        txn.FromAccount = trim(vTxnData[2]);
-        txn.ToAccount = trim(vTxnData[3]);
-        txn.Amount = stod(vTxnData[4]);
-        txn.Fees = stod(vTxnData[5]);
-        txn.Timestamp = trim(vTxnData[6]);
-        txn.Description = trim(vTxnData[7]);
-        return txn;
+    int type = 0;
+    errc status = parseIntField(vTxnData[1], type);
+    if (status == errc()) status = parseMoneyField(vTxnData[4], txn.Amount);
+    if (status == errc()) status = parseMoneyField(vTxnData[5], txn.Fees);
+
+    if (status == errc::invalid_argument) {
+        error = "Invalid transaction data format: " + string(line);
+        txn = Transaction();
+        return false;
     }
-    catch (const invalid_argument& e) {
-        logMessage("Invalid transaction data format: " + string(e.what()), ERROR_LOG);
-        return txn;
+    if (status == errc::result_out_of_range) {
+        error = "Transaction value out of range: " + string(line);
+        txn = Transaction();
+        return false;
     }
-    catch (const out_of_range& e) {
-        logMessage("Transaction value out of range: " + string(e.what()), ERROR_LOG);
-        return txn;
+
+    txn.TransactionID = trimView(vTxnData[0]);
+    txn.Type = static_cast<TransactionType>(type);
+    txn.FromAccount = trimView(vTxnData[2]);
+    txn.ToAccount = trimView(vTxnData[3]);
+    txn.Timestamp = trimView(vTxnData[6]);
+    txn.Description = trimView(vTxnData[7]);
+    return true;
+}
+// Convert file line to Transaction struct
+Transaction deserializeTransactionRecord(string_view line, string_view separator = Separator) {
+    Transaction txn;
+    string error;
+    if (!parseTransactionRecord(line, txn, error, separator)) {
+        logMessage(error, ERROR_LOG);
     }
+    return txn;
 }
 
 //=====================================================
@@ -156,6 +299,10 @@ Transaction deserializeTransactionRecord(const string& line, const string& separ
 
 // Atomic save for Clients (prevents data loss)
 bool saveClientsToFileAtomic(const string& fileName, const vector<strClient>& vClients) {
+    strMetricTimer timer(METRIC_SAVE_CLIENTS);
+    if (ClientFile.Format == CLIENTS_BINARY) {
+        return saveClientsToBinaryFile(getBinaryClientsFileName(fileName), vClients);
+    }
     string tempFile = fileName + ".tmp";
     string backupFile = fileName + ".bak";
 
@@ -166,13 +313,24 @@ bool saveClientsToFileAtomic(const string& fileName, const vector<strClient>& vC
             return false;
         }
 
+        bool hasDeleted = false;
         for (const strClient& c : vClients) {
             if (!c.MarkForDelete) {
                 string dataLine = serializeClientRecord(c, Separator);
                 tempFileStream << dataLine << endl;
             }
+            else {
+                hasDeleted = true;
+            }
         }
         tempFileStream.close();
+        syncBeforeRename(tempFile);
+
+        bool hasJournal = fileHasContent(getJournalFileName(fileName));
+        if (hasJournal && !writeJournalCheckpoint(fileName, tempFile)) {
+            remove(tempFile.c_str());
+            return false;
+        }
 
         ifstream originalFile(fileName);
         if (originalFile.good()) {
@@ -195,6 +353,19 @@ bool saveClientsToFileAtomic(const string& fileName, const vector<strClient>& vC
             logMessage("Failed to rename temp file to actual file", ERROR_LOG);
             return false;
         }
+        syncAfterRename(fileName);
+
+        if (hasJournal) {
+            truncateBalanceJournal(fileName);
+        }
+
+        // A reload would drop deleted clients, so only an unchanged vector is in sync
+        if (hasDeleted) {
+            invalidateClientStore();
+        }
+        else {
+            markClientStoreSynced(fileName, vClients);
+        }
 
         logMessage("Clients saved successfully (" + formatInt(vClients.size()) + " records)", INFO);
         return true;
@@ -224,6 +395,7 @@ bool saveUsersToFileAtomic(const string& fileName, const vector<strUser>& vUsers
             }
         }
         tempFileStream.close();
+        syncBeforeRename(tempFile);
 
         ifstream originalFile(fileName);
         if (originalFile.good()) {
@@ -246,6 +418,7 @@ bool saveUsersToFileAtomic(const string& fileName, const vector<strUser>& vUsers
             logMessage("Failed to rename temp file to actual file", ERROR_LOG);
             return false;
         }
+        syncAfterRename(fileName);
 
         logMessage("Users saved successfully (" + formatInt(vUsers.size()) + " records)", INFO);
         return true;
@@ -256,6 +429,11 @@ bool saveUsersToFileAtomic(const string& fileName, const vector<strUser>& vUsers
         return false;
     }
 }
+// Get size of a file in bytes (-1 if missing)
+long long getFileSize(const string& fileName) {
+    ifstream file(fileName, ios::binary | ios::ate);
+    return file.is_open() ? static_cast<long long>(file.tellg()) : -1;
+}
 // Validate file exists and is readable
 bool validateFileBeforeLoad(const string& fileName, const string& fileType) {
     ifstream file(fileName);
@@ -284,50 +462,264 @@ bool validateFileBeforeLoad(const string& fileName, const string& fileType) {
     file.close();
     return true;
 }
-// Load all clients from file, return vector of clients
-vector<strClient> loadClientsDataFromFile(const string& fileName) {
-    vector<strClient> vClients;
-
-    if (!validateFileBeforeLoad(fileName, "Clients")) {
-        return vClients;
-    }
+//=====================================================
+//============== Parallel Chunked Loading =============
+// Data files are read in one block, split at newline
+// boundaries into one chunk per core, and the chunks
+// are parsed in parallel into a pre-sized vector.
+// Diagnostics are collected per chunk and logged in
+// file order once all chunks are done.
+//=====================================================
 
-    fstream myFile;
-    myFile.open(fileName, ios::in);
+const size_t MinBytesPerLoadChunk = 1024 * 1024;
 
-    if (myFile.is_open()) {
-        string Line;
-        strClient Client;
-        int lineNumber = 0;
-        int validRecords = 0;
-        int skippedRecords = 0;
+// Read whole file into memory with a single read
+bool readFileToString(const string& fileName, string& content) {
+    ifstream file(fileName, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
 
-        while (getline(myFile, Line)) {
-            lineNumber++;
-            if (trim(Line).empty()) continue;
+    streamsize fileSize = file.tellg();
+    file.seekg(0, ios::beg);
+    content.resize(static_cast<size_t>(fileSize));
+    file.read(&content[0], fileSize);
+    return file.gcount() == fileSize;
+}
+// Map a whole file read-only, false if missing, empty or not mappable.
+// The file may grow while mapped (appends are not visible), but must not shrink.
+bool mapFileReadOnly(const string& fileName, strMappedFile& mapped, bool sequential = false) {
+    mapped = strMappedFile();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    mapped.Data = static_cast<const char*>(data);
+    mapped.Size = static_cast<size_t>(size.QuadPart);
+    mapped.FileHandle = file;
+    mapped.MappingHandle = mapping;
+    return true;
+#else
+    int fd = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (sequential) {
+        madvise(data, size, MADV_SEQUENTIAL);
+    }
+    mapped.Data = static_cast<const char*>(data);
+    mapped.Size = size;
+    return true;
+#endif
+}
+// Release a mapping made by mapFileReadOnly (no-op if not mapped)
+void unmapFile(strMappedFile& mapped) {
+    if (mapped.Data != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapped.Data);
+        CloseHandle(mapped.MappingHandle);
+        CloseHandle(mapped.FileHandle);
+#else
+        munmap(const_cast<char*>(mapped.Data), mapped.Size);
+#endif
+    }
+    mapped = strMappedFile();
+}
+// Call lineHandler for every line of text (trailing '\r' stripped)
+template <typename LineHandler>
+void forEachLine(string_view text, LineHandler lineHandler) {
+    size_t start = 0;
+    while (start < text.size()) {
+        const void* newline = memchr(text.data() + start, '\n', text.size() - start);
+        size_t end = newline ? static_cast<const char*>(newline) - text.data() : text.size();
+
+        string_view line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        lineHandler(line);
+        start = end + 1;
+    }
+}
+// Count lines the same way forEachLine enumerates them
+size_t countLines(string_view text) {
+    size_t count = 0;
+    const char* p = text.data();
+    const char* end = text.data() + text.size();
+    while (p < end && (p = static_cast<const char*>(memchr(p, '\n', end - p))) != nullptr) {
+        count++;
+        p++;
+    }
+    if (!text.empty() && text.back() != '\n') count++;
+    return count;
+}
+// Split content into per-core chunks ending on newline boundaries, with line offsets
+vector<strLoadChunk> splitIntoLoadChunks(string_view content) {
+    size_t cores = max(1u, thread::hardware_concurrency());
+    size_t chunkCount = max<size_t>(1, min(cores, content.size() / MinBytesPerLoadChunk));
+    size_t targetSize = content.size() / chunkCount;
+
+    vector<strLoadChunk> chunks;
+    size_t begin = 0;
+    while (begin < content.size()) {
+        strLoadChunk chunk;
+        chunk.Begin = begin;
+        chunk.End = content.size();
+        if (chunks.size() + 1 < chunkCount) {
+            size_t newline = content.find('\n', begin + targetSize);
+            if (newline != string_view::npos) chunk.End = newline + 1;
+        }
+        chunks.push_back(chunk);
+        begin = chunk.End;
+    }
+    return chunks;
+}
+// Run task(i) for i in [0, count): extra threads for i > 0, index 0 on the caller
+template <typename Task>
+void runInParallel(size_t count, Task task) {
+    vector<thread> workers;
+    for (size_t i = 1; i < count; i++) {
+        workers.emplace_back(task, i);
+    }
+    if (count > 0) {
+        task(0);
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+// Count lines of every chunk in parallel and assign each chunk its first line index
+size_t assignChunkLines(string_view content, vector<strLoadChunk>& chunks) {
+    runInParallel(chunks.size(), [&](size_t c) {
+        chunks[c].LineCount = countLines(content.substr(chunks[c].Begin, chunks[c].End - chunks[c].Begin));
+    });
+
+    size_t totalLines = 0;
+    for (strLoadChunk& chunk : chunks) {
+        chunk.FirstLine = totalLines;
+        totalLines += chunk.LineCount;
+    }
+    return totalLines;
+}
+// Log collected chunk diagnostics in file order
+void logChunkMessages(const vector<strLoadChunk>& chunks) {
+    for (const strLoadChunk& chunk : chunks) {
+        for (const pair<LogLevel, string>& message : chunk.Messages) {
+            logMessage(message.second, message.first);
+        }
+    }
+}
+// Load all clients from file into vClients. Its records are parsed over, not rebuilt:
+// a reload reuses the string buffers of the previous load instead of freeing and allocating them again
+void loadClientsDataFromFile(const string& fileName, vector<strClient>& vClients) {
+    strMetricTimer timer(METRIC_LOAD_CLIENTS);
+    invalidateHashIndex(ClientIndex);
+    invalidateClientStore();
+    // Files changed since the last load may come with postings of another process the rings lack
+    clearRecentTransactions();
+    if (ClientFile.Format == CLIENTS_BINARY) {
+        vClients = loadClientsFromBinaryFile(getBinaryClientsFileName(fileName));
+        registerClientAccounts(vClients);
+        return;
+    }
+
+    // Stamps taken before reading, after the watch is drained: a change during the load forces the next refresh
+    beginClientStoreSync(fileName);
+    strFileStamp clientsStamp = readFileStamp(fileName);
+    strFileStamp journalStamp = readFileStamp(getJournalFileName(fileName));
+
+    string content;
+    if (!validateFileBeforeLoad(fileName, "Clients") || !readFileToString(fileName, content)) {
+        vClients.clear();
+        return;
+    }
+
+    string_view contentView(content);
+    vector<strLoadChunk> chunks = splitIntoLoadChunks(contentView);
+    size_t totalLines = assignChunkLines(contentView, chunks);
+
+    vClients.resize(totalLines);
+    vector<char> accepted(totalLines, 0);
+
+    runInParallel(chunks.size(), [&](size_t c) {
+        strLoadChunk& chunk = chunks[c];
+        size_t lineIndex = chunk.FirstLine;
+
+        forEachLine(contentView.substr(chunk.Begin, chunk.End - chunk.Begin), [&](string_view Line) {
+            size_t lineNumber = ++lineIndex;
+            if (trimView(Line).empty()) return;
 
             try {
-                Client = deserializeClientRecord(Line, Separator);
+                strClient& Client = vClients[lineNumber - 1];
+                string error;
+                if (!parseClientRecord(Line, Client, error)) {
+                    chunk.Messages.push_back({ ERROR_LOG, error });
+                }
                 if (!Client.MarkForDelete || !Client.AccountNumber.empty()) {
-                    vClients.push_back(Client);
-                    validRecords++;
+                    accepted[lineNumber - 1] = 1;
                 }
                 else {
-                    skippedRecords++;
-                    logMessage("Skipped invalid client record at line " + formatInt(lineNumber), WARNING);
+                    chunk.Skipped++;
+                    chunk.Messages.push_back({ WARNING, "Skipped invalid client record at line " + formatInt(lineNumber) });
                 }
             }
             catch (const exception& e) {
-                skippedRecords++;
-                logMessage("Error parsing line " + formatInt(lineNumber) + ": " + string(e.what()), ERROR_LOG);
+                chunk.Skipped++;
+                chunk.Messages.push_back({ ERROR_LOG, "Error parsing line " + formatInt(lineNumber) + ": " + string(e.what()) });
             }
+        });
+    });
+
+    // Drop blank and rejected lines, keeping file order (the records left over are freed here)
+    size_t validRecords = 0;
+    for (size_t i = 0; i < totalLines; i++) {
+        if (accepted[i]) {
+            if (i != validRecords) vClients[validRecords] = move(vClients[i]);
+            validRecords++;
         }
-        myFile.close();
+    }
+    vClients.resize(validRecords);
 
-        logMessage("Loaded " + formatInt(validRecords) + " clients (" +
-            formatInt(skippedRecords) + " skipped)", INFO);
+    size_t skippedRecords = 0;
+    for (const strLoadChunk& chunk : chunks) {
+        skippedRecords += chunk.Skipped;
     }
+    logChunkMessages(chunks);
 
+    logMessage("Loaded " + formatInt(validRecords) + " clients (" +
+        formatInt(skippedRecords) + " skipped)", INFO);
+
+    replayBalanceJournal(fileName, vClients);
+    markClientStoreSynced(fileName, vClients, clientsStamp, journalStamp);
+    registerClientAccounts(vClients);
+}
+// Load all clients from file, return vector of clients
+vector<strClient> loadClientsDataFromFile(const string& fileName) {
+    vector<strClient> vClients;
+    loadClientsDataFromFile(fileName, vClients);
     return vClients;
 }
 // Save all clients to file (skip those marked for deletion)
@@ -340,6 +732,7 @@ void saveClientsToFile(string FileName, const vector<strClient>& vClients) {
 // Load all Users from file, return vector of Users
 vector<strUser> loadUsersDataFromFile(const string& fileName) {
     vector<strUser> vUsers;
+    invalidateHashIndex(UserIndex);
 
     if (!validateFileBeforeLoad(fileName, "Users")) {
         return vUsers;
@@ -357,12 +750,12 @@ vector<strUser> loadUsersDataFromFile(const string& fileName) {
 
         while (getline(myFile, Line)) {
             lineNumber++;
-            if (trim(Line).empty()) continue;
+            if (trimView(Line).empty()) continue;
 
             try {
                 User = deserializeUserRecord(Line, Separator);
                 if (!User.MarkForDelete || !User.UserName.empty()) {
-                    vUsers.push_back(User);
+                    vUsers.push_back(move(User));
                     validRecords++;
                 }
                 else {
@@ -393,46 +786,101 @@ void saveUsersToFile(string FileName, const vector<strUser>& vUsers) {
 // Load all Transactions from file, return vector of Transactions
 vector<Transaction> loadTransactionsFromFile(const string& fileName) {
     vector<Transaction> transactions;
-    fstream file(fileName, ios::in);
+    string content;
 
-    if (!file.is_open()) {
+    if (!readFileToString(fileName, content)) {
         return transactions;
     }
 
     try {
-        string line;
-        while (getline(file, line)) {
-            if (!line.empty()) {
-                Transaction txn = deserializeTransactionRecord(line);
-                transactions.push_back(txn);
+        string_view contentView(content);
+        vector<strLoadChunk> chunks = splitIntoLoadChunks(contentView);
+        size_t totalLines = assignChunkLines(contentView, chunks);
+
+        transactions.resize(totalLines);
+        vector<char> present(totalLines, 0);
+
+        runInParallel(chunks.size(), [&](size_t c) {
+            strLoadChunk& chunk = chunks[c];
+            size_t lineIndex = chunk.FirstLine;
+
+            forEachLine(contentView.substr(chunk.Begin, chunk.End - chunk.Begin), [&](string_view line) {
+                size_t index = lineIndex++;
+                if (line.empty()) return;
+
+                string error;
+                if (!parseTransactionRecord(line, transactions[index], error)) {
+                    chunk.Messages.push_back({ ERROR_LOG, error });
+                }
+                present[index] = 1;
+            });
+        });
+
+        size_t count = 0;
+        for (size_t i = 0; i < totalLines; i++) {
+            if (present[i]) {
+                if (i != count) transactions[count] = move(transactions[i]);
+                count++;
             }
         }
-        file.close();
+        transactions.resize(count);
+        logChunkMessages(chunks);
     }
     catch (const exception& e) {
-        file.close();
         throw runtime_error(string("Error loading transactions: ") + e.what());
     }
 
     return transactions;
 }
-// Save a single transaction to file
-void saveTransactionToFile(const Transaction& transaction) {
-    string transactionLine = transaction.TransactionID + Separator +
-        formatInt(transaction.Type) + Separator +
-        transaction.FromAccount + Separator +
-        transaction.ToAccount + Separator +
-        formatDouble(transaction.Amount) + Separator +
-        formatDouble(transaction.Fees) + Separator +
-        transaction.Timestamp + Separator +
+// Convert Transaction struct to file line
+string serializeTransactionRecord(const Transaction& transaction, const string& separator = Separator) {
+    return transaction.TransactionID + separator +
+        formatInt(transaction.Type) + separator +
+        transaction.FromAccount + separator +
+        transaction.ToAccount + separator +
+        formatMoney(transaction.Amount) + separator +
+        formatMoney(transaction.Fees) + separator +
+        transaction.Timestamp + separator +
         transaction.Description;
+}
+// Save a single transaction to the ledger and index it for history and ID lookups
+void saveTransactionToFile(const Transaction& transaction) {
+    strMetricTimer timer(METRIC_LEDGER_APPEND);
+    string transactionLine = serializeTransactionRecord(transaction);
+    long long offset = 0, nextOffset = 0;
 
     try {
-        appendLineToFile(TransactionsFileName, transactionLine);
+        appendLedgerRecord(TransactionsFileName, transaction, transactionLine, offset, nextOffset);
     }
     catch (const exception& e) {
         throw runtime_error(string("Error saving transaction: ") + e.what());
     }
+
+    appendToTransactionIndex(TransactionsFileName, offset, nextOffset, transaction);
+    appendTransactionIds(TransactionsFileName, { transaction }, { offset, nextOffset });
+    noteRecentTransaction(transaction);
+}
+// Save many transactions with one batched ledger append and one index append
+void saveTransactionsToFile(const vector<Transaction>& transactions) {
+    vector<string> transactionLines;
+    transactionLines.reserve(transactions.size());
+    for (const Transaction& transaction : transactions) {
+        transactionLines.push_back(serializeTransactionRecord(transaction));
+    }
+
+    vector<long long> offsets;
+    try {
+        appendLedgerRecords(TransactionsFileName, transactions, transactionLines, offsets);
+    }
+    catch (const exception& e) {
+        throw runtime_error(string("Error saving transactions: ") + e.what());
+    }
+
+    appendRecordsToTransactionIndex(TransactionsFileName, transactions, offsets);
+    appendTransactionIds(TransactionsFileName, transactions, offsets);
+    for (const Transaction& transaction : transactions) {
+        noteRecentTransaction(transaction);
+    }
 }
 // Append line to file
 void appendLineToFile(const string& FileName, const string& stDataLine) {
@@ -452,3 +900,13 @@ void appendLineToFile(const string& FileName, const string& stDataLine) {
 
     MyFile.close();
 }
+// Append one new client to the clients file in the current storage format
+void appendClientToFile(const string& fileName, const strClient& client) {
+    if (ClientFile.Format == CLIENTS_BINARY) {
+        if (!appendBinaryClient(getBinaryClientsFileName(fileName), client)) {
+            throw runtime_error("Cannot store client in: " + getBinaryClientsFileName(fileName));
+        }
+        return;
+    }
+    appendLineToFile(fileName, serializeClientRecord(client));
+}
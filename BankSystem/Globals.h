@@ -17,6 +17,18 @@
 #include <functional>
 #include <sodium.h>
 #include <chrono>
+#include <cmath>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <unordered_map>
+#include <map>
+#include <deque>
+#include <atomic>
+#include <array>
 
 #ifdef _WIN32
 #define NOMINMAX
@@ -34,6 +46,49 @@ const string TransactionsFileName = "Transactions.txt";
 const string UsersFileName = "Users.txt";
 const string LogFileName = "SystemLog.txt";
 const string Separator = "#//#";
+const int    JournalCheckpointInterval = 1000;
+const int    TransferFeePercent = 1;
+const size_t LogBufferCapacity = 4096;
+const int    LogBatchDelayMs = 20;
+const long long LedgerSegmentMaxBytes = 16 * 1024 * 1024;
+const size_t ConcurrentLedgerStripes = 1024;
+const string ServerSocketFileName = "BankSystem.sock";
+const size_t ServerMaxRequestBytes = 4096;
+const int    ServerLoginWorkers = 2;              // Threads verifying teller passwords off the poll loop
+const bool   ClientStoreUseInotify = true;
+const size_t ScreenPageRows = 50;            // Table rows per page on a terminal
+const size_t MoneyTextSize = 32;             // Buffer size for writeMoney()
+const long long GroupCommitWindowMicros = 1000;   // Default group commit window
+const string MetricsFileName = "Metrics.txt";
+const int    MetricsDumpIntervalSeconds = 60;      // Metrics file is rewritten this often
+const int    MetricSubBuckets = 16;                // Histogram buckets per power of two (~6% resolution)
+const int    MetricBucketCount = (64 - 3) * MetricSubBuckets;   // Covers every 64-bit nanosecond value
+const string BinaryClientsExtension = ".dat";      // Clients.txt -> Clients.dat in binary storage
+const char   BinaryClientsMagic[8] = { 'B', 'S', 'C', 'L', 'I', 'E', 'N', 'T' };
+const uint32_t BinaryClientsVersion = 1;
+const size_t BinaryClientSlotSize = 256;           // Header and every client slot; sector aligned
+const string AccountIdsExtension = ".ids";         // Clients.txt -> Clients.txt.ids, line n = account id n
+const string AccountIdsLockExtension = ".lock";    // Clients.txt.ids -> Clients.txt.ids.lock, held while new ids are given
+const uint32_t NoArenaId = UINT32_MAX;             // String not interned
+const uint32_t NoAccountId = NoArenaId;            // Account without an id (or no account)
+const size_t RecentTransactionsCount = 10;         // Newest transactions kept per cached account
+const size_t RecentCardRows = 5;                   // Of those, shown on the client card
+const size_t RecentCacheMaxAccounts = 10000;       // Accounts with a cached ring before one is evicted
+const string TransactionIdsExtension = ".tid";     // Transactions.txt -> Transactions.txt.tid, ID hash table
+const char   TransactionIdsMagic[8] = { 'B', 'S', 'T', 'X', 'N', 'I', 'D', 'S' };
+const uint32_t TransactionIdsVersion = 1;
+const uint64_t TransactionIdsMinSlots = 1024;      // Table size of an empty ledger; doubles at 3/4 full
+const size_t TransactionIdsProbeSlots = 16;        // Slots read per positioned read while probing
+const string ReversalIdSuffix = "-REV";            // Reversal of X has ID X + suffix: one per transaction
+const string TransactionIdPrefix = "TXS";          // Sorts after the older "TXN" + microseconds IDs
+const size_t TransactionIdDigits = 19;             // Fixed width, so text order is numeric order
+const size_t TransactionIdTextSize = 24;           // Buffer size for writeTransactionId()
+const long long TransactionIdEpochMillis = 1735689600000LL;   // 2025-01-01 00:00:00 UTC
+const int    TransactionIdNodeBits = 10;           // Up to 1024 processes (--node)
+const int    TransactionIdSequenceBits = 12;       // IDs per node per millisecond before borrowing the next one
+const uint32_t NoTransactionNode = UINT32_MAX;     // Node id not chosen yet
+const string TransactionNodeLockExtension = ".node";   // Transactions.txt -> Transactions.txt.node<N>, locked by node N
+const string LedgerLockExtension = ".lock";        // Transactions.txt -> Transactions.txt.lock, held while appending
 
 const string RED = "\033[31m";
 const string GREEN = "\033[32m";
@@ -42,11 +97,13 @@ const string BLUE = "\033[34m";
 const string MAGENTA = "\033[35m";
 const string CYAN = "\033[36m";
 const string RESET = "\033[0m";
+const string ClearScreenSequence = "\033[H\033[2J\033[3J";   // Home, clear screen, clear scrollback
 
 enum TransactionType {
     DEPOSIT = 1,
     WITHDRAWAL = 2,
-    TRANSFER = 3
+    TRANSFER = 3,
+    REVERSAL = 4                         // Undoes the transaction named in its ID (see ReversalIdSuffix)
 };
 enum MainMenuOption {
     ShowClientList = 1,
@@ -57,7 +114,8 @@ enum MainMenuOption {
     Transactions = 6,
     ManageUsers = 7,
     Logout = 8,
-    Exit = 9
+    Exit = 9,
+    PerformanceStats = 10
 };
 enum TransactionsOption {
     Deposit = 1,
@@ -65,7 +123,8 @@ enum TransactionsOption {
     Transfer = 3,
     ShowTotalBalance = 4,
     ShowTransactionsHistory = 5,
-    ShowMainMenu = 6
+    FindTransaction = 6,
+    ShowMainMenu = 7
 };
 enum UserManagementOption {
     ListUser = 1,
@@ -85,6 +144,31 @@ enum Permission {
     pManageUsers = 64,
     pAll = 127  // Full Access
 };
+enum DurabilityMode {
+    DURABILITY_NONE,        // Leave flushing to the OS
+    DURABILITY_GROUP,       // Commits within a short window share one sync
+    DURABILITY_FSYNC        // Every commit syncs before returning
+};
+enum ClientFileFormat {
+    CLIENTS_TEXT,           // "#//#" lines in Clients.txt, rewritten on save
+    CLIENTS_BINARY          // Fixed-width slots in Clients.dat, updated in place
+};
+enum MetricId {
+    METRIC_LOAD_CLIENTS,
+    METRIC_SAVE_CLIENTS,
+    METRIC_LEDGER_APPEND,
+    METRIC_BALANCE_COMMIT,
+    METRIC_HASH_PASSWORD,
+    METRIC_VERIFY_PASSWORD,
+    METRIC_LOGIN,
+    METRIC_DEPOSIT,
+    METRIC_WITHDRAW,
+    METRIC_TRANSFER,
+    METRIC_HISTORY,
+    METRIC_ID_LOOKUP,
+    METRIC_REVERSAL,
+    METRIC_COUNT
+};
 enum LogLevel {
     INFO,
     WARNING,
@@ -92,13 +176,21 @@ enum LogLevel {
     CRITICAL
 };
 
+// Fixed-point money: whole cents in a 64-bit integer (12.34 -> 1234)
+typedef int64_t Money;
+
+// Balance report buckets: below 0, then from each bound up to the next (in cents)
+const size_t BalanceBucketCount = 6;
+const Money  BalanceBucketBounds[BalanceBucketCount - 1] = { 0, 100 * 100, 1000 * 100, 10000 * 100, 100000 * 100 };
+const size_t BalanceKernelLanes = 8;                     // Independent accumulators per aggregation kernel
+
 struct Transaction {
     string          TransactionID;
     TransactionType Type = TransactionType::DEPOSIT;
     string          FromAccount;
     string          ToAccount;
-    double          Amount = 0.0;
-    double          Fees = 0.0;
+    Money           Amount = 0;
+    Money           Fees = 0;
     string          Timestamp;
     string          Description;
 };
@@ -107,9 +199,120 @@ struct strClient {
     string              PinCode;
     string              Name;
     string              Phone;
-    double              AccountBalance = 0.0;
+    Money               AccountBalance = 0;
     bool                MarkForDelete = false;
-    vector<Transaction> Transactions;
+};
+struct strJournalLeg {
+    string AccountNumber;
+    Money  Delta;
+};
+struct strJournalState {
+    long long LastSequence = 0;        // Highest sequence written or replayed
+    long long CheckpointSequence = 0;  // Highest sequence included in clients file
+    int       PendingEntries = 0;      // Entries appended since last checkpoint
+};
+struct strLoadChunk {
+    size_t Begin = 0;                          // Byte range [Begin, End) in file content
+    size_t End = 0;
+    size_t FirstLine = 0;                      // Index of first line in whole file
+    size_t LineCount = 0;
+    size_t Skipped = 0;                        // Records rejected in this chunk
+    vector<pair<LogLevel, string>> Messages;   // Diagnostics, logged in file order after parsing
+};
+struct strHashIndex {
+    vector<int32_t> Slots;                // Position + 1 in owning vector, 0 = empty
+    const void*     Owner = nullptr;      // data() of the indexed vector
+    size_t          IndexedCount = 0;     // Records indexed so far
+};
+struct strFileStamp {
+    bool      Exists = false;
+    long long ModifiedTime = 0;          // Nanoseconds on Linux, seconds elsewhere
+    long long Inode = 0;                 // Changes when a file is replaced by rename
+    long long Size = 0;
+};
+struct strLedgerSegment {
+    int       Number = 0;
+    string    FileName;
+    bool      Sealed = false;
+    long long BaseOffset = 0;          // Logical ledger offset of the segment's first byte
+    long long Bytes = 0;
+    long long Records = 0;
+    string    FirstTimestamp;          // Time range of the records
+    string    LastTimestamp;
+    string    MinTransactionID;        // ID range of the records
+    string    MaxTransactionID;
+};
+struct strLedger {
+    string                        LedgerFile;   // Logical ledger name, "" = not opened
+    vector<strLedgerSegment>      Segments;     // Sealed segments, then the active one
+    strFileStamp                  ManifestStamp;    // Manifest the segments were read from
+#ifdef _WIN32
+    HANDLE                        Lock = INVALID_HANDLE_VALUE;  // Ledger lock file while held
+#else
+    int                           Lock = -1;
+#endif
+    int                           LockDepth = 0;    // Nested lockLedger() calls
+};
+struct strLedgerReader {
+    int      Segment = -1;                      // Index of the open segment
+    ifstream File;
+};
+struct strMappedFile {
+    const char* Data = nullptr;                 // Read-only mapping of the whole file, nullptr = not mapped
+    size_t      Size = 0;
+#ifdef _WIN32
+    HANDLE      FileHandle = INVALID_HANDLE_VALUE;
+    HANDLE      MappingHandle = nullptr;
+#endif
+};
+struct strTransactionView {
+    string_view     TransactionID;              // Text fields point into a mapped ledger segment
+    TransactionType Type = TransactionType::DEPOSIT;
+    string_view     FromAccount;
+    string_view     ToAccount;
+    Money           Amount = 0;
+    Money           Fees = 0;
+    string_view     Timestamp;
+    string_view     Description;
+    long long       Offset = 0;                 // Logical ledger offsets of this line and the next
+    long long       NextOffset = 0;
+};
+struct strLedgerViewSegment {
+    strLedgerSegment Segment;                   // Ledger segment as it was when the view was opened
+    strMappedFile    File;                      // Mapped on first use
+    bool             Mapped = false;            // Mapping attempted (missing or empty files stay unmapped)
+    size_t           Bytes = 0;                 // Complete lines in the mapping; a torn last line is left out
+};
+struct strLedgerView {
+    vector<strLedgerViewSegment> Segments;
+    bool      Sequential = false;               // Tell the OS the segments are read front to back
+    size_t    MappedSegments = 0;               // Segments mapped so far
+};
+struct strLedgerCursor {
+    size_t Segment = 0;                         // Position in strLedgerView::Segments
+    size_t Position = 0;                        // Byte in that segment
+    size_t EndSegment = SIZE_MAX;               // Stop before this segment
+};
+struct strTransactionIndex {
+    vector<vector<long long>> Offsets;                  // Account id -> ledger line offsets, file order
+    string    LedgerFile;                               // Ledger the offsets belong to
+    long long IndexedBytes = -1;                        // Ledger bytes covered, -1 = not loaded
+};
+struct strAsyncLogger {
+    vector<string>     Ring;                    // Bounded buffer of pending log lines
+    size_t             Head = 0;                // Oldest pending line
+    size_t             Count = 0;               // Pending lines
+    unsigned long long Enqueued = 0;            // Lines accepted so far
+    unsigned long long Written = 0;             // Lines written and flushed so far
+    LogLevel           FlushLevel = WARNING;    // Lines at or above this level wait until written
+    bool               Running = false;
+    bool               StopRequested = false;
+    bool               FlushRequested = false;  // A caller waits for queued lines to be written
+    bool               ShutDown = false;        // Stopped for good, log synchronously from now on
+    mutex              Lock;
+    condition_variable HasEntries;              // Signals the writer thread
+    condition_variable Progress;                // Signals producers: space freed / lines written
+    thread             Writer;
 };
 struct strUser {
     string UserName = "";
@@ -117,8 +320,269 @@ struct strUser {
     int    Permissions = -1;
     bool   MarkForDelete = false;
 };
+struct strSessionCache {
+    unsigned char* Key = nullptr;        // sodium_malloc'd, read-only once loaded
+    string       SessionPath;            // Resolved once (whoami spawns a process)
+    bool         Checked = false;        // Session file examined at least once
+    strFileStamp Stamp;                  // Session file when last examined
+    bool         HasSession = false;     // Decoded session was valid
+    strUser      User;
+};
+struct strClientStore {
+    string       FileName;               // Clients file the in-memory vector matches
+    const void*  Owner = nullptr;        // data() of that vector, nullptr = not in sync
+    size_t       Count = 0;              // Its size when synced
+    strFileStamp ClientsStamp;           // Clients file and journal when synced
+    strFileStamp JournalStamp;
+    int          WatchFd = -1;           // inotify on the data folder (Linux), -1 = stat only
+    bool         Changed = false;        // Watch saw an event for the watched files
+    long long    Reloads = 0;            // Full loads from disk
+    long long    ReloadsAvoided = 0;     // Refreshes answered from memory
+    long long    StatChecks = 0;         // Refreshes that needed stat() to decide
+};
+struct strStringArena {
+    string           Chars;              // Interned strings back to back
+    vector<uint32_t> Offsets = { 0 };    // Start of string id in Chars, plus the end
+    vector<uint32_t> Slots;              // Open-addressing table: id + 1, 0 = empty
+};
+struct strAccountDictionary {
+    strStringArena Accounts;             // Account number of id n is string n
+    string FileName;                     // Dictionary file the ids came from
+    size_t PersistedCount = 0;           // Ids already in the file
+    uint64_t PersistedBytes = 0;         // Length of the file those ids span
+#ifdef _WIN32
+    HANDLE Lock = INVALID_HANDLE_VALUE;  // Locked .ids.lock from the first new id to the flush
+#else
+    int    Lock = -1;
+#endif
+};
+struct strClientColumns {
+    vector<Money>    Balances;           // One balance per client, contiguous
+    vector<uint32_t> AccountIds;         // Account id of each client (AccountIds dictionary)
+    vector<uint32_t> NameIds;            // Id of each client's name in Names
+    strStringArena   Names;              // Distinct client names (interned)
+};
+struct strBalanceSummary {
+    size_t Count = 0;
+    Money  Total = 0;
+    Money  Minimum = 0;
+    Money  Maximum = 0;
+    size_t Negative = 0;                        // Clients with a balance below zero
+    size_t Buckets[BalanceBucketCount] = {};    // Clients per BalanceBucketBounds range
+};
+struct strTableColumn {
+    string Title;
+    int    Width;                        // Cell width, text is padded like setw (never cut)
+};
+struct strScreenBuffer {
+    string Text;                         // Screen or page being built, reused between screens
+    int    Interactive = -1;             // stdin and stdout are a terminal: -1 unknown, 0 no, 1 yes
+    size_t Writes = 0;                   // Buffers written to the terminal
+};
+struct alignas(64) strAccountLock {
+    mutex Lock;                                 // One cache line per stripe, no false sharing
+};
+struct strConcurrentLedger {
+    vector<strClient>      Clients;             // Owned client set, fixed while posting
+    strHashIndex           Index;               // Built once, read-only lookups afterwards
+    vector<strAccountLock> Stripes;             // Client at position p is guarded by Stripes[p % size]
+};
+struct strBatchOperation {
+    size_t          LineNumber = 0;    // 1-based line in the batch file
+    TransactionType Type = TransactionType::DEPOSIT;
+    string          FromAccount;
+    string          ToAccount;         // Same as FromAccount for deposits and withdrawals
+    Money           Amount = 0;
+    string          Description;       // Empty = default description of the type
+};
+struct strBatchReport {
+    size_t   Operations = 0;                    // Non-blank lines in the batch file
+    size_t   Applied = 0;
+    vector<pair<size_t, string>> Failures;      // Line number -> reason, in file order
+    bool     Committed = false;                 // Ledger and clients file were written
+    double   ApplySeconds = 0;                  // Parse + validate + apply in memory
+    double   CommitSeconds = 0;                 // Ledger append + clients file write
+};
+struct strServerSession {
+    uint64_t Id = 0;                            // Names the session in login results
+    int     Socket = -1;
+    string  Input;                              // Received bytes not yet ending in '\n'
+    string  Output;                             // Response bytes not yet sent
+    bool    LoggedIn = false;
+    bool    Closing = false;                    // Close once Output is sent
+    bool    LoginPending = false;               // A worker is verifying its password; later requests wait
+    strUser User;
+};
+struct strServerLogin {
+    uint64_t SessionId = 0;
+    string   UserName;                          // As typed
+    string   Password;
+    bool     Known = false;                     // User exists; User holds its record
+    strUser  User;
+    bool     Verified = false;                  // Set by the worker
+};
+struct strServerLogins {
+    mutex    Lock;                              // Guards Jobs, Done and Stopping
+    condition_variable Wake;
+    deque<strServerLogin>  Jobs;
+    vector<strServerLogin> Done;                // Verified, waiting for the poll loop
+    bool     Stopping = false;
+    vector<thread> Workers;
+    int      WakeFds[2] = { -1, -1 };           // A worker writes to [1] after each result; the loop polls [0]
+    bool         UsersLoaded = false;           // Users below are the Users file as of UsersStamp (loop only)
+    strFileStamp UsersStamp;
+    vector<strUser> Users;
+};
+struct strServerControl {
+    atomic<bool> StopRequested{ false };        // Set by SIGINT/SIGTERM or another thread
+    atomic<bool> Ready{ false };                // Listening socket is accepting
+    atomic<long long> Requests{ 0 };            // Requests handled since start
+};
+struct strDurability {
+    DurabilityMode Mode = DURABILITY_GROUP;
+    long long    WindowMicros = GroupCommitWindowMicros;   // Leader waits this long when other commits are pending
+    mutex        Lock;
+    condition_variable Synced;
+    vector<string> DirtyFiles;           // Written since the last sync started
+    long long    WriteTicket = 0;        // Writes noted so far
+    long long    SyncedTicket = 0;       // Writes covered by a finished sync
+    long long    FailedTicket = -1;      // Writes covered by the last sync round that failed, -1 = none
+    bool         SyncRunning = false;
+    int          Committers = 0;         // Commits waiting for their writes to be synced
+    static inline thread_local int GroupDepth = 0;   // This thread's open begin/endDurableGroup() scopes
+    long long    Commits = 0;
+    long long    Syncs = 0;              // Sync rounds (each may cover many commits and files)
+};
+struct strLatencyHistogram {
+    atomic<uint64_t> Buckets[MetricBucketCount] = {};   // Samples per log-linear nanosecond bucket
+    atomic<uint64_t> Count{ 0 };
+    atomic<uint64_t> TotalNanos{ 0 };
+    atomic<uint64_t> MaxNanos{ 0 };
+};
+struct strMetrics {
+    strLatencyHistogram Histograms[METRIC_COUNT];
+    chrono::steady_clock::time_point Started = chrono::steady_clock::now();
+    mutex              Lock;                    // Guards the dumper state below
+    condition_variable Wake;
+    thread             Dumper;
+    bool               Running = false;
+    bool               StopRequested = false;
+    long long          Dumps = 0;               // Metrics files written
+};
+
+struct strRecentRing {
+    vector<Transaction> Items;           // Up to RecentTransactionsCount, oldest overwritten first
+    size_t Next = 0;                     // Oldest item once full (where the next one goes)
+    size_t Total = 0;                    // Transactions of the account in the ledger
+};
+struct strRecentCache {
+    unordered_map<uint32_t, strRecentRing> Rings;   // Account id -> ring, only accounts viewed this session
+    mutex            Lock;                // Guards Rings and Generation; never held across ledger or index reads
+    uint64_t         Generation = 0;      // Bumped by every clear and posting, so a ring loaded meanwhile is not kept
+    atomic<uint64_t> Hits{ 0 };          // Served from a ring
+    atomic<uint64_t> Misses{ 0 };        // Ring filled from the ledger
+    atomic<uint64_t> Updates{ 0 };       // Postings added to a cached ring
+    atomic<uint64_t> Evictions{ 0 };
+};
+
+struct strBinaryClientHeader {             // Slot 0 of Clients.dat (little-endian)
+    char     Magic[8];
+    uint32_t Version;
+    uint32_t SlotSize;
+    uint64_t SlotCount;                    // Client slots after the header, live and free
+    uint64_t LiveCount;
+    uint64_t FreeHead;                     // First free slot + 1, 0 = none
+    uint32_t Checksum;                     // CRC-32 of the header with this field 0
+    char     Reserved[BinaryClientSlotSize - 44];
+};
+struct strBinaryClientSlot {
+    int64_t  Balance;                      // Cents
+    uint64_t Sequence;                     // Last journal sequence folded into this slot
+    uint64_t NextFree;                     // Free slots: next free slot + 1, 0 = end
+    uint32_t Live;                         // 1 = client, 0 = free
+    uint32_t Checksum;                     // CRC-32 of the slot with this field 0
+    char     AccountNumber[32];            // Text fields are NUL padded, not terminated when full
+    char     PinCode[24];
+    char     Name[112];
+    char     Phone[56];
+};
+static_assert(sizeof(strBinaryClientHeader) == BinaryClientSlotSize, "binary clients header must fill one slot");
+static_assert(sizeof(strBinaryClientSlot) == BinaryClientSlotSize, "binary client slot size changed");
+struct strBinarySlotRef {
+    uint64_t Slot = 0;                     // Slot index (0 = first client slot)
+    uint64_t Sequence = 0;                 // As stored in the slot
+    size_t   ContentHash = 0;              // Of the slot as stored: unchanged clients are not rewritten
+    uint64_t SaveMark = 0;                 // Last save that saw this account
+};
+struct strClientFile {
+    ClientFileFormat Format = CLIENTS_TEXT;
+    string   FileName;                     // Binary file the slots below describe
+    bool     Unusable = false;             // Last loaded file is foreign or another version: never written
+    int      Fd = -1;                      // Open for positioned writes, -1 = closed
+    uint64_t SlotCount = 0;
+    uint64_t LiveCount = 0;
+    vector<uint64_t> FreeSlots;            // Free-list, back() = head
+    unordered_map<string, strBinarySlotRef> Slots;   // Account number -> its slot
+    uint64_t SaveMarks = 0;
+    long long SlotWrites = 0;
+};
+struct strTransactionIdGenerator {
+    atomic<uint64_t> Last{ 0 };              // Millisecond << TransactionIdSequenceBits | sequence of the newest ID
+    atomic<uint32_t> NodeId{ NoTransactionNode };
+    atomic<uint64_t> Borrowed{ 0 };          // IDs stamped ahead of the clock (sequence used up, clock stepped back)
+    mutex            ClaimLock;              // Held while a node id is claimed or released
+#ifdef _WIN32
+    HANDLE           NodeLock = INVALID_HANDLE_VALUE;   // Open, unshared lock file of NodeId
+#else
+    int              NodeLock = -1;                     // flock()ed lock file of NodeId
+#endif
+};
+struct strTransactionIdHeader {           // Start of Transactions.txt.tid (little-endian)
+    char     Magic[8];
+    uint32_t Version;
+    uint32_t SlotSize;
+    uint64_t SlotCount;                    // Power of two
+    uint64_t Entries;                      // Used slots
+    int64_t  IndexedBytes;                 // Ledger bytes whose records are in the table
+    uint32_t Checksum;                     // CRC-32 of the header with this field 0
+    char     Reserved[20];
+};
+struct strTransactionIdSlot {
+    uint64_t Hash;                         // Hash of the transaction ID, 0 = empty slot
+    int64_t  Offset;                       // Logical ledger offset of the record
+};
+static_assert(sizeof(strTransactionIdHeader) == 64, "transaction ID index header size changed");
+static_assert(sizeof(strTransactionIdSlot) == 16, "transaction ID slot size changed");
+struct strTransactionIdIndex {
+    string    LedgerFile;                  // Ledger the table belongs to, "" = not open
+    string    FileName;
+    int       Fd = -1;                     // Open for positioned reads and writes, -1 = closed
+    uint64_t  SlotCount = 0;
+    uint64_t  Entries = 0;
+    long long IndexedBytes = 0;
+    long long Lookups = 0;
+    long long Probes = 0;                  // Positioned reads made by lookups
+};
 
 extern strUser CurrentUser;
+extern strJournalState JournalState;
+extern strHashIndex ClientIndex;
+extern strHashIndex UserIndex;
+extern strLedger Ledger;
+extern strTransactionIndex TransactionIndex;
+extern strAsyncLogger AsyncLogger;
+extern strSessionCache SessionCache;
+extern strClientStore ClientStore;
+extern strServerControl ServerControl;
+extern strServerLogins ServerLogins;
+extern strScreenBuffer ScreenBuffer;
+extern strDurability Durability;
+extern strMetrics Metrics;
+extern strClientFile ClientFile;
+extern strAccountDictionary AccountIds;
+extern strRecentCache RecentCache;
+extern strTransactionIdIndex TransactionIds;
+extern strTransactionIdGenerator IdGenerator;
 
 //=====================================================
 //=============== Forward Declarations ================
@@ -127,9 +591,14 @@ extern strUser CurrentUser;
 // Utilities
 string formatDouble(double value, int precision = 2);
 string formatInt(int value);
-string formatCurrency(double value);
+string formatMoney(Money value);
+string formatCurrency(Money value);
 string trim(const string& str);
+string_view trimView(string_view str);
+errc   parseMoneyField(string_view field, Money& value);
 string getCurrentTimestamp();
+uint32_t computeCRC32(const char* data, size_t length, uint32_t crc = 0);
+string formatHex32(uint32_t value);
 void   clearScreen();
 void   drawLine(int length = 60, char symbol = '-', string color = RESET);
 void   showLine(int length = 60, char symbol = '-', string color = RESET);
@@ -145,8 +614,11 @@ void   backToMenu();
 
 // Session & Encryption
 vector<unsigned char> getEncryptionKey();
+const unsigned char* getCachedEncryptionKey();
 string serializeUserData(const strUser& user);
+string encryptData(const string& plaintext, const unsigned char* key);
 string encryptData(const string& plaintext, const vector<unsigned char>& key);
+string decryptData(const string& encryptedData, const unsigned char* key);
 string decryptData(const string& encryptedData, const vector<unsigned char>& key);
 strUser deserializeUserData(const string& data);
 
@@ -156,6 +628,7 @@ void appendLineToFile(const string& FileName, const string& stDataLine);
 // Logging
 string logLevelToString(LogLevel level);
 void logMessage(const string& message, LogLevel level = INFO);
+void flushLogger();
 void logTransaction(const Transaction& txn);
 void logLoginAttempt(const string& username, bool success);
 void logUserAction(const string& action, const string& details = "");
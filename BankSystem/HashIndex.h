@@ -0,0 +1,112 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: HashIndex.h                                      ||
+//  || Section: Hash Index                                    ||
+//  || Open-addressing hash index over the clients and users  ||
+//  || vectors, keyed by account number and username.         ||
+//  ||========================================================||
+
+#include "Globals.h"
+
+//=====================================================
+//===================== Hash Index ====================
+// The index stores positions into the vector it was built
+// for and keeps itself in sync lazily on every lookup:
+// 1. A different vector buffer (reload, reallocation)
+//    triggers a full rebuild
+// 2. Records appended with push_back are inserted
+// 3. Loaders call invalidateHashIndex() so a new vector
+//    reusing an old buffer address is never trusted
+// Keys must not be edited in place (updates keep them).
+//=====================================================
+
+// Key used to index a client
+const string& getIndexKey(const strClient& client) {
+    return client.AccountNumber;
+}
+// Key used to index a user
+const string& getIndexKey(const strUser& user) {
+    return user.UserName;
+}
+// FNV-1a hash of a key
+uint64_t hashIndexKey(string_view key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+// Forget the indexed vector so the next lookup rebuilds
+void invalidateHashIndex(strHashIndex& index) {
+    index.Owner = nullptr;
+    index.IndexedCount = 0;
+}
+// Insert record position unless the key is already present (first match wins)
+template <typename T>
+void insertIntoHashIndex(strHashIndex& index, const vector<T>& records, size_t position) {
+    const string& key = getIndexKey(records[position]);
+    size_t mask = index.Slots.size() - 1;
+    size_t slot = hashIndexKey(key) & mask;
+
+    while (index.Slots[slot] != 0) {
+        if (getIndexKey(records[index.Slots[slot] - 1]) == key) {
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    index.Slots[slot] = static_cast<int32_t>(position + 1);
+}
+// Rebuild index for all records, sized to keep load factor at or below 1/2
+template <typename T>
+void rebuildHashIndex(strHashIndex& index, const vector<T>& records) {
+    size_t capacity = 16;
+    while (capacity < records.size() * 2) {
+        capacity <<= 1;
+    }
+
+    index.Slots.assign(capacity, 0);
+    for (size_t i = 0; i < records.size(); i++) {
+        insertIntoHashIndex(index, records, i);
+    }
+    index.Owner = records.data();
+    index.IndexedCount = records.size();
+}
+// Bring index up to date with the vector (rebuild or insert appended records)
+template <typename T>
+void syncHashIndex(strHashIndex& index, const vector<T>& records) {
+    if (index.Owner != records.data() || index.IndexedCount > records.size()) {
+        rebuildHashIndex(index, records);
+        return;
+    }
+    if (index.IndexedCount == records.size()) {
+        return;
+    }
+    if (records.size() * 2 > index.Slots.size()) {
+        rebuildHashIndex(index, records);
+        return;
+    }
+    for (size_t i = index.IndexedCount; i < records.size(); i++) {
+        insertIntoHashIndex(index, records, i);
+    }
+    index.IndexedCount = records.size();
+}
+// Find record by key, return pointer into the vector or nullptr
+template <typename T>
+T* findInHashIndex(strHashIndex& index, vector<T>& records, const string& key) {
+    syncHashIndex(index, records);
+
+    size_t mask = index.Slots.size() - 1;
+    size_t slot = hashIndexKey(key) & mask;
+
+    while (index.Slots[slot] != 0) {
+        size_t position = index.Slots[slot] - 1;
+        if (position < records.size() && getIndexKey(records[position]) == key) {
+            return &records[position];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
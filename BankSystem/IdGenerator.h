@@ -0,0 +1,174 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: IdGenerator.h                                    ||
+//  || Section: Transaction ID Generator                      ||
+//  || Snowflake-style 64-bit transaction IDs: increasing in  ||
+//  || commit order, unique across threads and processes.     ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#endif
+
+//=====================================================
+//============== Transaction ID Generator =============
+// An ID is one 63-bit number, most significant first:
+//   41 bits  milliseconds since TransactionIdEpochMillis
+//   10 bits  node id of the process (--node, default
+//            the lowest free one)
+//   12 bits  sequence within the millisecond
+// 1. The newest millisecond + sequence of the process is
+//    one atomic value advanced with compare-and-swap, so
+//    IDs from every thread are strictly increasing in
+//    the order they were taken, without a lock
+// 2. A used-up sequence or a clock stepping back borrows
+//    the next millisecond instead of waiting or repeating
+// 3. The text is TransactionIdPrefix + 19 zero-padded
+//    digits written with to_chars into a caller buffer;
+//    "TXS" sorts after the older "TXN" IDs, so text order
+//    is commit order for the ID-range checks of ledger
+//    segments
+// 4. A process owns its node id while it holds the lock
+//    of <Transactions>.node<N> (flock, or an unshared
+//    open on Windows); the lock ends with the process,
+//    so two processes never stamp the same node
+//=====================================================
+
+// Milliseconds since the transaction ID epoch
+uint64_t getTransactionIdMillis() {
+    long long millis = chrono::duration_cast<chrono::milliseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+    return millis > TransactionIdEpochMillis ? static_cast<uint64_t>(millis - TransactionIdEpochMillis) : 0;
+}
+// Parse a node id (0 to 2^TransactionIdNodeBits - 1), false if not a number in range
+bool parseTransactionNodeId(const string& text, uint32_t& nodeId) {
+    const char* end = text.data() + text.size();
+    return !text.empty() && from_chars(text.data(), end, nodeId).ptr == end &&
+        nodeId < (1u << TransactionIdNodeBits);
+}
+// Build the lock file name of a node id
+string getTransactionNodeLockFileName(uint32_t nodeId) {
+    return TransactionsFileName + TransactionNodeLockExtension + to_string(nodeId);
+}
+// Lock the file of a node without waiting, false if another process holds it
+bool lockTransactionNode(uint32_t nodeId) {
+    string fileName = getTransactionNodeLockFileName(nodeId);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    IdGenerator.NodeLock = file;
+#else
+    int fd = open(fileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        close(fd);
+        return false;
+    }
+    IdGenerator.NodeLock = fd;
+#endif
+    return true;
+}
+// Claim the node id stamped into this process's IDs: nodeId, or the lowest free one for NoTransactionNode.
+// False if that node (or every node) is locked by another process
+bool claimTransactionNode(uint32_t nodeId = NoTransactionNode) {
+    lock_guard<mutex> lock(IdGenerator.ClaimLock);
+    uint32_t current = IdGenerator.NodeId.load(memory_order_acquire);
+    if (current != NoTransactionNode) {
+        return nodeId == NoTransactionNode || nodeId == current;
+    }
+
+    uint32_t first = nodeId == NoTransactionNode ? 0 : nodeId;
+    uint32_t last = nodeId == NoTransactionNode ? (1u << TransactionIdNodeBits) - 1 : nodeId;
+    for (uint32_t candidate = first; candidate <= last; candidate++) {
+        if (lockTransactionNode(candidate)) {
+            IdGenerator.NodeId.store(candidate, memory_order_release);
+            logMessage("Transaction ID node " + to_string(candidate) + " claimed", INFO);
+            return true;
+        }
+    }
+    return false;
+}
+// Give up the node id and its lock (the next ID claims one again)
+void releaseTransactionNode() {
+    lock_guard<mutex> lock(IdGenerator.ClaimLock);
+#ifdef _WIN32
+    if (IdGenerator.NodeLock != INVALID_HANDLE_VALUE) {
+        CloseHandle(IdGenerator.NodeLock);
+    }
+    IdGenerator.NodeLock = INVALID_HANDLE_VALUE;
+#else
+    if (IdGenerator.NodeLock >= 0) {
+        close(IdGenerator.NodeLock);
+    }
+    IdGenerator.NodeLock = -1;
+#endif
+    IdGenerator.NodeId.store(NoTransactionNode, memory_order_release);
+}
+// Node id of this process, claiming the lowest free one on first use
+uint32_t getTransactionNodeId() {
+    uint32_t nodeId = IdGenerator.NodeId.load(memory_order_acquire);
+    if (nodeId != NoTransactionNode) {
+        return nodeId;
+    }
+    if (!claimTransactionNode()) {
+        throw runtime_error("No free transaction ID node: every " + TransactionsFileName +
+            TransactionNodeLockExtension + "<0-1023> lock is held");
+    }
+    return IdGenerator.NodeId.load(memory_order_acquire);
+}
+// Next 64-bit transaction ID of this process: strictly increasing across all threads
+uint64_t nextTransactionId() {
+    uint64_t now = getTransactionIdMillis() << TransactionIdSequenceBits;
+    uint64_t last = IdGenerator.Last.load(memory_order_relaxed);
+    uint64_t next;
+    do {
+        next = max(now, last + 1);
+    } while (!IdGenerator.Last.compare_exchange_weak(last, next, memory_order_relaxed));
+
+    if ((next >> TransactionIdSequenceBits) != (now >> TransactionIdSequenceBits)) {
+        IdGenerator.Borrowed.fetch_add(1, memory_order_relaxed);
+    }
+    uint64_t millis = next >> TransactionIdSequenceBits;
+    uint64_t sequence = next & ((1u << TransactionIdSequenceBits) - 1);
+    return (millis << (TransactionIdNodeBits + TransactionIdSequenceBits)) |
+        (static_cast<uint64_t>(getTransactionNodeId()) << TransactionIdSequenceBits) | sequence;
+}
+// Write the text of an ID into a buffer of at least TransactionIdTextSize chars, return the end
+char* writeTransactionId(char* buffer, uint64_t id) {
+    char digits[TransactionIdTextSize];
+    char* digitsEnd = to_chars(digits, digits + sizeof(digits), id).ptr;
+    size_t digitCount = static_cast<size_t>(digitsEnd - digits);
+
+    char* p = buffer;
+    memcpy(p, TransactionIdPrefix.data(), TransactionIdPrefix.size());
+    p += TransactionIdPrefix.size();
+    if (digitCount < TransactionIdDigits) {
+        memset(p, '0', TransactionIdDigits - digitCount);
+        p += TransactionIdDigits - digitCount;
+    }
+    memcpy(p, digits, digitCount);
+    return p + digitCount;
+}
+// Store a new transaction ID in id, reusing its buffer
+void assignTransactionID(string& id) {
+    char buffer[TransactionIdTextSize];
+    id.assign(buffer, writeTransactionId(buffer, nextTransactionId()));
+}
+// Generate unique transaction ID
+string generateTransactionID() {
+    char buffer[TransactionIdTextSize];
+    return string(buffer, writeTransactionId(buffer, nextTransactionId()));
+}
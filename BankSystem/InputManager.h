@@ -25,9 +25,9 @@ string readNonEmptyString(string s) {
     } while (line.empty());
     return line;
 }
-// Read a positive number input from user
-double readPositiveNumber(string prompt) {
-    double num = 0;
+// Read a positive money amount from user (exact cents)
+Money readPositiveAmount(string prompt) {
+    Money amount = 0;
     bool validInput = false;
 
     do {
@@ -35,22 +35,19 @@ double readPositiveNumber(string prompt) {
         string input;
         getline(cin, input);
 
-        stringstream ss(input);
-        if (ss >> num && num >= 0) {
-            char remaining;
-            if (ss >> remaining) {
-                showErrorMessage("Invalid input. Please enter a valid number.");
-            }
-            else {
-                validInput = true;
-            }
+        errc status = parseMoneyField(input, amount);
+        if (status != errc()) {
+            showErrorMessage("Invalid input. Please enter a valid number.");
         }
-        else {
+        else if (amount < 0) {
             showErrorMessage("Invalid input. Please enter a positive number.");
         }
+        else {
+            validInput = true;
+        }
     } while (!validInput);
 
-    return num;
+    return amount;
 }
 // Validate account number format (alphanumeric, specific length)
 bool isValidAccountNumber(const string& accountNumber) {
@@ -117,7 +114,7 @@ strClient readClientData(const string& AccountNumber) {
     Client.PinCode = readNonEmptyString("Enter PinCode? ");
     Client.Name = readNonEmptyString("Enter Name? ");
     Client.Phone = readValidatedPhoneNumber("Enter Phone? ");
-    Client.AccountBalance = readPositiveNumber("Enter AccountBalance? ");
+    Client.AccountBalance = readPositiveAmount("Enter AccountBalance? ");
     return Client;
 }
 // Read menu choice between given range or zero for return
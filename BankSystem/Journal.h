@@ -0,0 +1,291 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: Journal.h                                        ||
+//  || Section: Balance Journal                               ||
+//  || Append-only journal of balance changes, replayed on    ||
+//  || load and folded into Clients.txt on checkpoints.       ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Durability.h"
+#include "FileManager.h"
+#include "HashIndex.h"
+#include "ClientStore.h"
+
+//=====================================================
+//================== Balance Journal ==================
+// Deposits, withdrawals and transfers append one line
+// to <Clients>.journal instead of rewriting every client:
+// 1. Each operation is one checksummed journal record
+// 2. Loading the clients file replays the journal on top
+// 3. Every full save is a checkpoint: it records the last
+//    included sequence in <Clients>.ckpt, then truncates
+//    the journal
+//=====================================================
+
+// Build journal file name for a clients file
+string getJournalFileName(const string& clientsFileName) {
+    return clientsFileName + ".journal";
+}
+// Build checkpoint file name for a clients file
+string getCheckpointFileName(const string& clientsFileName) {
+    return clientsFileName + ".ckpt";
+}
+// Compute CRC-32 of a whole file (0 if missing)
+uint32_t computeFileCRC32(const string& fileName) {
+    ifstream file(fileName, ios::binary);
+    uint32_t crc = 0;
+    if (!file.is_open()) {
+        return crc;
+    }
+
+    vector<char> buffer(64 * 1024);
+    while (file) {
+        file.read(buffer.data(), buffer.size());
+        crc = computeCRC32(buffer.data(), static_cast<size_t>(file.gcount()), crc);
+    }
+    return crc;
+}
+// Check whether a file exists and has content
+bool fileHasContent(const string& fileName) {
+    ifstream file(fileName, ios::binary | ios::ate);
+    return file.is_open() && file.tellg() > 0;
+}
+// Convert journal entry to file line: Seq, TxnID, (Account, Delta)..., Checksum
+string serializeJournalRecord(long long sequence, const string& transactionID,
+    const vector<strJournalLeg>& legs, const string& separator = Separator) {
+    string payload = to_string(sequence) + separator + transactionID;
+    for (const strJournalLeg& leg : legs) {
+        payload += separator + leg.AccountNumber + separator + formatMoney(leg.Delta);
+    }
+    uint32_t checksum = computeCRC32(payload.data(), payload.size());
+    return payload + separator + formatHex32(checksum);
+}
+// Convert file line to journal entry, false if malformed or checksum mismatch.
+// transactionID and legs are assigned into, so a caller reusing them across lines reuses their buffers.
+bool deserializeJournalRecord(string_view line, long long& sequence, string& transactionID,
+    vector<strJournalLeg>& legs, string_view separator = Separator) {
+    size_t checksumPos = line.rfind(separator);
+    if (checksumPos == string_view::npos) {
+        return false;
+    }
+
+    string_view payload = line.substr(0, checksumPos);
+    string_view checksum = trimView(line.substr(checksumPos + separator.size()));
+    if (checksum != formatHex32(computeCRC32(payload.data(), payload.size()))) {
+        return false;
+    }
+
+    size_t fieldCount = 0;
+    bool valid = true;
+    forEachFieldView(payload, separator, [&](string_view field) {
+        size_t index = fieldCount++;
+        if (index == 0) {
+            string_view number = trimView(field);
+            valid = from_chars(number.data(), number.data() + number.size(), sequence).ptr == number.data() + number.size();
+            return;
+        }
+        if (index == 1) {
+            transactionID.assign(field.data(), field.size());
+            return;
+        }
+
+        size_t legIndex = (index - 2) / 2;
+        if (legs.size() <= legIndex) legs.resize(legIndex + 1);
+        if (index % 2 == 0) {
+            legs[legIndex].AccountNumber.assign(field.data(), field.size());
+        }
+        else if (parseMoneyField(field, legs[legIndex].Delta) != errc()) {
+            valid = false;
+        }
+    });
+    if (!valid || fieldCount < 4 || fieldCount % 2 != 0) {
+        return false;
+    }
+    legs.resize((fieldCount - 2) / 2);
+    return true;
+}
+// Read last checkpoint (sequence and clients file CRC), false if none
+bool readJournalCheckpoint(const string& clientsFileName, long long& sequence, uint32_t& fingerprint) {
+    ifstream file(getCheckpointFileName(clientsFileName));
+    string line;
+    if (!file.is_open() || !getline(file, line)) {
+        return false;
+    }
+
+    string_view fields[2];
+    if (splitFieldViews(line, Separator, fields, 2) < 2) {
+        return false;
+    }
+
+    string_view number = trimView(fields[0]);
+    string_view hex = trimView(fields[1]);
+    return from_chars(number.data(), number.data() + number.size(), sequence).ptr == number.data() + number.size() &&
+        from_chars(hex.data(), hex.data() + hex.size(), fingerprint, 16).ptr == hex.data() + hex.size();
+}
+// Record that the new clients file (still at tempFile) includes all journal entries
+bool writeJournalCheckpoint(const string& clientsFileName, const string& tempFile) {
+    string checkpointFile = getCheckpointFileName(clientsFileName);
+    string checkpointTemp = checkpointFile + ".tmp";
+
+    ofstream out(checkpointTemp, ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open checkpoint file for writing: " + checkpointTemp, ERROR_LOG);
+        return false;
+    }
+    out << JournalState.LastSequence << Separator << formatHex32(computeFileCRC32(tempFile)) << "\n";
+    out.close();
+    syncBeforeRename(checkpointTemp);
+
+#ifdef _WIN32
+    remove(checkpointFile.c_str());
+#endif
+
+    if (rename(checkpointTemp.c_str(), checkpointFile.c_str()) != 0) {
+        logMessage("Failed to rename checkpoint file: " + checkpointFile, ERROR_LOG);
+        return false;
+    }
+    syncAfterRename(checkpointFile);
+    return true;
+}
+// Truncate journal after its entries were folded into the clients file
+void truncateBalanceJournal(const string& clientsFileName) {
+    ofstream journal(getJournalFileName(getClientsDataFileName(clientsFileName)), ios::trunc);
+    JournalState.CheckpointSequence = JournalState.LastSequence;
+    JournalState.PendingEntries = 0;
+}
+// Append one balance change record; false if the journal could not be written
+bool appendBalanceJournal(const string& clientsFileName, const string& transactionID,
+    const vector<strJournalLeg>& legs) {
+    string record = serializeJournalRecord(JournalState.LastSequence + 1, transactionID, legs);
+
+    string journalFile = getJournalFileName(getClientsDataFileName(clientsFileName));
+    try {
+        appendLineToFile(journalFile, record);
+    }
+    catch (const exception& e) {
+        logMessage("Journal append failed: " + string(e.what()), ERROR_LOG);
+        return false;
+    }
+    // First record after a checkpoint may have created the file
+    noteDurableWrite(journalFile, JournalState.PendingEntries == 0);
+
+    JournalState.LastSequence++;
+    JournalState.PendingEntries++;
+    return true;
+}
+// Replay journal entries on top of freshly loaded clients
+void replayBalanceJournal(const string& clientsFileName, vector<strClient>& vClients) {
+    long long checkpointSequence = 0;
+    uint32_t checkpointFingerprint = 0;
+    bool hasCheckpoint = readJournalCheckpoint(clientsFileName, checkpointSequence, checkpointFingerprint);
+
+    JournalState = strJournalState();
+    JournalState.LastSequence = checkpointSequence;
+    JournalState.CheckpointSequence = checkpointSequence;
+
+    string journalFile = getJournalFileName(clientsFileName);
+    if (!fileHasContent(journalFile)) {
+        return;
+    }
+
+    // Records are views into the file content; one ID and leg vector are reused for every line
+    string content;
+    if (!readFileToString(journalFile, content)) {
+        return;
+    }
+    vector<string_view> records;
+    records.reserve(countLines(content));
+    long long sequence = 0;
+    string transactionID;
+    vector<strJournalLeg> legs;
+    int corruptRecords = 0;
+    bool hasStaleRecords = false;
+
+    forEachLine(content, [&](string_view line) {
+        if (trimView(line).empty()) return;
+
+        if (!deserializeJournalRecord(line, sequence, transactionID, legs)) {
+            corruptRecords++;
+            logMessage("Skipped corrupt journal record: " + string(line), WARNING);
+            return;
+        }
+        if (sequence <= checkpointSequence) {
+            hasStaleRecords = true;
+        }
+        records.push_back(line);
+    });
+
+    // Stale records survive only if a crash hit between checkpoint rename and journal
+    // truncation; they are already folded in when the file still matches the checkpoint
+    bool skipStale = hasStaleRecords && hasCheckpoint &&
+        computeFileCRC32(clientsFileName) == checkpointFingerprint;
+
+    vector<string_view> keptRecords;
+    int appliedRecords = 0;
+    for (string_view record : records) {
+        deserializeJournalRecord(record, sequence, transactionID, legs);
+
+        if (sequence > JournalState.LastSequence) {
+            JournalState.LastSequence = sequence;
+        }
+        if (skipStale && sequence <= checkpointSequence) {
+            continue;
+        }
+
+        for (const strJournalLeg& leg : legs) {
+            strClient* client = findInHashIndex(ClientIndex, vClients, leg.AccountNumber);
+            if (client == nullptr) {
+                logMessage("Journal record " + transactionID + " references unknown account: " +
+                    leg.AccountNumber, WARNING);
+                continue;
+            }
+            client->AccountBalance += leg.Delta;
+        }
+        keptRecords.push_back(record);
+        appliedRecords++;
+    }
+    JournalState.PendingEntries = appliedRecords;
+
+    if (skipStale) {
+        ofstream rewritten(journalFile, ios::trunc);
+        for (string_view record : keptRecords) {
+            rewritten << record << "\n";
+        }
+        logMessage("Discarded journal records already included in checkpoint", WARNING);
+    }
+
+    logMessage("Replayed " + formatInt(appliedRecords) + " journal records (" +
+        formatInt(corruptRecords) + " corrupt)", INFO);
+}
+// Persist a balance change: journal append, periodic checkpoint, full save as fallback
+void commitBalanceChange(vector<strClient>& vClients, const string& transactionID,
+    const vector<strJournalLeg>& legs) {
+    strMetricTimer timer(METRIC_BALANCE_COMMIT);
+    if (ClientFile.Format == CLIENTS_BINARY) {
+        commitBinaryBalanceChange(vClients, transactionID, legs);
+        return;
+    }
+    bool wasCurrent = isClientStoreCurrent(ClientsFileName, vClients);
+    bool journaled = appendBalanceJournal(ClientsFileName, transactionID, legs);
+
+    // The posting's ledger line and journal record reach the disk together (per Durability.Mode)
+    commitDurableWrites();
+    if (!journaled) {
+        saveClientsToFile(ClientsFileName, vClients);
+        return;
+    }
+    if (wasCurrent) {
+        markClientStoreSynced(ClientsFileName, vClients);
+    }
+
+    if (JournalState.PendingEntries >= JournalCheckpointInterval) {
+        logMessage("Journal checkpoint after " + formatInt(JournalState.PendingEntries) + " records", INFO);
+        saveClientsToFile(ClientsFileName, vClients);
+    }
+}
@@ -0,0 +1,575 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: Ledger.h                                         ||
+//  || Section: Segmented Ledger                              ||
+//  || Transactions ledger split into size-rotated segments   ||
+//  || with a manifest of sealed segments and their ranges.   ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Durability.h"
+#include "FileManager.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+//=====================================================
+//================= Segmented Ledger ==================
+// The ledger <Transactions> is stored as segment files
+// <Transactions>.000001, .000002, ... that together form
+// one logical file (segment N starts at the byte where
+// segment N-1 ends):
+// 1. Records are appended to the active (last) segment
+// 2. A segment that reaches LedgerSegmentMaxBytes is
+//    sealed: its record count, time range and ID range go
+//    into <Transactions>.manifest and it is never written
+//    again
+// 3. Queries (LedgerView.h) skip sealed segments whose
+//    ranges cannot match
+// 4. An existing single-file ledger is split into
+//    segments on first open and kept as <Transactions>.bak
+//    (.bak.1, ... if an older backup exists). A single
+//    file that holds records the segments lack (written
+//    by an older version after the migration) stops the
+//    program instead
+// 5. Tellers run as separate processes: appends, seals
+//    and the migration hold <Transactions>.lock, and the
+//    manifest is read again when another process changed
+//    it, so every process appends to the same segment
+//=====================================================
+
+// Build manifest file name for a ledger
+string getLedgerManifestFileName(const string& ledgerFileName) {
+    return ledgerFileName + ".manifest";
+}
+// Build lock file name for a ledger
+string getLedgerLockFileName(const string& ledgerFileName) {
+    return ledgerFileName + LedgerLockExtension;
+}
+// Build segment file name for a ledger
+string getLedgerSegmentFileName(const string& ledgerFileName, int number) {
+    ostringstream name;
+    name << ledgerFileName << "." << setw(6) << setfill('0') << number;
+    return name.str();
+}
+// Convert sealed segment to manifest line
+string serializeLedgerSegment(const strLedgerSegment& segment, const string& separator = Separator) {
+    return formatInt(segment.Number) + separator +
+        to_string(segment.BaseOffset) + separator +
+        to_string(segment.Bytes) + separator +
+        to_string(segment.Records) + separator +
+        segment.FirstTimestamp + separator +
+        segment.LastTimestamp + separator +
+        segment.MinTransactionID + separator +
+        segment.MaxTransactionID;
+}
+// Convert manifest line to sealed segment, false if malformed
+bool deserializeLedgerSegment(string_view line, const string& ledgerFileName, strLedgerSegment& segment,
+    string_view separator = Separator) {
+    string_view fields[8];
+    if (splitFieldViews(line, separator, fields, 8) < 8) {
+        return false;
+    }
+
+    if (parseIntField(fields[0], segment.Number) != errc()) return false;
+    const char* end = fields[1].data() + fields[1].size();
+    if (from_chars(fields[1].data(), end, segment.BaseOffset).ptr != end) return false;
+    end = fields[2].data() + fields[2].size();
+    if (from_chars(fields[2].data(), end, segment.Bytes).ptr != end) return false;
+    end = fields[3].data() + fields[3].size();
+    if (from_chars(fields[3].data(), end, segment.Records).ptr != end) return false;
+
+    segment.FirstTimestamp = trimView(fields[4]);
+    segment.LastTimestamp = trimView(fields[5]);
+    segment.MinTransactionID = trimView(fields[6]);
+    segment.MaxTransactionID = trimView(fields[7]);
+    segment.FileName = getLedgerSegmentFileName(ledgerFileName, segment.Number);
+    segment.Sealed = true;
+    return true;
+}
+// Extend segment ranges with one record
+void addToSegmentStats(strLedgerSegment& segment, const Transaction& txn) {
+    if (segment.Records == 0) {
+        segment.FirstTimestamp = segment.LastTimestamp = txn.Timestamp;
+        segment.MinTransactionID = segment.MaxTransactionID = txn.TransactionID;
+    }
+    else {
+        segment.FirstTimestamp = min(segment.FirstTimestamp, txn.Timestamp);
+        segment.LastTimestamp = max(segment.LastTimestamp, txn.Timestamp);
+        segment.MinTransactionID = min(segment.MinTransactionID, txn.TransactionID);
+        segment.MaxTransactionID = max(segment.MaxTransactionID, txn.TransactionID);
+    }
+    segment.Records++;
+}
+// Recompute size and ranges of a segment from its records
+void computeSegmentStats(strLedgerSegment& segment, string_view content) {
+    segment.Bytes = static_cast<long long>(content.size());
+    segment.Records = 0;
+
+    string error;
+    forEachLine(content, [&](string_view line) {
+        Transaction txn;
+        if (!line.empty() && parseTransactionRecord(line, txn, error)) {
+            addToSegmentStats(segment, txn);
+        }
+    });
+}
+// Write manifest of sealed segments (tmp, then rename)
+bool writeLedgerManifest(const string& ledgerFileName) {
+    string manifestFile = getLedgerManifestFileName(ledgerFileName);
+    string tempFile = manifestFile + ".tmp";
+
+    ofstream out(tempFile, ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open ledger manifest for writing: " + tempFile, ERROR_LOG);
+        return false;
+    }
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        if (segment.Sealed) {
+            out << serializeLedgerSegment(segment) << "\n";
+        }
+    }
+    out.close();
+    if (out.fail()) {
+        logMessage("Failed to write ledger manifest: " + tempFile, ERROR_LOG);
+        remove(tempFile.c_str());
+        return false;
+    }
+    syncBeforeRename(tempFile);
+
+#ifdef _WIN32
+    remove(manifestFile.c_str());
+#endif
+
+    if (rename(tempFile.c_str(), manifestFile.c_str()) != 0) {
+        logMessage("Failed to rename ledger manifest: " + manifestFile, ERROR_LOG);
+        return false;
+    }
+    syncAfterRename(manifestFile);
+    // Written under the ledger lock, so no other process changed it in between
+    Ledger.ManifestStamp = readFileStamp(manifestFile);
+    return true;
+}
+// Split a single-file ledger into segments at line boundaries, each synced to disk; false if any write fails
+bool migrateSingleFileLedger(const string& ledgerFileName) {
+    // Mapped, so a ledger of any size is split without reading it into memory
+    strMappedFile mapped;
+    if (!mapFileReadOnly(ledgerFileName, mapped, true)) {
+        logMessage("Cannot read ledger for migration: " + ledgerFileName, ERROR_LOG);
+        return false;
+    }
+
+    string_view contentView(mapped.Data, mapped.Size);
+    size_t begin = 0;
+    while (begin < contentView.size()) {
+        size_t end = contentView.size();
+        if (static_cast<long long>(end - begin) > LedgerSegmentMaxBytes) {
+            // Cut after the last full line that fits (or after one oversized line)
+            size_t newline = contentView.rfind('\n', begin + LedgerSegmentMaxBytes - 1);
+            if (newline == string_view::npos || newline < begin) {
+                newline = contentView.find('\n', begin);
+            }
+            end = (newline == string_view::npos) ? contentView.size() : newline + 1;
+        }
+
+        strLedgerSegment segment;
+        segment.Number = static_cast<int>(Ledger.Segments.size()) + 1;
+        segment.FileName = getLedgerSegmentFileName(ledgerFileName, segment.Number);
+        segment.BaseOffset = static_cast<long long>(begin);
+        computeSegmentStats(segment, contentView.substr(begin, end - begin));
+        segment.Sealed = (end < contentView.size());
+
+        ofstream out(segment.FileName, ios::binary | ios::trunc);
+        out.write(contentView.data() + begin, end - begin);
+        out.close();
+        if (out.fail() || !syncFileToDisk(segment.FileName, false)) {
+            logMessage("Failed to write ledger segment during migration: " + segment.FileName, CRITICAL);
+            unmapFile(mapped);
+            return false;
+        }
+        Ledger.Segments.push_back(segment);
+        begin = end;
+    }
+    unmapFile(mapped);
+
+    logMessage("Migrated ledger " + ledgerFileName + " into " +
+        formatInt(static_cast<int>(Ledger.Segments.size())) + " segments", INFO);
+    return true;
+}
+// Add an empty active segment after the last one
+void startActiveSegment(const string& ledgerFileName) {
+    strLedgerSegment active;
+    if (!Ledger.Segments.empty()) {
+        const strLedgerSegment& last = Ledger.Segments.back();
+        active.Number = last.Number + 1;
+        active.BaseOffset = last.BaseOffset + last.Bytes;
+    }
+    else {
+        active.Number = 1;
+    }
+    active.FileName = getLedgerSegmentFileName(ledgerFileName, active.Number);
+    Ledger.Segments.push_back(active);
+}
+// Read the sealed segments from the manifest, false if there is none
+bool readLedgerManifest(const string& ledgerFileName) {
+    string manifestFile = getLedgerManifestFileName(ledgerFileName);
+    // Stamp first: a seal that lands while the file is read is seen by the next refresh
+    Ledger.ManifestStamp = readFileStamp(manifestFile);
+    Ledger.Segments.clear();
+
+    ifstream manifest(manifestFile);
+    if (!manifest.is_open()) {
+        return false;
+    }
+    string line;
+    while (getline(manifest, line)) {
+        if (trimView(line).empty()) continue;
+
+        strLedgerSegment segment;
+        if (!deserializeLedgerSegment(line, ledgerFileName, segment)) {
+            logMessage("Skipped invalid ledger manifest line: " + line, ERROR_LOG);
+            continue;
+        }
+        if (getFileSize(segment.FileName) != segment.Bytes) {
+            logMessage("Sealed ledger segment changed size: " + segment.FileName, WARNING);
+        }
+        Ledger.Segments.push_back(segment);
+    }
+    return true;
+}
+// Add the active segment after the sealed ones if needed and scan its records
+void scanActiveSegment(const string& ledgerFileName) {
+    if (Ledger.Segments.empty() || Ledger.Segments.back().Sealed) {
+        startActiveSegment(ledgerFileName);
+    }
+
+    strLedgerSegment& active = Ledger.Segments.back();
+    strMappedFile mapped;
+    if (mapFileReadOnly(active.FileName, mapped, true)) {
+        computeSegmentStats(active, string_view(mapped.Data, mapped.Size));
+        unmapFile(mapped);
+    }
+}
+// True if a file holds the first bytes of the segmented ledger, i.e. it is the original of a migration
+bool isLedgerPrefix(const string& fileName) {
+    strMappedFile original;
+    if (!mapFileReadOnly(fileName, original, true)) {
+        return false;
+    }
+
+    size_t position = 0;
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        strMappedFile mapped;
+        if (position == original.Size || !mapFileReadOnly(segment.FileName, mapped, true)) {
+            break;
+        }
+        size_t length = min(mapped.Size, original.Size - position);
+        bool same = memcmp(mapped.Data, original.Data + position, length) == 0;
+        unmapFile(mapped);
+        if (!same) {
+            break;
+        }
+        position += length;
+    }
+    bool prefix = (position == original.Size);
+    unmapFile(original);
+    return prefix;
+}
+// First backup name of the single-file ledger that is not taken (.bak, .bak.1, ...)
+string getFreeLedgerBackupFileName(const string& ledgerFileName) {
+    string backupFile = ledgerFileName + ".bak";
+    for (int number = 1; getFileSize(backupFile) >= 0; number++) {
+        backupFile = ledgerFileName + ".bak." + to_string(number);
+    }
+    return backupFile;
+}
+// Move the migrated single-file ledger to a new backup; throw if it holds records the segments lack
+void backupMigratedLedger(const string& ledgerFileName) {
+    if (!isLedgerPrefix(ledgerFileName)) {
+        logMessage("Ledger " + ledgerFileName + " has records that are not in its segments (written after the "
+            "migration by an older version?); append them to " + Ledger.Segments.back().FileName +
+            " or move the file away before starting", CRITICAL);
+        throw runtime_error("Ledger has records outside its segments: " + ledgerFileName);
+    }
+
+    string backupFile = getFreeLedgerBackupFileName(ledgerFileName);
+    if (rename(ledgerFileName.c_str(), backupFile.c_str()) != 0) {
+        logMessage("Failed to move migrated ledger to backup: " + ledgerFileName, WARNING);
+    }
+    else {
+        logMessage("Single-file ledger kept as backup: " + backupFile, INFO);
+    }
+}
+// Load manifest and active segment, migrating a single-file ledger once (under the ledger lock)
+void loadLedger(const string& ledgerFileName) {
+    string manifestFile = getLedgerManifestFileName(ledgerFileName);
+    if (!readLedgerManifest(ledgerFileName)) {
+        // Segments reach the disk before the manifest that commits them, and the manifest before the old file moves
+        bool migrated = !fileHasContent(ledgerFileName) || migrateSingleFileLedger(ledgerFileName);
+        if (!migrated || !writeLedgerManifest(ledgerFileName) || !syncFileToDisk(manifestFile, false) ||
+            !syncFolderToDisk(manifestFile)) {
+            logMessage("Ledger migration failed, " + ledgerFileName + " left as it was", CRITICAL);
+            throw runtime_error("Failed to migrate ledger to segments: " + ledgerFileName);
+        }
+    }
+    scanActiveSegment(ledgerFileName);
+
+    // The manifest is the commit point of a migration; the old file is only a backup now
+    if (fileHasContent(ledgerFileName)) {
+        backupMigratedLedger(ledgerFileName);
+    }
+}
+// True while this process holds the ledger lock
+bool isLedgerLocked() {
+#ifdef _WIN32
+    return Ledger.Lock != INVALID_HANDLE_VALUE;
+#else
+    return Ledger.Lock >= 0;
+#endif
+}
+// Take the ledger lock file (nested calls only count; the outermost one waits for other processes)
+void lockLedgerFile(const string& ledgerFileName) {
+    if (Ledger.LockDepth++ > 0) {
+        return;
+    }
+
+    string lockFileName = getLedgerLockFileName(ledgerFileName);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(lockFileName.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    OVERLAPPED overlapped = {};
+    if (file != INVALID_HANDLE_VALUE && !LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped)) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+    Ledger.Lock = file;
+#else
+    int fd = open(lockFileName.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd >= 0 && flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    Ledger.Lock = fd;
+#endif
+    if (!isLedgerLocked()) {
+        logMessage("Failed to lock ledger: " + lockFileName, ERROR_LOG);
+    }
+}
+// Release one level of the ledger lock; the outermost release lets other processes in
+void unlockLedger() {
+    if (Ledger.LockDepth == 0 || --Ledger.LockDepth > 0) {
+        return;
+    }
+#ifdef _WIN32
+    if (Ledger.Lock != INVALID_HANDLE_VALUE) {
+        CloseHandle(Ledger.Lock);
+    }
+    Ledger.Lock = INVALID_HANDLE_VALUE;
+#else
+    if (Ledger.Lock >= 0) {
+        close(Ledger.Lock);
+    }
+    Ledger.Lock = -1;
+#endif
+}
+// Forget the open ledger; the next use reads the manifest again (not while the ledger lock is held)
+void closeLedger() {
+    Ledger = strLedger();
+}
+// Open ledger once per process: load manifest, scan active segment, migrate a single-file ledger
+void openLedger(const string& ledgerFileName) {
+    if (Ledger.LedgerFile == ledgerFileName) {
+        return;
+    }
+
+    closeLedger();
+    Ledger.LedgerFile = ledgerFileName;
+    // Another process may be migrating or sealing right now
+    lockLedgerFile(ledgerFileName);
+    try {
+        loadLedger(ledgerFileName);
+    }
+    catch (...) {
+        unlockLedger();
+        closeLedger();
+        throw;
+    }
+    unlockLedger();
+}
+// Catch up with segments other processes sealed since the manifest was read
+void refreshLedger(const string& ledgerFileName) {
+    openLedger(ledgerFileName);
+    if (sameFileStamp(Ledger.ManifestStamp, readFileStamp(getLedgerManifestFileName(ledgerFileName)))) {
+        return;
+    }
+    readLedgerManifest(ledgerFileName);
+    scanActiveSegment(ledgerFileName);
+}
+// Add the records other processes appended to the active segment since this one last wrote it
+void readActiveSegmentTail() {
+    strLedgerSegment& active = Ledger.Segments.back();
+    long long size = getFileSize(active.FileName);
+    if (size <= active.Bytes) {
+        return;
+    }
+
+    strMappedFile mapped;
+    if (!mapFileReadOnly(active.FileName, mapped, true)) {
+        return;
+    }
+    string error;
+    size_t begin = static_cast<size_t>(min<long long>(active.Bytes, static_cast<long long>(mapped.Size)));
+    forEachLine(string_view(mapped.Data + begin, mapped.Size - begin), [&](string_view line) {
+        Transaction txn;
+        if (!line.empty() && parseTransactionRecord(line, txn, error)) {
+            addToSegmentStats(active, txn);
+        }
+    });
+    active.Bytes = static_cast<long long>(mapped.Size);
+    unmapFile(mapped);
+}
+// Take the ledger lock (re-entrant) and catch up with other processes; every append and seal runs under it
+void lockLedger(const string& ledgerFileName) {
+    openLedger(ledgerFileName);
+    lockLedgerFile(ledgerFileName);
+    refreshLedger(ledgerFileName);
+    readActiveSegmentTail();
+}
+// Holds the ledger lock for a scope
+struct strLedgerLock {
+    explicit strLedgerLock(const string& ledgerFileName) { lockLedger(ledgerFileName); }
+    ~strLedgerLock() { unlockLedger(); }
+};
+// Active segment of the open ledger (always the last one)
+strLedgerSegment& getActiveSegment(const string& ledgerFileName) {
+    openLedger(ledgerFileName);
+    return Ledger.Segments.back();
+}
+// Seal the active segment and start the next one (under the ledger lock)
+void sealActiveSegment(const string& ledgerFileName) {
+    strLedgerSegment& active = getActiveSegment(ledgerFileName);
+    active.Sealed = true;
+    if (!writeLedgerManifest(ledgerFileName)) {
+        active.Sealed = false;
+        return;
+    }
+
+    logMessage("Sealed ledger segment " + active.FileName + " (" + to_string(active.Records) + " records)", INFO);
+    startActiveSegment(ledgerFileName);
+}
+// Logical size of the ledger: end of the active segment
+long long getLedgerSize(const string& ledgerFileName) {
+    refreshLedger(ledgerFileName);
+    strLedgerSegment& active = Ledger.Segments.back();
+    active.Bytes = max(0LL, getFileSize(active.FileName));
+    return active.BaseOffset + active.Bytes;
+}
+// Append one record line, rotating first if the active segment is full; returns logical offsets
+void appendLedgerRecord(const string& ledgerFileName, const Transaction& transaction, const string& line,
+    long long& offset, long long& nextOffset) {
+    strLedgerLock lock(ledgerFileName);
+    strLedgerSegment* active = &getActiveSegment(ledgerFileName);
+    active->Bytes = max(0LL, getFileSize(active->FileName));
+
+    if (active->Records > 0 && active->Bytes + static_cast<long long>(line.size()) + 1 > LedgerSegmentMaxBytes) {
+        sealActiveSegment(ledgerFileName);
+        active = &Ledger.Segments.back();
+    }
+
+    offset = active->BaseOffset + active->Bytes;
+    appendLineToFile(active->FileName, line);
+    noteDurableWrite(active->FileName, active->Bytes == 0);
+
+    active->Bytes = max(0LL, getFileSize(active->FileName));
+    nextOffset = active->BaseOffset + active->Bytes;
+    addToSegmentStats(*active, transaction);
+}
+// Append many serialized lines with one write per segment; offsets gets every line start plus the end
+void appendLedgerRecords(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<string>& lines, vector<long long>& offsets) {
+    strLedgerLock lock(ledgerFileName);
+    offsets.clear();
+    offsets.reserve(lines.size() + 1);
+    size_t next = 0;
+
+    while (next < lines.size()) {
+        strLedgerSegment* active = &getActiveSegment(ledgerFileName);
+        active->Bytes = max(0LL, getFileSize(active->FileName));
+
+        if (active->Records > 0 && active->Bytes + static_cast<long long>(lines[next].size()) + 1 > LedgerSegmentMaxBytes) {
+            sealActiveSegment(ledgerFileName);
+            active = &Ledger.Segments.back();
+        }
+
+        // Take every line that still fits, and always at least one
+        string block;
+        long long blockEnd = active->Bytes;
+        size_t end = next;
+        while (end < lines.size() &&
+            (end == next || blockEnd + static_cast<long long>(lines[end].size()) + 1 <= LedgerSegmentMaxBytes)) {
+            offsets.push_back(active->BaseOffset + blockEnd);
+            block += lines[end];
+            block += '\n';
+            blockEnd += static_cast<long long>(lines[end].size()) + 1;
+            end++;
+        }
+
+        ofstream out(active->FileName, ios::binary | ios::app);
+        if (!out.is_open()) {
+            throw runtime_error("Cannot open file: " + active->FileName);
+        }
+        out << block;
+        out.close();
+        if (out.fail()) {
+            throw runtime_error("Failed to write to file: " + active->FileName);
+        }
+        noteDurableWrite(active->FileName, active->Bytes == 0);
+
+        active->Bytes = max(0LL, getFileSize(active->FileName));
+        for (size_t i = next; i < end; i++) {
+            addToSegmentStats(*active, transactions[i]);
+        }
+        next = end;
+    }
+    offsets.push_back(getLedgerSize(ledgerFileName));
+}
+// Index of the segment holding a logical offset
+size_t findLedgerSegment(long long offset) {
+    size_t low = 0, high = Ledger.Segments.size();
+    while (high - low > 1) {
+        size_t middle = (low + high) / 2;
+        if (Ledger.Segments[middle].BaseOffset <= offset) low = middle;
+        else high = middle;
+    }
+    return low;
+}
+// Read the ledger line starting at a logical offset (trailing '\r' stripped)
+bool readLedgerLine(strLedgerReader& reader, const string& ledgerFileName, long long offset, string& line) {
+    openLedger(ledgerFileName);
+    if (Ledger.Segments.empty()) {
+        return false;
+    }
+
+    int segmentIndex = static_cast<int>(findLedgerSegment(offset));
+    const strLedgerSegment& segment = Ledger.Segments[segmentIndex];
+    if (reader.Segment != segmentIndex) {
+        reader.File.close();
+        reader.File.open(segment.FileName, ios::binary);
+        reader.Segment = segmentIndex;
+    }
+
+    reader.File.clear();
+    reader.File.seekg(offset - segment.BaseOffset);
+    if (!getline(reader.File, line)) {
+        return false;
+    }
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
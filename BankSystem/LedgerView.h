@@ -0,0 +1,249 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: LedgerView.h                                     ||
+//  || Section: Ledger View                                   ||
+//  || Read-only memory-mapped view of the ledger segments,   ||
+//  || walked record by record without loading them.          ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "FileManager.h"
+#include "Ledger.h"
+
+//=====================================================
+//==================== Ledger View ====================
+// Reading the ledger does not build a vector<Transaction>
+// with eight strings per record:
+// 1. openLedgerView() lists the segments; each segment
+//    file is mapped read-only on first use, so the OS
+//    pages it in and out and memory use does not grow
+//    with the ledger (no file size limit)
+// 2. A cursor walks the lines; nextLedgerRecord() parses
+//    each into a strTransactionView whose text fields are
+//    string_views into the mapping
+// 3. Only records a caller keeps are copied into a
+//    Transaction (toTransaction)
+// The view is a snapshot of the segments when they were
+// mapped: later appends are not seen. Views are closed
+// by closeLedgerView(), which releases the mappings.
+//=====================================================
+
+// Release every mapping of a view
+void closeLedgerView(strLedgerView& view) {
+    for (strLedgerViewSegment& segment : view.Segments) {
+        unmapFile(segment.File);
+    }
+    view = strLedgerView();
+}
+// Open a view of the ledger's segments (sequential = mostly front-to-back scans)
+void openLedgerView(const string& ledgerFileName, strLedgerView& view, bool sequential = false) {
+    closeLedgerView(view);
+    refreshLedger(ledgerFileName);
+    view.Sequential = sequential;
+    view.Segments.reserve(Ledger.Segments.size());
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        strLedgerViewSegment viewSegment;
+        viewSegment.Segment = segment;
+        view.Segments.push_back(viewSegment);
+    }
+}
+// Map a view segment on first use; false if it has no complete line
+bool mapLedgerViewSegment(strLedgerView& view, size_t index) {
+    strLedgerViewSegment& segment = view.Segments[index];
+    if (!segment.Mapped) {
+        segment.Mapped = true;
+        if (mapFileReadOnly(segment.Segment.FileName, segment.File, view.Sequential)) {
+            view.MappedSegments++;
+
+            // A last line without newline is still being written (or torn); leave it out
+            size_t bytes = segment.File.Size;
+            while (bytes > 0 && segment.File.Data[bytes - 1] != '\n') bytes--;
+            segment.Bytes = bytes;
+        }
+    }
+    return segment.Bytes > 0;
+}
+// Cursor at a logical ledger offset
+strLedgerCursor seekLedgerCursor(const strLedgerView& view, long long offset) {
+    strLedgerCursor cursor;
+    size_t low = 0, high = view.Segments.size();
+    while (high - low > 1) {
+        size_t middle = (low + high) / 2;
+        if (view.Segments[middle].Segment.BaseOffset <= offset) low = middle;
+        else high = middle;
+    }
+    if (low < view.Segments.size()) {
+        cursor.Segment = low;
+        cursor.Position = static_cast<size_t>(max(0LL, offset - view.Segments[low].Segment.BaseOffset));
+    }
+    return cursor;
+}
+// Read the line at the cursor and move past it (trailing '\r' stripped); false at the end of the view
+bool nextLedgerLine(strLedgerView& view, strLedgerCursor& cursor, long long& offset, long long& nextOffset,
+    string_view& line) {
+    while (cursor.Segment < min(view.Segments.size(), cursor.EndSegment)) {
+        if (!mapLedgerViewSegment(view, cursor.Segment) || cursor.Position >= view.Segments[cursor.Segment].Bytes) {
+            cursor.Segment++;
+            cursor.Position = 0;
+            continue;
+        }
+
+        const strLedgerViewSegment& segment = view.Segments[cursor.Segment];
+        const char* start = segment.File.Data + cursor.Position;
+        const char* newline = static_cast<const char*>(memchr(start, '\n', segment.Bytes - cursor.Position));
+
+        offset = segment.Segment.BaseOffset + static_cast<long long>(cursor.Position);
+        line = string_view(start, newline - start);
+        cursor.Position += line.size() + 1;
+        nextOffset = segment.Segment.BaseOffset + static_cast<long long>(cursor.Position);
+
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return true;
+    }
+    return false;
+}
+// Read the line starting at a logical offset, false if outside the view
+bool readLedgerViewLine(strLedgerView& view, long long offset, string_view& line) {
+    strLedgerCursor cursor = seekLedgerCursor(view, offset);
+    if (cursor.Segment >= view.Segments.size() || !mapLedgerViewSegment(view, cursor.Segment) ||
+        cursor.Position >= view.Segments[cursor.Segment].Bytes) {
+        return false;
+    }
+    long long lineOffset, nextOffset;
+    return nextLedgerLine(view, cursor, lineOffset, nextOffset, line);
+}
+// Parse a ledger line into a view of its fields, error explains a failure
+bool parseTransactionView(string_view line, strTransactionView& record, string& error,
+    string_view separator = Separator) {
+    string_view fields[8];
+    size_t fieldCount = splitFieldViews(line, separator, fields, 8);
+    if (fieldCount < 8) {
+        error = "Invalid transaction record: expected 8 fields, got " + formatInt(fieldCount);
+        return false;
+    }
+
+    int type = 0;
+    errc status = parseIntField(fields[1], type);
+    if (status == errc()) status = parseMoneyField(fields[4], record.Amount);
+    if (status == errc()) status = parseMoneyField(fields[5], record.Fees);
+    if (status != errc()) {
+        error = (status == errc::result_out_of_range ? "Transaction value out of range: " :
+            "Invalid transaction data format: ") + string(line);
+        return false;
+    }
+
+    record.TransactionID = trimView(fields[0]);
+    record.Type = static_cast<TransactionType>(type);
+    record.FromAccount = trimView(fields[2]);
+    record.ToAccount = trimView(fields[3]);
+    record.Timestamp = trimView(fields[6]);
+    record.Description = trimView(fields[7]);
+    return true;
+}
+// Copy a record view into a Transaction
+Transaction toTransaction(const strTransactionView& record) {
+    Transaction txn;
+    txn.TransactionID = record.TransactionID;
+    txn.Type = record.Type;
+    txn.FromAccount = record.FromAccount;
+    txn.ToAccount = record.ToAccount;
+    txn.Amount = record.Amount;
+    txn.Fees = record.Fees;
+    txn.Timestamp = record.Timestamp;
+    txn.Description = record.Description;
+    return txn;
+}
+// Parse the next record at the cursor, skipping blank and invalid lines; false at the end of the view
+bool nextLedgerRecord(strLedgerView& view, strLedgerCursor& cursor, strTransactionView& record) {
+    string_view line;
+    string error;
+    while (nextLedgerLine(view, cursor, record.Offset, record.NextOffset, line)) {
+        if (trimView(line).empty()) continue;
+        if (parseTransactionView(line, record, error)) {
+            return true;
+        }
+        logMessage(error, ERROR_LOG);
+    }
+    return false;
+}
+// Call recordHandler(record) for every record of one view segment
+template <typename RecordHandler>
+void forEachSegmentRecord(strLedgerView& view, size_t index, RecordHandler recordHandler) {
+    strLedgerCursor cursor;
+    cursor.Segment = index;
+    cursor.EndSegment = index + 1;
+    strTransactionView record;
+    while (nextLedgerRecord(view, cursor, record)) {
+        recordHandler(record);
+    }
+}
+// Call lineHandler(offset, nextOffset, line) for every complete ledger line from a logical offset
+template <typename LineHandler>
+void forEachLedgerLine(const string& ledgerFileName, long long startOffset, LineHandler lineHandler) {
+    strLedgerView view;
+    openLedgerView(ledgerFileName, view, true);
+
+    strLedgerCursor cursor = seekLedgerCursor(view, startOffset);
+    long long offset, nextOffset;
+    string_view line;
+    while (nextLedgerLine(view, cursor, offset, nextOffset, line)) {
+        lineHandler(offset, nextOffset, line);
+    }
+    closeLedgerView(view);
+}
+// Load ledger records with fromTimestamp <= Timestamp <= toTimestamp ("" = open end); only matches are copied
+vector<Transaction> loadLedgerTransactions(const string& ledgerFileName,
+    const string& fromTimestamp = "", const string& toTimestamp = "") {
+    strLedgerView view;
+    openLedgerView(ledgerFileName, view, true);
+    vector<Transaction> transactions;
+
+    for (size_t i = 0; i < view.Segments.size(); i++) {
+        const strLedgerSegment& segment = view.Segments[i].Segment;
+        if (segment.Records == 0 && segment.Sealed) continue;
+        if (segment.Sealed && !fromTimestamp.empty() && segment.LastTimestamp < fromTimestamp) continue;
+        if (segment.Sealed && !toTimestamp.empty() && segment.FirstTimestamp > toTimestamp) continue;
+
+        forEachSegmentRecord(view, i, [&](const strTransactionView& record) {
+            if (!fromTimestamp.empty() && record.Timestamp < fromTimestamp) return;
+            if (!toTimestamp.empty() && record.Timestamp > toTimestamp) return;
+            transactions.push_back(toTransaction(record));
+        });
+    }
+    closeLedgerView(view);
+    return transactions;
+}
+// Find a ledger record by ID, searching only segments whose ID range contains it; lines are parsed only on a match
+bool findLedgerTransaction(const string& ledgerFileName, const string& transactionID, Transaction& found) {
+    strLedgerView view;
+    openLedgerView(ledgerFileName, view, true);
+    bool matched = false;
+
+    for (size_t i = 0; i < view.Segments.size() && !matched; i++) {
+        const strLedgerSegment& segment = view.Segments[i].Segment;
+        if (segment.Sealed && (transactionID < segment.MinTransactionID || transactionID > segment.MaxTransactionID)) {
+            continue;
+        }
+
+        strLedgerCursor cursor;
+        cursor.Segment = i;
+        cursor.EndSegment = i + 1;
+        long long offset, nextOffset;
+        string_view line;
+        string error;
+        strTransactionView record;
+        while (!matched && nextLedgerLine(view, cursor, offset, nextOffset, line)) {
+            if (trimView(line.substr(0, line.find(Separator))) != transactionID) continue;
+            if (parseTransactionView(line, record, error)) {
+                found = toTransaction(record);
+                matched = true;
+            }
+        }
+    }
+    closeLedgerView(view);
+    return matched;
+}
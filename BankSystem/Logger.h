@@ -14,6 +14,143 @@
 // Forward declare appendLineToFile (defined in FileManager.h)
 void appendLineToFile(const string& FileName, const string& stDataLine);
 
+//=====================================================
+//================== Async Log Writer =================
+// logMessage() formats the line and queues it in a
+// bounded ring buffer; a writer thread keeps
+// SystemLog.txt open and writes queued lines in batches:
+// 1. The writer collects lines for up to LogBatchDelayMs
+//    before each batch write
+// 2. A full buffer blocks the caller (lines never drop)
+// 3. Lines at or above FlushLevel wait until written
+// 4. flushLogger() drains the buffer (logout), and
+//    stopLogger() runs at exit to drain and join
+//=====================================================
+
+// Writer thread: take all queued lines, write them in one batch, repeat
+void runLogWriter() {
+    ofstream logFile(LogFileName, ios::app);
+    vector<string> batch;
+    batch.reserve(LogBufferCapacity);
+
+    while (true) {
+        {
+            unique_lock<mutex> lock(AsyncLogger.Lock);
+            AsyncLogger.HasEntries.wait(lock, [] { return AsyncLogger.Count > 0 || AsyncLogger.StopRequested; });
+            if (AsyncLogger.Count == 0) {
+                break;
+            }
+
+            // Let the batch grow unless someone is waiting for it
+            AsyncLogger.HasEntries.wait_for(lock, chrono::milliseconds(LogBatchDelayMs), [] {
+                return AsyncLogger.StopRequested || AsyncLogger.FlushRequested ||
+                    AsyncLogger.Count >= LogBufferCapacity / 2;
+            });
+            AsyncLogger.FlushRequested = false;
+
+            for (; AsyncLogger.Count > 0; AsyncLogger.Count--) {
+                batch.push_back(move(AsyncLogger.Ring[AsyncLogger.Head]));
+                AsyncLogger.Head = (AsyncLogger.Head + 1) % LogBufferCapacity;
+            }
+        }
+        AsyncLogger.Progress.notify_all();
+
+        for (const string& line : batch) {
+            logFile << line << '\n';
+        }
+        logFile.flush();
+        if (!logFile) {
+            cerr << "[LOGGING ERROR] Failed to write to file: " << LogFileName << endl;
+            logFile.clear();
+        }
+
+        {
+            lock_guard<mutex> lock(AsyncLogger.Lock);
+            AsyncLogger.Written += batch.size();
+        }
+        AsyncLogger.Progress.notify_all();
+        batch.clear();
+    }
+}
+// Drain queued lines, stop the writer thread and log synchronously afterwards
+void stopLogger() {
+    {
+        lock_guard<mutex> lock(AsyncLogger.Lock);
+        AsyncLogger.ShutDown = true;
+        if (!AsyncLogger.Running) {
+            return;
+        }
+        AsyncLogger.StopRequested = true;
+    }
+    AsyncLogger.HasEntries.notify_one();
+    AsyncLogger.Writer.join();
+
+    lock_guard<mutex> lock(AsyncLogger.Lock);
+    AsyncLogger.Running = false;
+}
+// Start the writer thread on first use (caller holds the lock); false if no thread
+bool startLoggerLocked() {
+    AsyncLogger.Ring.assign(LogBufferCapacity, string());
+    AsyncLogger.Head = 0;
+    AsyncLogger.Count = 0;
+    AsyncLogger.StopRequested = false;
+
+    try {
+        AsyncLogger.Writer = thread(runLogWriter);
+    }
+    catch (const system_error& e) {
+        cerr << "[LOGGING ERROR] Cannot start log writer, logging synchronously: " << e.what() << endl;
+        AsyncLogger.ShutDown = true;
+        return false;
+    }
+
+    AsyncLogger.Running = true;
+    atexit(stopLogger);
+    return true;
+}
+// Queue a line for the writer (waits for the write at FlushLevel); false if shut down
+bool enqueueLogLine(string& line, LogLevel level) {
+    unique_lock<mutex> lock(AsyncLogger.Lock);
+    if (AsyncLogger.ShutDown) {
+        return false;
+    }
+    if (!AsyncLogger.Running && !startLoggerLocked()) {
+        return false;
+    }
+
+    AsyncLogger.Progress.wait(lock, [] { return AsyncLogger.Count < LogBufferCapacity; });
+    AsyncLogger.Ring[(AsyncLogger.Head + AsyncLogger.Count) % LogBufferCapacity] = move(line);
+    AsyncLogger.Count++;
+    unsigned long long sequence = ++AsyncLogger.Enqueued;
+
+    if (level >= AsyncLogger.FlushLevel) {
+        AsyncLogger.FlushRequested = true;
+        AsyncLogger.HasEntries.notify_one();
+        AsyncLogger.Progress.wait(lock, [sequence] { return AsyncLogger.Written >= sequence; });
+    }
+    else if (AsyncLogger.Count == 1 || AsyncLogger.Count == LogBufferCapacity / 2) {
+        AsyncLogger.HasEntries.notify_one();
+    }
+    return true;
+}
+// Block until every line queued so far is written to the log file
+void flushLogger() {
+    unique_lock<mutex> lock(AsyncLogger.Lock);
+    if (!AsyncLogger.Running) {
+        return;
+    }
+
+    unsigned long long target = AsyncLogger.Enqueued;
+    AsyncLogger.FlushRequested = true;
+    AsyncLogger.HasEntries.notify_one();
+    AsyncLogger.Progress.wait(lock, [target] { return AsyncLogger.Written >= target; });
+}
+// Set lowest level that is written before logMessage returns
+void setLogFlushLevel(LogLevel level) {
+    lock_guard<mutex> lock(AsyncLogger.Lock);
+    AsyncLogger.FlushLevel = level;
+}
+
 //=====================================================
 //================== Logging System ===================
 //=====================================================
@@ -28,7 +165,7 @@ string logLevelToString(LogLevel level) {
     default:        return "UNKNOWN";
     }
 }
-// Log message to file with timestamp, level, and user context
+// Log message with timestamp, level, and user context (written by the writer thread)
 void logMessage(const string& message, LogLevel level) {
     try {
         string logEntry = "[" + getCurrentTimestamp() + "] " +
@@ -36,7 +173,9 @@ void logMessage(const string& message, LogLevel level) {
             "[User: " + (CurrentUser.UserName.empty() ? "SYSTEM" : CurrentUser.UserName) + "] " +
             message;
 
-        appendLineToFile(LogFileName, logEntry);
+        if (!enqueueLogLine(logEntry, level)) {
+            appendLineToFile(LogFileName, logEntry);
+        }
     }
     catch (const exception& e) {
         cerr << "[LOGGING ERROR] " << e.what() << endl;
@@ -49,15 +188,16 @@ void logTransaction(const Transaction& txn) {
     case DEPOSIT:    typeStr = "DEPOSIT";    break;
     case WITHDRAWAL: typeStr = "WITHDRAWAL"; break;
     case TRANSFER:   typeStr = "TRANSFER";   break;
+    case REVERSAL:   typeStr = "REVERSAL";   break;
     default:         typeStr = "UNKNOWN";    break;
     }
 
     string message = "Transaction " + txn.TransactionID +
         " - Type: " + typeStr +
-        " - Amount: " + formatDouble(txn.Amount) +
+        " - Amount: " + formatMoney(txn.Amount) +
         " - From: " + txn.FromAccount +
         " - To: " + txn.ToAccount +
-        " - Fees: " + formatDouble(txn.Fees);
+        " - Fees: " + formatMoney(txn.Fees);
 
     logMessage(message, INFO);
 }
@@ -10,15 +10,33 @@
 //  ||  - Globals.h            : Structs, Enums, Constants,   ||
 //  ||                           Forward Declarations         ||
 //  ||  - Utilities.h          : Format, UI, Screen helpers   ||
+//  ||  - ScreenRenderer.h     : Buffered, paged table output ||
 //  ||  - Crypto.h             : Encryption & Decryption      ||
 //  ||  - Session.h            : Session Management           ||
 //  ||  - Logger.h             : Logging System               ||
+//  ||  - Metrics.h            : Latency histograms & stats   ||
+//  ||  - Durability.h         : none / group commit / fsync  ||
+//  ||  - HashIndex.h          : Account & username index     ||
 //  ||  - FileManager.h        : File I/O & Serialization     ||
+//  ||  - AccountDictionary.h  : Dense account ids & arena    ||
+//  ||  - ClientStore.h        : Reload clients on change     ||
+//  ||  - Journal.h            : Balance journal & checkpoint ||
+//  ||  - BinaryClients.h      : Fixed-width clients file     ||
+//  ||  - Ledger.h             : Segmented transaction ledger ||
+//  ||  - LedgerView.h         : Mapped read-only ledger view ||
+//  ||  - TransactionIndex.h   : Per-account ledger offsets   ||
+//  ||  - RecentTransactions.h : Recent transactions per acct ||
+//  ||  - TransactionIdIndex.h : Transaction ID hash table    ||
+//  ||  - IdGenerator.h        : Snowflake transaction IDs    ||
 //  ||  - InputManager.h       : Input reading & validation   ||
 //  ||  - ClientManager.h      : Client CRUD operations       ||
+//  ||  - ClientColumns.h      : Balance columns & aggregates ||
 //  ||  - TransactionManager.h : Deposit/Withdraw/Transfer    ||
+//  ||  - ConcurrentLedger.h   : Thread-safe striped postings ||
+//  ||  - BatchManager.h       : Headless batch transactions  ||
 //  ||  - UserManager.h        : User CRUD operations         ||
 //  ||  - PermissionManager.h  : Permission checks            ||
+//  ||  - ServerManager.h      : Teller server (Unix socket)  ||
 //  ||  - AuthManager.h        : Login, Hashing, Admin setup  ||
 //  ||  - MenuManager.h        : All menus and navigation     ||
 //  ||========================================================||
@@ -28,15 +46,33 @@
 
 #include "Globals.h"
 #include "Utilities.h"
+#include "ScreenRenderer.h"
 #include "Crypto.h"
 #include "Session.h"
 #include "Logger.h"
+#include "Metrics.h"
+#include "Durability.h"
+#include "HashIndex.h"
 #include "FileManager.h"
+#include "AccountDictionary.h"
+#include "ClientStore.h"
+#include "Journal.h"
+#include "BinaryClients.h"
+#include "Ledger.h"
+#include "LedgerView.h"
+#include "TransactionIndex.h"
+#include "RecentTransactions.h"
+#include "TransactionIdIndex.h"
+#include "IdGenerator.h"
 #include "InputManager.h"
 #include "PermissionManager.h"
 #include "ClientManager.h"
+#include "ClientColumns.h"
 #include "TransactionManager.h"
+#include "ConcurrentLedger.h"
+#include "BatchManager.h"
 #include "UserManager.h"
+#include "ServerManager.h"
 #include "AuthManager.h"
 #include "MenuManager.h"
 
@@ -44,13 +80,35 @@
 // Global variable definition (declared extern in Globals.h)
 //=====================================================
 strUser CurrentUser;
+strJournalState JournalState;
+strHashIndex ClientIndex;
+strHashIndex UserIndex;
+strLedger Ledger;
+strTransactionIndex TransactionIndex;
+strAsyncLogger AsyncLogger;
+strSessionCache SessionCache;
+strClientStore ClientStore;
+strServerControl ServerControl;
+strServerLogins ServerLogins;
+strScreenBuffer ScreenBuffer;
+strDurability Durability;
+strMetrics Metrics;
+strClientFile ClientFile;
+strAccountDictionary AccountIds;
+strRecentCache RecentCache;
+strTransactionIdIndex TransactionIds;
+strTransactionIdGenerator IdGenerator;
 
 //=====================================================
 //==================== Main Function ==================
 //=====================================================
 
 // Program entry point: initialize system, create admin, login, run menus
-int main()
+// Other modes: --batch <file>, --serve [socket], --connect [socket]
+// Any mode may start with --durability none|fsync|group[:<window micros>] (default group)
+// and --storage text|binary (default text) and --node <0-1023> (transaction ID node, default the lowest
+// one no other process holds); --convert-clients to-binary|to-text converts Clients.txt
+int main(int argc, char* argv[])
 {
     cout << fixed << setprecision(2);
 
@@ -59,7 +117,55 @@ int main()
         return 1;
     }
 
+    vector<string> args(argv + 1, argv + argc);
+    uint32_t nodeId = NoTransactionNode;
+    while (args.size() >= 2 && (args[0] == "--durability" || args[0] == "--storage" || args[0] == "--node")) {
+        if (args[0] == "--durability") {
+            DurabilityMode durabilityMode;
+            long long windowMicros = GroupCommitWindowMicros;
+            if (!parseDurabilityMode(args[1], durabilityMode, windowMicros)) {
+                showErrorMessage("Unknown durability mode: " + args[1] + " (use none, fsync, group or group:<micros>)");
+                return 1;
+            }
+            setDurabilityMode(durabilityMode, windowMicros);
+        }
+        else if (args[0] == "--node") {
+            if (!parseTransactionNodeId(args[1], nodeId)) {
+                showErrorMessage("Invalid node id: " + args[1] + " (use 0 to 1023)");
+                return 1;
+            }
+        }
+        else if (!parseClientFileFormat(args[1], ClientFile.Format)) {
+            showErrorMessage("Unknown storage format: " + args[1] + " (use text or binary)");
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+
+    string mode = args.size() >= 1 ? args[0] : "";
+    string socketPath = args.size() >= 2 ? args[1] : ServerSocketFileName;
+    if (mode == "--connect") {
+        return runTellerClient(socketPath);
+    }
+
     try {
+        if (mode == "--convert-clients" && args.size() >= 2) {
+            return convertClientsFile(args[1]);
+        }
+        // Two processes stamping the same node would issue the same IDs
+        if (!claimTransactionNode(nodeId)) {
+            showErrorMessage(nodeId == NoTransactionNode ? "No free transaction ID node (0 to 1023 all in use)" :
+                "Node id " + to_string(nodeId) + " is in use by another process");
+            return 1;
+        }
+        startMetricsDumper();
+        openLedger(TransactionsFileName);
+        if (mode == "--batch" && args.size() >= 2) {
+            return runBatchMode(args[1]);
+        }
+        if (mode == "--serve") {
+            return runBankServer(socketPath);
+        }
         createDefaultAdmin();
         login();
     }
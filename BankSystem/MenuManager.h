@@ -16,6 +16,9 @@
 #include "TransactionManager.h"
 #include "UserManager.h"
 #include "Session.h"
+#include "ClientStore.h"
+#include "RecentTransactions.h"
+#include "Metrics.h"
 
 //=====================================================
 //==================== Menu Manager ===================
@@ -28,7 +31,7 @@ void login();
 vector<string> buildMainMenuOptions() {
     vector<string> options;
     if (hasPermission(Permission::pAll))
-        options = { "Show Client List","Add New Client","Delete Client","Update Client","Find Client","Transactions","Manage Users" };
+        options = { "Show Client List","Add New Client","Delete Client","Update Client","Find Client","Transactions","Manage Users","Performance Stats" };
     else {
         if (hasPermission(Permission::pListClients))  options.push_back("Show Client List");
         if (hasPermission(Permission::pAddClient))    options.push_back("Add New Client");
@@ -53,6 +56,7 @@ MainMenuOption convertChoiceToMainMenuOption(int choice, const vector<string>& o
     if (selectedOption == "Find Client")      return MainMenuOption::FindClient;
     if (selectedOption == "Transactions")     return MainMenuOption::Transactions;
     if (selectedOption == "Manage Users")     return MainMenuOption::ManageUsers;
+    if (selectedOption == "Performance Stats") return MainMenuOption::PerformanceStats;
     if (selectedOption == "Logout")           return MainMenuOption::Logout;
     if (selectedOption == "Exit")             return MainMenuOption::Exit;
 
@@ -72,7 +76,7 @@ void executeMainMenuOption(MainMenuOption MainMenuOption, vector<strClient>& vCl
         userHasPermission = hasPermission(Permission::pAddClient);
         if (userHasPermission) {
             showAddClientScreen(vClients);
-            vClients = loadClientsDataFromFile(ClientsFileName);
+            refreshClientsFromFile(ClientsFileName, vClients);
         }
         break;
     case MainMenuOption::DeleteClient:
@@ -85,7 +89,7 @@ void executeMainMenuOption(MainMenuOption MainMenuOption, vector<strClient>& vCl
         userHasPermission = hasPermission(Permission::pUpdateClient);
         if (userHasPermission) {
             showUpdateClientScreen(vClients);
-            vClients = loadClientsDataFromFile(ClientsFileName);
+            refreshClientsFromFile(ClientsFileName, vClients);
         }
         break;
     case MainMenuOption::FindClient:
@@ -98,7 +102,7 @@ void executeMainMenuOption(MainMenuOption MainMenuOption, vector<strClient>& vCl
         userHasPermission = hasPermission(Permission::pTransactions);
         if (userHasPermission) {
             manageTransactions(vClients);
-            vClients = loadClientsDataFromFile(ClientsFileName);
+            refreshClientsFromFile(ClientsFileName, vClients);
         }
         break;
     case MainMenuOption::ManageUsers: {
@@ -110,16 +114,29 @@ void executeMainMenuOption(MainMenuOption MainMenuOption, vector<strClient>& vCl
         }
         break;
     }
+    case MainMenuOption::PerformanceStats:
+        userHasPermission = hasPermission(Permission::pAll);
+        if (userHasPermission) {
+            showPerformanceStatsScreen();
+        }
+        break;
     case MainMenuOption::Logout:
         if (confirmAction("Are you sure you want to logout?")) {
             clearCurrentUserSession();
             showSuccessMessage("You have been logged out successfully. Session cleared.");
             logUserAction("LOGOUT", "User: " + CurrentUser.UserName);
+            logClientStoreCounters();
+            logRecentCacheCounters();
+            logDurabilityCounters();
+            flushLogger();
             pressEnterToContinue();
             login();
         }
         break;
     case MainMenuOption::Exit:
+        logClientStoreCounters();
+        logRecentCacheCounters();
+        logDurabilityCounters();
         showExitScreen();
         exit(0);
         break;
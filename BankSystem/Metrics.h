@@ -0,0 +1,302 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: Metrics.h                                        ||
+//  || Section: Metrics                                       ||
+//  || Latency histograms for the hot paths, a Performance    ||
+//  || Stats screen and a periodic metrics file.              ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "ScreenRenderer.h"
+#include "Logger.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//=====================================================
+//====================== Metrics ======================
+// A strMetricTimer on the stack times its scope into one
+// histogram per MetricId:
+// 1. Buckets are log-linear (HDR style): values below
+//    MetricSubBuckets ns have their own bucket, above
+//    that every power of two is split into
+//    MetricSubBuckets buckets, so any percentile is
+//    within ~6% and a record is a few relaxed atomic adds
+// 2. Counts, total and max are kept next to the buckets
+//    for mean and max
+// 3. A dumper thread rewrites MetricsFileName every
+//    MetricsDumpIntervalSeconds and once more at exit;
+//    admins see the same numbers on Performance Stats,
+//    with the recent transactions cache counters
+//=====================================================
+
+// Position of the highest set bit (value > 0)
+inline int getHighestBit(uint64_t value) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+// Histogram bucket of a value in nanoseconds
+inline int getMetricBucket(uint64_t nanos) {
+    if (nanos < static_cast<uint64_t>(MetricSubBuckets)) {
+        return static_cast<int>(nanos);
+    }
+    int highestBit = getHighestBit(nanos);
+    int shift = highestBit - 4;
+    return (highestBit - 3) * MetricSubBuckets + static_cast<int>((nanos >> shift) & (MetricSubBuckets - 1));
+}
+// Smallest value that falls in a bucket
+uint64_t getMetricBucketStart(int bucket) {
+    if (bucket < MetricSubBuckets) {
+        return static_cast<uint64_t>(bucket);
+    }
+    int highestBit = bucket / MetricSubBuckets + 3;
+    uint64_t subBucket = static_cast<uint64_t>(bucket % MetricSubBuckets);
+    return (MetricSubBuckets + subBucket) << (highestBit - 4);
+}
+// Record one sample of a metric
+void recordMetricNanos(MetricId metric, uint64_t nanos) {
+    strLatencyHistogram& histogram = Metrics.Histograms[metric];
+    histogram.Buckets[getMetricBucket(nanos)].fetch_add(1, memory_order_relaxed);
+    histogram.Count.fetch_add(1, memory_order_relaxed);
+    histogram.TotalNanos.fetch_add(nanos, memory_order_relaxed);
+
+    uint64_t maximum = histogram.MaxNanos.load(memory_order_relaxed);
+    while (nanos > maximum && !histogram.MaxNanos.compare_exchange_weak(maximum, nanos, memory_order_relaxed)) {
+    }
+}
+// Clear every sample of a metric
+void resetMetric(MetricId metric) {
+    strLatencyHistogram& histogram = Metrics.Histograms[metric];
+    for (atomic<uint64_t>& bucket : histogram.Buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    histogram.Count.store(0, memory_order_relaxed);
+    histogram.TotalNanos.store(0, memory_order_relaxed);
+    histogram.MaxNanos.store(0, memory_order_relaxed);
+}
+// Record the time elapsed since start
+void recordMetric(MetricId metric, chrono::steady_clock::time_point start) {
+    long long nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    recordMetricNanos(metric, static_cast<uint64_t>(max(0LL, nanos)));
+}
+// Times its scope into a metric: strMetricTimer timer(METRIC_SAVE_CLIENTS);
+struct strMetricTimer {
+    MetricId Metric;
+    chrono::steady_clock::time_point Start;
+
+    explicit strMetricTimer(MetricId metric) : Metric(metric), Start(chrono::steady_clock::now()) {}
+    ~strMetricTimer() { recordMetric(Metric, Start); }
+};
+// Display name of a metric
+string getMetricName(MetricId metric) {
+    switch (metric) {
+    case METRIC_LOAD_CLIENTS:    return "Load clients";
+    case METRIC_SAVE_CLIENTS:    return "Save clients";
+    case METRIC_LEDGER_APPEND:   return "Ledger append";
+    case METRIC_BALANCE_COMMIT:  return "Balance commit";
+    case METRIC_HASH_PASSWORD:   return "Hash password";
+    case METRIC_VERIFY_PASSWORD: return "Verify password";
+    case METRIC_LOGIN:           return "Login";
+    case METRIC_DEPOSIT:         return "Deposit";
+    case METRIC_WITHDRAW:        return "Withdraw";
+    case METRIC_TRANSFER:        return "Transfer";
+    case METRIC_HISTORY:         return "History query";
+    case METRIC_ID_LOOKUP:       return "ID lookup";
+    case METRIC_REVERSAL:        return "Reversal";
+    default:                     return "Unknown";
+    }
+}
+// Metric of a posting type
+MetricId getTransactionMetric(TransactionType type) {
+    return type == DEPOSIT ? METRIC_DEPOSIT : type == WITHDRAWAL ? METRIC_WITHDRAW :
+        type == REVERSAL ? METRIC_REVERSAL : METRIC_TRANSFER;
+}
+// Metric name as a file key: lower case, '_' for spaces
+string getMetricKey(MetricId metric) {
+    string key = getMetricName(metric);
+    for (char& c : key) {
+        c = (c == ' ') ? '_' : static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+// Value at a fraction (0..1) of the samples: middle of its bucket, never above the max; 0 if empty
+uint64_t getMetricPercentile(const strLatencyHistogram& histogram, double fraction) {
+    uint64_t counts[MetricBucketCount];
+    uint64_t total = 0;
+    for (int i = 0; i < MetricBucketCount; i++) {
+        counts[i] = histogram.Buckets[i].load(memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t rank = max<uint64_t>(1, static_cast<uint64_t>(ceil(fraction * static_cast<double>(total))));
+    uint64_t seen = 0;
+    int bucket = 0;
+    for (; bucket < MetricBucketCount - 1; bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank) break;
+    }
+
+    uint64_t start = getMetricBucketStart(bucket);
+    uint64_t end = (bucket + 1 < MetricBucketCount) ? getMetricBucketStart(bucket + 1) : UINT64_MAX;
+    return min(start + (end - start) / 2, histogram.MaxNanos.load(memory_order_relaxed));
+}
+// Mean of a metric in nanoseconds (0 if empty)
+uint64_t getMetricMean(const strLatencyHistogram& histogram) {
+    uint64_t count = histogram.Count.load(memory_order_relaxed);
+    return count == 0 ? 0 : histogram.TotalNanos.load(memory_order_relaxed) / count;
+}
+// Format nanoseconds with a readable unit (ns, us, ms, s)
+string formatNanos(uint64_t nanos) {
+    if (nanos < 1000) return to_string(nanos) + " ns";
+    if (nanos < 1000000) return formatDouble(nanos / 1e3, 1) + " us";
+    if (nanos < 1000000000) return formatDouble(nanos / 1e6, 2) + " ms";
+    return formatDouble(nanos / 1e9, 2) + " s";
+}
+// Share of recent transactions cache accesses served from a ring, in percent (0 if none)
+double getRecentCacheHitRate() {
+    uint64_t hits = RecentCache.Hits.load(memory_order_relaxed);
+    uint64_t accesses = hits + RecentCache.Misses.load(memory_order_relaxed);
+    return accesses == 0 ? 0 : 100.0 * static_cast<double>(hits) / static_cast<double>(accesses);
+}
+// Recent transactions cache counters as one line: hits, misses, hit rate, updates, evictions
+string formatRecentCacheCounters() {
+    return "Recent transactions cache: " + to_string(RecentCache.Hits.load(memory_order_relaxed)) + " hits, " +
+        to_string(RecentCache.Misses.load(memory_order_relaxed)) + " misses (" +
+        formatDouble(getRecentCacheHitRate(), 1) + "% hit rate), " +
+        to_string(RecentCache.Updates.load(memory_order_relaxed)) + " updates, " +
+        to_string(RecentCache.Evictions.load(memory_order_relaxed)) + " evictions";
+}
+// Metrics file text: one line per metric with count and p50/p99/max/mean in microseconds
+string formatMetricsReport() {
+    long long uptime = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - Metrics.Started).count();
+    string text = "# BankSystem metrics " + getCurrentTimestamp() + " (uptime " + to_string(uptime) + " s)\n";
+
+    for (int i = 0; i < METRIC_COUNT; i++) {
+        MetricId metric = static_cast<MetricId>(i);
+        const strLatencyHistogram& histogram = Metrics.Histograms[i];
+        text += getMetricKey(metric) +
+            " count=" + to_string(histogram.Count.load(memory_order_relaxed)) +
+            " p50_us=" + formatDouble(getMetricPercentile(histogram, 0.50) / 1e3, 1) +
+            " p99_us=" + formatDouble(getMetricPercentile(histogram, 0.99) / 1e3, 1) +
+            " max_us=" + formatDouble(histogram.MaxNanos.load(memory_order_relaxed) / 1e3, 1) +
+            " mean_us=" + formatDouble(getMetricMean(histogram) / 1e3, 1) + "\n";
+    }
+    text += "recent_cache hits=" + to_string(RecentCache.Hits.load(memory_order_relaxed)) +
+        " misses=" + to_string(RecentCache.Misses.load(memory_order_relaxed)) +
+        " hit_rate_pct=" + formatDouble(getRecentCacheHitRate(), 1) +
+        " updates=" + to_string(RecentCache.Updates.load(memory_order_relaxed)) +
+        " evictions=" + to_string(RecentCache.Evictions.load(memory_order_relaxed)) + "\n";
+    return text;
+}
+// Rewrite the metrics file (tmp, then rename)
+bool writeMetricsFile(const string& fileName = MetricsFileName) {
+    string tempFile = fileName + ".tmp";
+    ofstream out(tempFile, ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open metrics file for writing: " + tempFile, WARNING);
+        return false;
+    }
+    out << formatMetricsReport();
+    out.close();
+
+#ifdef _WIN32
+    remove(fileName.c_str());
+#endif
+
+    if (rename(tempFile.c_str(), fileName.c_str()) != 0) {
+        logMessage("Failed to rename metrics file: " + fileName, WARNING);
+        return false;
+    }
+    lock_guard<mutex> lock(Metrics.Lock);
+    Metrics.Dumps++;
+    return true;
+}
+// Dumper thread: write the metrics file every interval until stopped
+void runMetricsDumper() {
+    unique_lock<mutex> lock(Metrics.Lock);
+    while (!Metrics.StopRequested) {
+        Metrics.Wake.wait_for(lock, chrono::seconds(MetricsDumpIntervalSeconds), [] { return Metrics.StopRequested; });
+        if (Metrics.StopRequested) break;
+
+        lock.unlock();
+        writeMetricsFile();
+        lock.lock();
+    }
+}
+// Stop the dumper thread and write the final metrics file
+void stopMetricsDumper() {
+    {
+        lock_guard<mutex> lock(Metrics.Lock);
+        if (!Metrics.Running) {
+            return;
+        }
+        Metrics.StopRequested = true;
+    }
+    Metrics.Wake.notify_one();
+    Metrics.Dumper.join();
+    {
+        lock_guard<mutex> lock(Metrics.Lock);
+        Metrics.Running = false;
+    }
+    writeMetricsFile();
+}
+// Start the dumper thread once (stopped at exit)
+void startMetricsDumper() {
+    lock_guard<mutex> lock(Metrics.Lock);
+    if (Metrics.Running) {
+        return;
+    }
+
+    Metrics.StopRequested = false;
+    try {
+        Metrics.Dumper = thread(runMetricsDumper);
+    }
+    catch (const system_error& e) {
+        logMessage("Cannot start metrics dumper: " + string(e.what()), WARNING);
+        return;
+    }
+    Metrics.Running = true;
+    atexit(stopMetricsDumper);
+}
+// Show count, p50, p99, max and mean of every metric
+void showPerformanceStatsScreen() {
+    beginScreen("Performance Stats");
+    string& out = ScreenBuffer.Text;
+    long long uptime = chrono::duration_cast<chrono::seconds>(chrono::steady_clock::now() - Metrics.Started).count();
+    out += "Since start: " + to_string(uptime) + " s   Metrics file: " + MetricsFileName +
+        " (every " + to_string(MetricsDumpIntervalSeconds) + " s)\n\n";
+
+    vector<strTableColumn> columns = {
+        { "Operation", 18 }, { "Count", 10 }, { "p50", 11 }, { "p99", 11 }, { "Max", 11 }, { "Mean", 11 } };
+    showPagedTable(columns, METRIC_COUNT, [&](string& row, size_t i) {
+        const strLatencyHistogram& histogram = Metrics.Histograms[i];
+        uint64_t count = histogram.Count.load(memory_order_relaxed);
+        bool empty = count == 0;
+
+        appendTextCell(row, getMetricName(static_cast<MetricId>(i)), 18);
+        appendCountCell(row, static_cast<size_t>(count), 10);
+        appendTextCell(row, empty ? "-" : formatNanos(getMetricPercentile(histogram, 0.50)), 11);
+        appendTextCell(row, empty ? "-" : formatNanos(getMetricPercentile(histogram, 0.99)), 11, YELLOW);
+        appendTextCell(row, empty ? "-" : formatNanos(histogram.MaxNanos.load(memory_order_relaxed)), 11, RED);
+        appendTextCell(row, empty ? "-" : formatNanos(getMetricMean(histogram)), 11);
+        appendRowEnd(row);
+    });
+    out += "\nTimes cover the work after input: deposits, withdrawals and transfers\n"
+        "are timed from confirmation until the ledger and balances are written.\n\n";
+    out += formatRecentCacheCounters() + "\n";
+
+    writeScreenBuffer();
+    backToMenu();
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: RecentTransactions.h                             ||
+//  || Section: Recent Transactions                           ||
+//  || Bounded per-account ring of the newest transactions,   ||
+//  || filled on first access and kept current by postings.  ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "AccountDictionary.h"
+#include "TransactionIndex.h"
+
+//=====================================================
+//================ Recent Transactions ================
+// The client card and the history screen show recent
+// activity from RecentCache instead of the ledger:
+// 1. The first access to an account reads only its last
+//    RecentTransactionsCount ledger records (through the
+//    transaction index) into a ring keyed by account id
+// 2. Every posting saved to the ledger is pushed into the
+//    rings of its accounts that are cached; uncached
+//    accounts are left alone, their first access reads
+//    the posting from the ledger
+// 3. At most RecentCacheMaxAccounts rings are kept; a
+//    full cache evicts an arbitrary ring. Loading the
+//    clients again (the files changed on disk) clears
+//    the cache
+// 4. A miss reads the ledger with the lock released (the
+//    read may reload the account dictionary, which clears
+//    the cache); the ring is kept only if no clear or
+//    posting happened meanwhile
+// Hits, misses, updates and evictions are counted for
+// Performance Stats and the metrics file.
+//=====================================================
+
+// Forget every cached ring
+void clearRecentTransactions() {
+    lock_guard<mutex> lock(RecentCache.Lock);
+    RecentCache.Rings.clear();
+    RecentCache.Generation++;
+}
+// Add a transaction to a ring, overwriting the oldest one when full
+void pushRecentTransaction(strRecentRing& ring, const Transaction& transaction) {
+    if (ring.Items.size() < RecentTransactionsCount) {
+        ring.Items.push_back(transaction);
+    }
+    else {
+        ring.Items[ring.Next] = transaction;
+        ring.Next = (ring.Next + 1) % RecentTransactionsCount;
+    }
+    ring.Total++;
+}
+// Push a posting just saved to the ledger into the cached rings of its accounts
+void noteRecentTransaction(const Transaction& transaction) {
+    // Ids are looked up before the lock: the dictionary may be (re)loaded on the way
+    uint32_t fromId = transaction.FromAccount.empty() ? NoAccountId : getAccountId(transaction.FromAccount);
+    uint32_t toId = transaction.ToAccount.empty() || transaction.ToAccount == transaction.FromAccount ?
+        NoAccountId : getAccountId(transaction.ToAccount);
+
+    lock_guard<mutex> lock(RecentCache.Lock);
+    RecentCache.Generation++;
+    if (RecentCache.Rings.empty()) {
+        return;
+    }
+
+    for (uint32_t accountId : { fromId, toId }) {
+        if (accountId == NoAccountId) {
+            continue;
+        }
+        auto entry = RecentCache.Rings.find(accountId);
+        if (entry != RecentCache.Rings.end()) {
+            pushRecentTransaction(entry->second, transaction);
+            RecentCache.Updates.fetch_add(1, memory_order_relaxed);
+        }
+    }
+}
+// Copy a ring out, oldest first
+vector<Transaction> copyRecentRing(const strRecentRing& ring) {
+    vector<Transaction> transactions;
+    transactions.reserve(ring.Items.size());
+    for (size_t i = 0; i < ring.Items.size(); i++) {
+        transactions.push_back(ring.Items[(ring.Next + i) % ring.Items.size()]);
+    }
+    return transactions;
+}
+// Recent transactions of an account, oldest first; total receives the account's ledger record count
+vector<Transaction> getRecentTransactions(const string& accountNumber, size_t& total) {
+    uint32_t accountId = getAccountId(accountNumber);
+    uint64_t generation;
+    {
+        lock_guard<mutex> lock(RecentCache.Lock);
+        auto entry = RecentCache.Rings.find(accountId);
+        if (entry != RecentCache.Rings.end()) {
+            RecentCache.Hits.fetch_add(1, memory_order_relaxed);
+            total = entry->second.Total;
+            return copyRecentRing(entry->second);
+        }
+        generation = RecentCache.Generation;
+    }
+
+    RecentCache.Misses.fetch_add(1, memory_order_relaxed);
+    strRecentRing ring;
+    ring.Items = loadAccountTransactions(TransactionsFileName, accountNumber, true, RecentTransactionsCount);
+    ring.Total = max(ring.Items.size(), countAccountTransactions(accountNumber));
+    total = ring.Total;
+
+    // Loading builds the index, which gives ledger-only accounts their id; an unknown account gets no ring
+    accountId = getAccountId(accountNumber);
+    if (accountId == NoAccountId) {
+        return ring.Items;
+    }
+
+    lock_guard<mutex> lock(RecentCache.Lock);
+    if (RecentCache.Generation == generation && RecentCache.Rings.find(accountId) == RecentCache.Rings.end()) {
+        if (RecentCache.Rings.size() >= RecentCacheMaxAccounts) {
+            RecentCache.Rings.erase(RecentCache.Rings.begin());
+            RecentCache.Evictions.fetch_add(1, memory_order_relaxed);
+        }
+        RecentCache.Rings.emplace(accountId, ring);
+    }
+    return ring.Items;
+}
+// Log the cache counters (formatted in Metrics.h)
+void logRecentCacheCounters() {
+    logMessage(formatRecentCacheCounters(), INFO);
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: ScreenRenderer.h                                 ||
+//  || Section: Screen Renderer                               ||
+//  || Builds list screens into one reusable buffer, writes   ||
+//  || each page at once and pages long tables.               ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include <cerrno>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//=====================================================
+//================== Screen Renderer ==================
+// Table screens do not stream cells through cout:
+// 1. Cells are appended to ScreenBuffer.Text (padding,
+//    colors, and numbers written with to_chars)
+// 2. A finished page is written with one write() call and
+//    the buffer is cleared but keeps its capacity
+// 3. On a terminal, tables show ScreenPageRows rows per
+//    page and ask before the next one; when output is a
+//    pipe or file, every row is written, page by page,
+//    under a single table header
+//=====================================================
+
+// Check once whether stdin and stdout are both a terminal
+bool isInteractiveScreen() {
+    if (ScreenBuffer.Interactive < 0) {
+#ifdef _WIN32
+        ScreenBuffer.Interactive = _isatty(_fileno(stdin)) && _isatty(_fileno(stdout));
+#else
+        ScreenBuffer.Interactive = isatty(STDIN_FILENO) && isatty(STDOUT_FILENO);
+#endif
+    }
+    return ScreenBuffer.Interactive == 1;
+}
+// Write the buffer to stdout in one call and clear it
+void writeScreenBuffer() {
+    string& text = ScreenBuffer.Text;
+    if (text.empty()) {
+        return;
+    }
+
+    // Anything already printed through cout goes first
+    cout.flush();
+    fflush(stdout);
+
+#ifdef _WIN32
+    fwrite(text.data(), 1, text.size(), stdout);
+    fflush(stdout);
+#else
+    size_t written = 0;
+    while (written < text.size()) {
+        ssize_t result = write(STDOUT_FILENO, text.data() + written, text.size() - written);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+        written += static_cast<size_t>(result);
+    }
+#endif
+    ScreenBuffer.Writes++;
+    text.clear();
+}
+// Append text padded with spaces to width (like setw with left, never cut)
+void appendPadded(string& out, string_view text, int width) {
+    out += text;
+    if (static_cast<int>(text.size()) < width) {
+        out.append(width - text.size(), ' ');
+    }
+}
+// Append a bordered line (+ at start and end), like showBorderLine()
+void appendBorderLine(string& out, int length, char symbol, const string& color) {
+    out += color;
+    out += '+';
+    out.append(length, symbol);
+    out += '+';
+    out += RESET;
+    out += '\n';
+}
+// Append a centered header with borders, like showScreenHeader()
+void appendScreenHeader(string& out, const string& title) {
+    int padding = (58 - static_cast<int>(title.length())) / 2;
+
+    out += '\n';
+    appendBorderLine(out, 58, '=', CYAN);
+    out += CYAN + "|" + string(58, ' ') + "|\n";
+    out += "|" + string(padding, ' ') + title + string(58 - padding - title.length(), ' ') + "|\n";
+    out += "|" + string(58, ' ') + "|\n";
+    appendBorderLine(out, 58, '=', CYAN);
+}
+// Start a new screen in the buffer: clear sequence and header
+void beginScreen(const string& title) {
+    ScreenBuffer.Text.clear();
+    ScreenBuffer.Text += ClearScreenSequence;
+    appendScreenHeader(ScreenBuffer.Text, title);
+}
+// Append a text cell: cyan separator, then the padded text in color ("" = default)
+void appendTextCell(string& out, string_view text, int width, const string& color = "") {
+    out += CYAN;
+    out += "| ";
+    out += RESET;
+    out += color;
+    appendPadded(out, text, width);
+    if (!color.empty()) out += RESET;
+}
+// Append a money cell, with a $ sign if currency
+void appendMoneyCell(string& out, Money value, int width, const string& color = "", bool currency = true) {
+    char buffer[MoneyTextSize + 1];
+    char* first = buffer;
+    if (currency) *first++ = '$';
+    char* last = writeMoney(first, value);
+    appendTextCell(out, string_view(buffer, last - buffer), width, color);
+}
+// Append a count cell
+void appendCountCell(string& out, size_t value, int width, const string& color = "") {
+    char buffer[24];
+    char* last = to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    appendTextCell(out, string_view(buffer, last - buffer), width, color);
+}
+// Close a table row
+void appendRowEnd(string& out) {
+    out += CYAN;
+    out += "|\n";
+    out += RESET;
+}
+// Border length of a table: each cell is "| " + width, then the closing "|"
+int getTableBorderLength(const vector<strTableColumn>& columns) {
+    int length = -1;
+    for (const strTableColumn& column : columns) {
+        length += column.Width + 2;
+    }
+    return length;
+}
+// Append border, column titles and border
+void appendTableHeader(string& out, const vector<strTableColumn>& columns) {
+    int borderLength = getTableBorderLength(columns);
+    appendBorderLine(out, borderLength, '-', CYAN);
+    out += CYAN;
+    for (const strTableColumn& column : columns) {
+        out += "| ";
+        appendPadded(out, column.Title, column.Width);
+    }
+    out += "|\n";
+    appendBorderLine(out, borderLength, '-', CYAN);
+}
+// Ask whether to show the next page: false to stop, showAll set if the rest should not ask again
+bool askNextPage(size_t page, size_t pageCount, bool& showAll) {
+    cout << CYAN << "-- Page " << page << " of " << pageCount << " --  " << RESET
+        << YELLOW << "[Enter] Next  [A] All  [Q] Stop: " << RESET;
+
+    string answer;
+    if (!getline(cin, answer)) {
+        return false;
+    }
+    answer = trim(answer);
+    if (answer == "q" || answer == "Q") {
+        return false;
+    }
+    showAll = (answer == "a" || answer == "A");
+    return true;
+}
+// Render rows [0, rowCount) under a header, writing the buffer page by page; returns rows shown.
+// writeRow(out, i) appends row i; the last page is left in the buffer for the caller to finish.
+template <typename WriteRow>
+size_t showPagedTable(const vector<strTableColumn>& columns, size_t rowCount, WriteRow writeRow) {
+    string& out = ScreenBuffer.Text;
+    int borderLength = getTableBorderLength(columns);
+    bool paged = isInteractiveScreen();
+    bool showAll = !paged;
+    size_t pageCount = max<size_t>(1, (rowCount + ScreenPageRows - 1) / ScreenPageRows);
+
+    appendTableHeader(out, columns);
+    size_t row = 0;
+    for (size_t page = 1; page <= pageCount; page++) {
+        size_t pageEnd = min(rowCount, row + ScreenPageRows);
+        for (; row < pageEnd; row++) {
+            writeRow(out, row);
+        }
+        if (page == pageCount) {
+            break;
+        }
+
+        if (showAll) {
+            writeScreenBuffer();
+            continue;
+        }
+
+        appendBorderLine(out, borderLength, '-', CYAN);
+        writeScreenBuffer();
+        if (!askNextPage(page, pageCount, showAll)) {
+            out += "\nShowing " + to_string(row) + " of " + to_string(rowCount) + " rows.\n";
+            return row;
+        }
+        out += ClearScreenSequence;
+        appendTableHeader(out, columns);
+    }
+
+    appendBorderLine(out, borderLength, '-', CYAN);
+    return row;
+}
@@ -0,0 +1,591 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: ServerManager.h                                  ||
+//  || Section: Teller Server                                 ||
+//  || Single-process server that owns the data files and     ||
+//  || serves many tellers over a Unix domain socket.         ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Durability.h"
+#include "FileManager.h"
+#include "Journal.h"
+#include "TransactionIndex.h"
+#include "PermissionManager.h"
+#include "ClientManager.h"
+#include "TransactionManager.h"
+#include "BatchManager.h"
+#include "UserManager.h"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <csignal>
+#include <cerrno>
+#endif
+
+//=====================================================
+//=================== Teller Server ===================
+// One request per line, fields separated by #//#, one
+// "OK#//#..." or "ERR#//#message" line per response:
+//   LOGIN#//#User#//#Password      LOGOUT      QUIT
+//   BALANCE#//#Account             FIND#//#Account
+//   DEPOSIT / WITHDRAW / TRANSFER  (batch file syntax)
+//   HISTORY#//#Account  -> OK#//#Count, then Count lines
+//   TOTAL
+// 1. A single poll() loop serves every connection, so
+//    requests are applied one at a time with no locking
+// 2. Postings are validated like the screens and saved
+//    with the same ledger append + journal commit
+// 3. Password hashes are verified by ServerLoginWorkers
+//    threads, so a login (tens of ms, 64 MB) never stalls
+//    the loop; the session's later requests wait in its
+//    input until the result comes back through a pipe.
+//    The Users file is read again only when it changed
+// 4. Stopping (SIGINT/SIGTERM) checkpoints Clients.txt
+//=====================================================
+
+#ifndef _WIN32
+
+// Build an OK response line
+string makeServerOk(const string& payload = "") {
+    return payload.empty() ? "OK\n" : "OK" + Separator + payload + "\n";
+}
+// Build an ERR response line
+string makeServerError(const string& message) {
+    return "ERR" + Separator + message + "\n";
+}
+// Check the logged-in teller's permission (CurrentUser is the request's teller)
+bool hasServerPermission(const strServerSession& session, Permission permission) {
+    return session.LoggedIn && hasPermission(permission);
+}
+// Users file as of its last change (read again only when its stamp moved)
+vector<strUser>& getServerUsers() {
+    // Stamp taken before reading: a change during the load is seen by the next login
+    strFileStamp stamp = readFileStamp(UsersFileName);
+    if (!ServerLogins.UsersLoaded || !sameFileStamp(stamp, ServerLogins.UsersStamp)) {
+        ServerLogins.Users = loadUsersDataFromFile(UsersFileName);
+        ServerLogins.UsersStamp = stamp;
+        ServerLogins.UsersLoaded = true;
+    }
+    return ServerLogins.Users;
+}
+// Queue a login for the password workers; the session takes no requests until it is answered
+void startServerLogin(strServerSession& session, const string& userName, const string& password) {
+    strServerLogin login;
+    login.SessionId = session.Id;
+    login.UserName = userName;
+    login.Password = password;
+    strUser* user = findUserByUsername(userName, getServerUsers());
+    if (user != nullptr) {
+        login.Known = true;
+        login.User = *user;
+    }
+
+    session.LoginPending = true;
+    lock_guard<mutex> lock(ServerLogins.Lock);
+    ServerLogins.Jobs.push_back(move(login));
+    ServerLogins.Wake.notify_one();
+}
+// Worker thread: verify queued logins and wake the poll loop with each result
+void runServerLoginWorker() {
+    unique_lock<mutex> lock(ServerLogins.Lock);
+    while (true) {
+        ServerLogins.Wake.wait(lock, [] { return ServerLogins.Stopping || !ServerLogins.Jobs.empty(); });
+        if (ServerLogins.Stopping) {
+            return;
+        }
+        strServerLogin login = move(ServerLogins.Jobs.front());
+        ServerLogins.Jobs.pop_front();
+        lock.unlock();
+
+        {
+            strMetricTimer timer(METRIC_LOGIN);
+            login.Verified = verifyUserPassword(login.Password, login.Known ? &login.User : nullptr);
+        }
+        sodium_memzero(&login.Password[0], login.Password.size());
+
+        lock.lock();
+        ServerLogins.Done.push_back(move(login));
+        char wake = 1;
+        if (write(ServerLogins.WakeFds[1], &wake, 1) < 0 && errno != EAGAIN) {
+            logMessage(string("Teller server login wake-up failed: ") + strerror(errno), ERROR_LOG);
+        }
+    }
+}
+// Apply a verified login to its session and build the response
+string completeServerLogin(strServerSession& session, const strServerLogin& login) {
+    if (!login.Verified) {
+        logLoginAttempt(login.UserName, false);
+        return makeServerError("Invalid username or password");
+    }
+
+    session.LoggedIn = true;
+    session.User = login.User;
+    CurrentUser = session.User;
+    logLoginAttempt(login.UserName, true);
+    return makeServerOk("Welcome, " + login.UserName);
+}
+// Validate, apply and persist one deposit / withdrawal / transfer request
+string handleServerPosting(string_view line, vector<strClient>& vClients) {
+    strBatchOperation operation;
+    Transaction transaction;
+    string error;
+    if (!parseBatchOperation(line, 0, operation, error)) {
+        return makeServerError(error);
+    }
+    strMetricTimer timer(getTransactionMetric(operation.Type));
+    error = applyBatchOperation(operation, vClients, transaction);
+    if (!error.empty()) {
+        return makeServerError(error);
+    }
+
+    vector<strJournalLeg> legs = buildBatchJournalLegs({ transaction });
+    try {
+        saveTransactionToFile(transaction);
+    }
+    catch (const exception& e) {
+        for (const strJournalLeg& leg : legs) {
+            findClientByAccountNumber(leg.AccountNumber, vClients)->AccountBalance -= leg.Delta;
+        }
+        logMessage(e.what(), ERROR_LOG);
+        return makeServerError("Transaction could not be saved");
+    }
+    commitBalanceChange(vClients, transaction.TransactionID, legs);
+    logTransaction(transaction);
+
+    const strClient* client = findClientByAccountNumber(transaction.FromAccount, vClients);
+    return makeServerOk(transaction.TransactionID + Separator + formatMoney(transaction.Fees) +
+        Separator + formatMoney(client->AccountBalance));
+}
+// Answer a HISTORY request: count line, then one ledger record per line
+string handleServerHistory(const string& accountNumber) {
+    strMetricTimer timer(METRIC_HISTORY);
+    vector<Transaction> transactions = loadAccountTransactions(TransactionsFileName, accountNumber);
+    string response = makeServerOk(to_string(transactions.size()));
+    for (const Transaction& transaction : transactions) {
+        response += serializeTransactionRecord(transaction) + "\n";
+    }
+    return response;
+}
+// Dispatch one request line and return its response
+string handleServerRequest(strServerSession& session, string_view line, vector<strClient>& vClients) {
+    string_view fields[3];
+    size_t count = splitFieldViews(line, Separator, fields, 3);
+    string_view command = count > 0 ? trimView(fields[0]) : string_view();
+
+    if (command == "LOGIN") {
+        if (count != 3) return makeServerError("Usage: LOGIN#//#User#//#Password");
+        startServerLogin(session, string(trimView(fields[1])), string(fields[2]));
+        return "";
+    }
+    if (command == "QUIT") {
+        session.Closing = true;
+        return makeServerOk("Bye");
+    }
+    if (!session.LoggedIn) {
+        return makeServerError("Please login first");
+    }
+
+    CurrentUser = session.User;
+    if (command == "LOGOUT") {
+        logUserAction("LOGOUT", "User logged out from teller server");
+        session.LoggedIn = false;
+        session.User = strUser();
+        return makeServerOk();
+    }
+
+    bool posting = command == "DEPOSIT" || command == "WITHDRAW" || command == "TRANSFER";
+    bool needsAccount = command == "BALANCE" || command == "FIND" || command == "HISTORY";
+    if (!posting && !needsAccount && command != "TOTAL") {
+        return makeServerError("Unknown request: " + string(command));
+    }
+
+    Permission permission = command == "FIND" ? Permission::pFindClient : Permission::pTransactions;
+    if (!hasServerPermission(session, permission)) {
+        return makeServerError("Access Denied");
+    }
+
+    if (posting) {
+        return handleServerPosting(line, vClients);
+    }
+    if (command == "TOTAL") {
+        return makeServerOk(formatMoney(sumClientBalances(vClients)));
+    }
+    if (count != 2) {
+        return makeServerError("Usage: " + string(command) + "#//#Account");
+    }
+
+    string accountNumber(trimView(fields[1]));
+    if (command == "HISTORY") {
+        return handleServerHistory(accountNumber);
+    }
+
+    const strClient* client = findClientByAccountNumber(accountNumber, vClients);
+    if (client == nullptr) {
+        return makeServerError("Account " + accountNumber + " not found");
+    }
+    if (command == "FIND") {
+        return makeServerOk(serializeClientRecord(*client, Separator));
+    }
+    return makeServerOk(client->AccountNumber + Separator + formatMoney(client->AccountBalance));
+}
+// Switch a socket to non-blocking mode
+bool setSocketNonBlocking(int socketFd) {
+    int flags = fcntl(socketFd, F_GETFL, 0);
+    return flags >= 0 && fcntl(socketFd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+// Fill a Unix socket address, false if the path does not fit
+bool makeServerAddress(const string& socketPath, sockaddr_un& address) {
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+    return true;
+}
+// Connect to a server socket, -1 if nobody is listening
+int connectToBankServer(const string& socketPath) {
+    sockaddr_un address;
+    if (!makeServerAddress(socketPath, address)) {
+        return -1;
+    }
+
+    int socketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (socketFd < 0) {
+        return -1;
+    }
+    if (connect(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(socketFd);
+        return -1;
+    }
+    return socketFd;
+}
+// Create the listening socket (owner-only), -1 on failure or if a server is already running
+int openServerSocket(const string& socketPath) {
+    sockaddr_un address;
+    if (!makeServerAddress(socketPath, address)) {
+        logMessage("Server socket path is too long: " + socketPath, ERROR_LOG);
+        return -1;
+    }
+
+    int runningServer = connectToBankServer(socketPath);
+    if (runningServer >= 0) {
+        close(runningServer);
+        logMessage("Teller server already running on " + socketPath, ERROR_LOG);
+        return -1;
+    }
+    unlink(socketPath.c_str());
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 ||
+        bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        chmod(socketPath.c_str(), 0600) != 0 ||
+        listen(listenFd, SOMAXCONN) != 0 ||
+        !setSocketNonBlocking(listenFd)) {
+        logMessage("Failed to open teller server socket " + socketPath + ": " + strerror(errno), ERROR_LOG);
+        if (listenFd >= 0) close(listenFd);
+        return -1;
+    }
+    return listenFd;
+}
+// Send as much pending output as the socket accepts, false on a broken connection
+bool flushServerSession(strServerSession& session) {
+    size_t sent = 0;
+    while (sent < session.Output.size()) {
+        ssize_t written = send(session.Socket, session.Output.data() + sent, session.Output.size() - sent, 0);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    session.Output.erase(0, sent);
+    return true;
+}
+// Answer the complete requests in a session's input, stopping at a login until it is verified
+void answerServerRequests(strServerSession& session, vector<strClient>& vClients) {
+    size_t start = 0, newline;
+    while (!session.Closing && !session.LoginPending && (newline = session.Input.find('\n', start)) != string::npos) {
+        string_view line = trimView(string_view(session.Input).substr(start, newline - start));
+        start = newline + 1;
+        if (line.empty()) continue;
+
+        session.Output += handleServerRequest(session, line, vClients);
+        ServerControl.Requests++;
+    }
+    session.Input.erase(0, start);
+}
+// Read available bytes and answer every complete request, false once the connection is done
+bool readServerSession(strServerSession& session, vector<strClient>& vClients) {
+    char buffer[16 * 1024];
+    while (true) {
+        ssize_t received = recv(session.Socket, buffer, sizeof(buffer), 0);
+        if (received == 0) return false;
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        session.Input.append(buffer, static_cast<size_t>(received));
+    }
+
+    answerServerRequests(session, vClients);
+    if (session.Input.size() > ServerMaxRequestBytes) {
+        session.Output += makeServerError("Request too long");
+        session.Closing = true;
+    }
+    return true;
+}
+// Open the wake-up pipe and start the password workers, false on failure
+bool startServerLoginWorkers() {
+    if (pipe(ServerLogins.WakeFds) != 0 ||
+        !setSocketNonBlocking(ServerLogins.WakeFds[0]) || !setSocketNonBlocking(ServerLogins.WakeFds[1])) {
+        logMessage(string("Failed to create teller server login pipe: ") + strerror(errno), ERROR_LOG);
+        return false;
+    }
+    ServerLogins.Stopping = false;
+    for (int i = 0; i < ServerLoginWorkers; i++) {
+        ServerLogins.Workers.emplace_back(runServerLoginWorker);
+    }
+    return true;
+}
+// Stop the password workers (queued logins are dropped) and close the pipe
+void stopServerLoginWorkers() {
+    {
+        lock_guard<mutex> lock(ServerLogins.Lock);
+        ServerLogins.Stopping = true;
+    }
+    ServerLogins.Wake.notify_all();
+    for (thread& worker : ServerLogins.Workers) {
+        worker.join();
+    }
+    ServerLogins.Workers.clear();
+    ServerLogins.Jobs.clear();
+    ServerLogins.Done.clear();
+    for (int& fd : ServerLogins.WakeFds) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+}
+// Hand finished logins back to their sessions and answer the requests that waited behind them
+void finishServerLogins(vector<strServerSession>& sessions, vector<strClient>& vClients) {
+    char wake[256];
+    while (read(ServerLogins.WakeFds[0], wake, sizeof(wake)) > 0) {
+    }
+    vector<strServerLogin> done;
+    {
+        lock_guard<mutex> lock(ServerLogins.Lock);
+        done.swap(ServerLogins.Done);
+    }
+
+    for (const strServerLogin& login : done) {
+        auto session = find_if(sessions.begin(), sessions.end(),
+            [&](const strServerSession& candidate) { return candidate.Id == login.SessionId; });
+        if (session == sessions.end()) {
+            continue;       // Disconnected while its password was checked
+        }
+        session->LoginPending = false;
+        session->Output += completeServerLogin(*session, login);
+        answerServerRequests(*session, vClients);
+    }
+}
+// Signal handler: ask the poll loop to stop
+void requestServerStop(int) {
+    ServerControl.StopRequested = true;
+}
+// Serve tellers until stopped; returns process exit code
+int runBankServer(const string& socketPath) {
+    int listenFd = openServerSocket(socketPath);
+    if (listenFd < 0) {
+        showErrorMessage("Cannot start teller server on " + socketPath + ". Check system log for details.");
+        return 1;
+    }
+    if (!startServerLoginWorkers()) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+        showErrorMessage("Cannot start teller server on " + socketPath + ". Check system log for details.");
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, requestServerStop);
+    signal(SIGTERM, requestServerStop);
+
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    vector<strServerSession> sessions;
+    vector<pollfd> pollFds;
+    uint64_t nextSessionId = 1;
+
+    logMessage("Teller server listening on " + socketPath, INFO);
+    cout << "Teller server listening on " << socketPath << " (Ctrl+C to stop)\n";
+    ServerControl.Ready = true;
+
+    while (!ServerControl.StopRequested) {
+        pollFds.clear();
+        pollFds.push_back({ listenFd, POLLIN, 0 });
+        pollFds.push_back({ ServerLogins.WakeFds[0], POLLIN, 0 });
+        for (const strServerSession& session : sessions) {
+            short events = static_cast<short>(session.Output.empty() ? POLLIN : POLLIN | POLLOUT);
+            pollFds.push_back({ session.Socket, events, 0 });
+        }
+
+        if (poll(pollFds.data(), pollFds.size(), 200) < 0) {
+            if (errno == EINTR) continue;
+            logMessage(string("Teller server poll failed: ") + strerror(errno), CRITICAL);
+            break;
+        }
+
+        // Answer every readable session first: their postings share one sync before any reply goes out
+        vector<bool> open(sessions.size(), true);
+        beginDurableGroup();
+        for (size_t i = 0; i < sessions.size(); i++) {
+            if (pollFds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+                open[i] = readServerSession(sessions[i], vClients);
+            }
+        }
+        if (pollFds[1].revents & POLLIN) {
+            finishServerLogins(sessions, vClients);
+        }
+        endDurableGroup();
+
+        for (size_t i = 0; i < sessions.size(); i++) {
+            strServerSession& session = sessions[i];
+            if (open[i] && !session.Output.empty()) {
+                open[i] = flushServerSession(session);
+            }
+            if (!open[i] || (session.Closing && session.Output.empty())) {
+                close(session.Socket);
+                session.Socket = -1;
+            }
+        }
+        sessions.erase(remove_if(sessions.begin(), sessions.end(),
+            [](const strServerSession& session) { return session.Socket < 0; }), sessions.end());
+
+        if (pollFds[0].revents & POLLIN) {
+            int clientFd;
+            while ((clientFd = accept(listenFd, nullptr, nullptr)) >= 0) {
+                if (!setSocketNonBlocking(clientFd)) {
+                    close(clientFd);
+                    continue;
+                }
+                strServerSession session;
+                session.Id = nextSessionId++;
+                session.Socket = clientFd;
+                sessions.push_back(move(session));
+            }
+        }
+    }
+
+    for (const strServerSession& session : sessions) {
+        close(session.Socket);
+    }
+    close(listenFd);
+    unlink(socketPath.c_str());
+    stopServerLoginWorkers();
+    ServerControl.Ready = false;
+
+    CurrentUser = strUser();
+    if (JournalState.PendingEntries > 0) {
+        saveClientsToFile(ClientsFileName, vClients);
+    }
+    logMessage("Teller server stopped after " + to_string(ServerControl.Requests.load()) + " requests", INFO);
+    logDurabilityCounters();
+    flushLogger();
+    return 0;
+}
+// Read one response line from a blocking socket, buffering any extra bytes
+bool readServerLine(int socketFd, string& buffer, string& line) {
+    size_t newline;
+    while ((newline = buffer.find('\n')) == string::npos) {
+        char chunk[4096];
+        ssize_t received = recv(socketFd, chunk, sizeof(chunk), 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(received));
+    }
+    line = buffer.substr(0, newline);
+    buffer.erase(0, newline + 1);
+    return true;
+}
+// Send one request and collect its response lines (HISTORY adds its record lines)
+bool sendServerRequest(int socketFd, string& buffer, const string& request, vector<string>& response) {
+    string message = request + "\n";
+    size_t sent = 0;
+    while (sent < message.size()) {
+        ssize_t written = send(socketFd, message.data() + sent, message.size() - sent, 0);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) return false;
+        sent += static_cast<size_t>(written);
+    }
+
+    response.clear();
+    string line;
+    if (!readServerLine(socketFd, buffer, line)) {
+        return false;
+    }
+    response.push_back(line);
+
+    string okPrefix = "OK" + Separator;
+    if (request.compare(0, 7, "HISTORY") == 0 && line.compare(0, okPrefix.size(), okPrefix) == 0) {
+        long long records = atoll(line.c_str() + okPrefix.size());
+        for (long long i = 0; i < records; i++) {
+            if (!readServerLine(socketFd, buffer, line)) return false;
+            response.push_back(line);
+        }
+    }
+    return true;
+}
+// Minimal teller client: forward typed requests and print the responses
+int runTellerClient(const string& socketPath) {
+    signal(SIGPIPE, SIG_IGN);
+    int socketFd = connectToBankServer(socketPath);
+    if (socketFd < 0) {
+        showErrorMessage("No teller server is listening on " + socketPath);
+        return 1;
+    }
+
+    cout << "Connected to " << socketPath << ". Type QUIT to leave.\n";
+    string buffer, request;
+    vector<string> response;
+    while (cout << "> " && getline(cin, request)) {
+        if (trim(request).empty()) continue;
+        if (!sendServerRequest(socketFd, buffer, request, response)) {
+            showErrorMessage("Connection to teller server lost");
+            close(socketFd);
+            return 1;
+        }
+        for (const string& line : response) {
+            cout << line << "\n";
+        }
+        if (trim(request) == "QUIT") break;
+    }
+    close(socketFd);
+    return 0;
+}
+
+#else
+
+// Windows builds have no Unix domain sockets; server mode is not available
+int runBankServer(const string& socketPath) {
+    showErrorMessage("Teller server mode needs Unix domain sockets (Linux/macOS): " + socketPath);
+    return 1;
+}
+// Windows builds have no Unix domain sockets; teller client is not available
+int runTellerClient(const string& socketPath) {
+    showErrorMessage("Teller client mode needs Unix domain sockets (Linux/macOS): " + socketPath);
+    return 1;
+}
+
+#endif
@@ -96,6 +96,26 @@ string getSessionFolder() {
 }
 #endif
 
+// Session path resolved once per process
+const string& getCachedSessionPath() {
+    if (SessionCache.SessionPath.empty()) {
+        SessionCache.SessionPath = getSessionPath();
+    }
+    return SessionCache.SessionPath;
+}
+// Record mtime, inode and size of the session file as seen now
+void rememberSessionFileStamp() {
+    SessionCache.Stamp = readFileStamp(getCachedSessionPath());
+    SessionCache.Checked = true;
+}
+// Check whether the session file is unchanged since it was last examined (records new stamp)
+bool isSessionCacheCurrent() {
+    bool checked = SessionCache.Checked;
+    strFileStamp previous = SessionCache.Stamp;
+
+    rememberSessionFileStamp();
+    return checked && sameFileStamp(previous, SessionCache.Stamp);
+}
 // Create session folder if not exists
 void createSessionFolder() {
     string folder = getSessionFolder();
@@ -111,12 +131,11 @@ void createSessionFolder() {
 // Save current user session encrypted to file
 void saveCurrentUserSession(const strUser& user) {
     createSessionFolder();
-    string sessionPath = getSessionPath();
+    const string& sessionPath = getCachedSessionPath();
 
     try {
-        vector<unsigned char> key = getEncryptionKey();
         string userData = serializeUserData(user);
-        string encryptedData = encryptData(userData, key);
+        string encryptedData = encryptData(userData, getCachedEncryptionKey());
 
         ofstream file(sessionPath, ios::binary);
         if (file.is_open()) {
@@ -124,15 +143,20 @@ void saveCurrentUserSession(const strUser& user) {
             file.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
             file.write(encryptedData.c_str(), dataSize);
             file.close();
+
+            // The file now holds exactly this user; no need to decrypt it again
+            SessionCache.User = user;
+            SessionCache.HasSession = true;
+            rememberSessionFileStamp();
         }
     }
     catch (const exception& e) {
         showErrorMessage("Error: " + string(e.what()));
     }
 }
-// Load and decrypt current user session from file
-bool loadCurrentUserSession(strUser& user) {
-    string sessionPath = getSessionPath();
+// Read and decrypt session file (stamp already recorded by the caller)
+bool decryptSessionFile(strUser& user) {
+    const string& sessionPath = getCachedSessionPath();
 
     ifstream file(sessionPath, ios::binary | ios::ate);
     if (!file.is_open()) {
@@ -148,8 +172,6 @@ bool loadCurrentUserSession(strUser& user) {
     file.seekg(0);
 
     try {
-        vector<unsigned char> key = getEncryptionKey();
-
         size_t dataSize;
         file.read(reinterpret_cast<char*>(&dataSize), sizeof(dataSize));
 
@@ -162,7 +184,15 @@ bool loadCurrentUserSession(strUser& user) {
         file.read(&encryptedData[0], dataSize);
         file.close();
 
-        string decryptedData = decryptData(encryptedData, key);
+        string decryptedData;
+        try {
+            decryptedData = decryptData(encryptedData, getCachedEncryptionKey());
+        }
+        catch (const exception&) {
+            // Key file may have been replaced since it was cached; retry once from disk
+            releaseCachedEncryptionKey();
+            decryptedData = decryptData(encryptedData, getCachedEncryptionKey());
+        }
 
         if (decryptedData.empty() || decryptedData.find('\n') == string::npos) {
             return false;
@@ -181,9 +211,19 @@ bool loadCurrentUserSession(strUser& user) {
         return false;
     }
 }
+// Load current user session: cached copy while the file is unchanged, else decrypt from file
+bool loadCurrentUserSession(strUser& user) {
+    if (!isSessionCacheCurrent()) {
+        SessionCache.HasSession = decryptSessionFile(SessionCache.User);
+    }
+    if (SessionCache.HasSession) {
+        user = SessionCache.User;
+    }
+    return SessionCache.HasSession;
+}
 // Securely clear and remove session file
 void clearCurrentUserSession() {
-    string sessionPath = getSessionPath();
+    const string& sessionPath = getCachedSessionPath();
 
     fstream file(sessionPath, ios::binary | ios::out | ios::in);
     if (file.is_open()) {
@@ -216,6 +256,9 @@ void clearCurrentUserSession() {
     }
 
     CurrentUser = strUser();
+    SessionCache.User = strUser();
+    SessionCache.HasSession = false;
+    rememberSessionFileStamp();
 }
 // Convert user struct to string for session storage
 string serializeUserData(const strUser& user) {
@@ -0,0 +1,411 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: TransactionIdIndex.h                             ||
+//  || Section: Transaction ID Index                          ||
+//  || On-disk hash table from transaction ID to ledger       ||
+//  || offset, so one record is found without a ledger scan.  ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "HashIndex.h"
+#include "FileManager.h"
+#include "BinaryClients.h"
+#include "Ledger.h"
+#include "LedgerView.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//=====================================================
+//================ Transaction ID Index ===============
+// <Transactions>.tid is an open-addressing hash table
+// that is used in place, never loaded:
+// 1. A 64-byte header (slot count, entries, ledger bytes
+//    covered, CRC-32), then 16-byte slots holding the
+//    hash of an ID and the logical offset of its record
+// 2. A lookup reads TransactionIdsProbeSlots slots per
+//    positioned read from the ID's home slot on, and
+//    checks the ID of every record whose hash matches;
+//    the table is kept at most 3/4 full, so that is one
+//    read in nearly every case, whatever the ledger size
+// 3. saveTransactionToFile() writes the new slot, then
+//    the header; a full table is doubled into a new file
+//    (tmp, then rename) from its own slots
+// 4. Ledger lines the header does not cover are indexed
+//    on the next lookup (adding a record twice is a
+//    no-op); a missing or damaged file is rebuilt with
+//    one scan of the ledger
+// 5. An ID is indexed once: a later record with the same
+//    ID is refused (logged), so lookups find the first
+//=====================================================
+
+// Build the ID table file name for a ledger file
+string getTransactionIdIndexFileName(const string& ledgerFileName) {
+    return ledgerFileName + TransactionIdsExtension;
+}
+// Hash of a transaction ID (FNV-1a with a final mix: IDs differ mostly in their last characters), never 0
+uint64_t hashTransactionId(string_view transactionID) {
+    uint64_t hash = hashIndexKey(transactionID);
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash == 0 ? 1 : hash;
+}
+// Transaction ID field of a ledger line
+string_view getLedgerLineTransactionId(string_view line) {
+    return trimView(line.substr(0, line.find(Separator)));
+}
+// Close the table file and forget it (it is opened again on next use)
+void closeTransactionIdIndex() {
+    if (TransactionIds.Fd >= 0) {
+#ifdef _WIN32
+        _close(TransactionIds.Fd);
+#else
+        close(TransactionIds.Fd);
+#endif
+    }
+    TransactionIds.Fd = -1;
+    TransactionIds.LedgerFile.clear();
+}
+// Read bytes at a table file offset with one positioned read, false on failure
+bool readTransactionIdBytes(long long offset, void* data, size_t size) {
+#ifdef _WIN32
+    return _lseeki64(TransactionIds.Fd, offset, SEEK_SET) == offset &&
+        _read(TransactionIds.Fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+#else
+    return pread(TransactionIds.Fd, data, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+#endif
+}
+// Write bytes at a table file offset with one positioned write, false on failure
+bool writeTransactionIdBytes(long long offset, const void* data, size_t size) {
+#ifdef _WIN32
+    bool written = _lseeki64(TransactionIds.Fd, offset, SEEK_SET) == offset &&
+        _write(TransactionIds.Fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+#else
+    bool written = pwrite(TransactionIds.Fd, data, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+#endif
+    if (!written) {
+        logMessage("Transaction ID index write failed at offset " + to_string(offset) + ": " +
+            TransactionIds.FileName, ERROR_LOG);
+    }
+    return written;
+}
+// File offset of a table slot (the header comes first)
+long long getTransactionIdSlotOffset(uint64_t slot) {
+    return static_cast<long long>(sizeof(strTransactionIdHeader) + slot * sizeof(strTransactionIdSlot));
+}
+// Header for the current table size and ledger coverage
+strTransactionIdHeader buildTransactionIdHeader() {
+    strTransactionIdHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.Magic, TransactionIdsMagic, sizeof(header.Magic));
+    header.Version = TransactionIdsVersion;
+    header.SlotSize = sizeof(strTransactionIdSlot);
+    header.SlotCount = TransactionIds.SlotCount;
+    header.Entries = TransactionIds.Entries;
+    header.IndexedBytes = TransactionIds.IndexedBytes;
+    header.Checksum = computeRecordChecksum(header);
+    return header;
+}
+// Write the header in place
+bool writeTransactionIdHeader() {
+    strTransactionIdHeader header = buildTransactionIdHeader();
+    return writeTransactionIdBytes(0, &header, sizeof(header));
+}
+// Read and check the header of the open file (another process may have added records); false if damaged
+bool readTransactionIdHeader(long long fileSize) {
+    strTransactionIdHeader header;
+    if (!readTransactionIdBytes(0, &header, sizeof(header)) ||
+        memcmp(header.Magic, TransactionIdsMagic, sizeof(header.Magic)) != 0 ||
+        header.Version != TransactionIdsVersion || header.SlotSize != sizeof(strTransactionIdSlot) ||
+        header.Checksum != computeRecordChecksum(header) ||
+        header.SlotCount < TransactionIdsMinSlots || (header.SlotCount & (header.SlotCount - 1)) != 0 ||
+        header.Entries >= header.SlotCount || header.IndexedBytes < 0 ||
+        (fileSize >= 0 && fileSize != getTransactionIdSlotOffset(header.SlotCount))) {
+        return false;
+    }
+
+    TransactionIds.SlotCount = header.SlotCount;
+    TransactionIds.Entries = header.Entries;
+    TransactionIds.IndexedBytes = header.IndexedBytes;
+    return true;
+}
+// Open the table file of a ledger for positioned reads and writes, false if missing or damaged
+bool openTransactionIdIndex(const string& ledgerFileName) {
+    closeTransactionIdIndex();
+    TransactionIds.FileName = getTransactionIdIndexFileName(ledgerFileName);
+
+    strFileStamp stamp = readFileStamp(TransactionIds.FileName);
+    if (!stamp.Exists) {
+        return false;
+    }
+#ifdef _WIN32
+    TransactionIds.Fd = _open(TransactionIds.FileName.c_str(), _O_RDWR | _O_BINARY);
+#else
+    TransactionIds.Fd = open(TransactionIds.FileName.c_str(), O_RDWR | O_CLOEXEC);
+#endif
+    if (TransactionIds.Fd < 0 || !readTransactionIdHeader(stamp.Size)) {
+        closeTransactionIdIndex();
+        return false;
+    }
+    TransactionIds.LedgerFile = ledgerFileName;
+    return true;
+}
+// Slot count for entries with the table at most 3/4 full
+uint64_t getTransactionIdTableSize(uint64_t entries) {
+    uint64_t slotCount = TransactionIdsMinSlots;
+    while (entries * 4 > slotCount * 3) {
+        slotCount *= 2;
+    }
+    return slotCount;
+}
+// True if a ledger line repeats the transaction ID of an earlier one (equal hashes can be different IDs)
+bool isDuplicateTransactionId(const string& ledgerFileName, long long firstOffset, long long offset) {
+    strLedgerReader reader;
+    string first, line;
+    if (!readLedgerLine(reader, ledgerFileName, firstOffset, first) || !readLedgerLine(reader, ledgerFileName, offset, line) ||
+        getLedgerLineTransactionId(first) != getLedgerLineTransactionId(line)) {
+        return false;
+    }
+    logMessage("Transaction ID " + string(getLedgerLineTransactionId(line)) + " at ledger offset " + to_string(offset) +
+        " was already used at offset " + to_string(firstOffset) + "; the second record is not indexed", ERROR_LOG);
+    return true;
+}
+// Insert a record into an in-memory table unless it or its ID is there already; true if added
+bool insertTransactionIdSlot(vector<strTransactionIdSlot>& slots, uint64_t hash, long long offset,
+    const string& ledgerFileName) {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (slots[slot].Hash != 0) {
+        if (slots[slot].Hash == hash &&
+            (slots[slot].Offset == offset || isDuplicateTransactionId(ledgerFileName, slots[slot].Offset, offset))) {
+            return false;
+        }
+        slot = (slot + 1) & mask;
+    }
+    slots[slot] = { hash, offset };
+    return true;
+}
+// Write a complete table (tmp, then rename) and open it; false on failure
+bool writeTransactionIdTable(const string& ledgerFileName, const vector<strTransactionIdSlot>& slots,
+    uint64_t entries, long long indexedBytes) {
+    closeTransactionIdIndex();
+    string fileName = getTransactionIdIndexFileName(ledgerFileName);
+    string tempFile = fileName + ".tmp";
+    ofstream out(tempFile, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open temp file for writing: " + tempFile, ERROR_LOG);
+        return false;
+    }
+
+    TransactionIds.SlotCount = slots.size();
+    TransactionIds.Entries = entries;
+    TransactionIds.IndexedBytes = indexedBytes;
+    strTransactionIdHeader header = buildTransactionIdHeader();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(slots.data()), static_cast<streamsize>(slots.size() * sizeof(slots[0])));
+    out.close();
+    if (!out) {
+        logMessage("Failed to write transaction ID index: " + tempFile, ERROR_LOG);
+        remove(tempFile.c_str());
+        return false;
+    }
+    syncBeforeRename(tempFile);
+
+#ifdef _WIN32
+    remove(fileName.c_str());
+#endif
+
+    if (rename(tempFile.c_str(), fileName.c_str()) != 0) {
+        logMessage("Failed to rename transaction ID index: " + fileName, ERROR_LOG);
+        return false;
+    }
+    syncAfterRename(fileName);
+    return openTransactionIdIndex(ledgerFileName);
+}
+// Rebuild the table from a full ledger scan
+bool rebuildTransactionIdIndex(const string& ledgerFileName) {
+    vector<strTransactionIdSlot> records;
+    long long indexedBytes = 0;
+    forEachLedgerLine(ledgerFileName, 0, [&](long long offset, long long nextOffset, string_view line) {
+        string_view transactionID = getLedgerLineTransactionId(line);
+        if (!transactionID.empty()) {
+            records.push_back({ hashTransactionId(transactionID), offset });
+        }
+        indexedBytes = nextOffset;
+    });
+
+    vector<strTransactionIdSlot> slots(getTransactionIdTableSize(records.size()), strTransactionIdSlot{ 0, 0 });
+    uint64_t entries = 0;
+    for (const strTransactionIdSlot& record : records) {
+        entries += insertTransactionIdSlot(slots, record.Hash, record.Offset, ledgerFileName) ? 1 : 0;
+    }
+    records = vector<strTransactionIdSlot>();
+
+    if (!writeTransactionIdTable(ledgerFileName, slots, entries, indexedBytes)) {
+        return false;
+    }
+    logMessage("Rebuilt transaction ID index (" + to_string(entries) + " records, " +
+        to_string(slots.size()) + " slots)", INFO);
+    return true;
+}
+// Double the table: its slots are read in blocks and placed in a new file
+bool growTransactionIdIndex() {
+    string ledgerFileName = TransactionIds.LedgerFile;
+    uint64_t oldCount = TransactionIds.SlotCount;
+    vector<strTransactionIdSlot> slots(oldCount * 2, strTransactionIdSlot{ 0, 0 });
+    vector<strTransactionIdSlot> block(min<uint64_t>(oldCount, 65536));
+
+    for (uint64_t first = 0; first < oldCount; first += block.size()) {
+        size_t count = static_cast<size_t>(min<uint64_t>(block.size(), oldCount - first));
+        if (!readTransactionIdBytes(getTransactionIdSlotOffset(first), block.data(), count * sizeof(block[0]))) {
+            logMessage("Failed to read transaction ID index: " + TransactionIds.FileName, ERROR_LOG);
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (block[i].Hash != 0) {
+                insertTransactionIdSlot(slots, block[i].Hash, block[i].Offset, ledgerFileName);
+            }
+        }
+    }
+    return writeTransactionIdTable(ledgerFileName, slots, TransactionIds.Entries, TransactionIds.IndexedBytes);
+}
+// Add one record to the open table (doubling it first when 3/4 full); an ID already in it is refused and
+// counts as done. False on failure
+bool addTransactionIdEntry(uint64_t hash, long long offset) {
+    if ((TransactionIds.Entries + 1) * 4 > TransactionIds.SlotCount * 3 && !growTransactionIdIndex()) {
+        return false;
+    }
+
+    uint64_t mask = TransactionIds.SlotCount - 1;
+    uint64_t slot = hash & mask;
+    strTransactionIdSlot block[TransactionIdsProbeSlots];
+    for (uint64_t probed = 0; probed < TransactionIds.SlotCount;) {
+        size_t count = static_cast<size_t>(min<uint64_t>(TransactionIdsProbeSlots, TransactionIds.SlotCount - slot));
+        if (!readTransactionIdBytes(getTransactionIdSlotOffset(slot), block, count * sizeof(block[0]))) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (block[i].Hash == hash && (block[i].Offset == offset ||
+                isDuplicateTransactionId(TransactionIds.LedgerFile, block[i].Offset, offset))) {
+                return true;
+            }
+            if (block[i].Hash == 0) {
+                strTransactionIdSlot record = { hash, offset };
+                if (!writeTransactionIdBytes(getTransactionIdSlotOffset(slot + i), &record, sizeof(record))) {
+                    return false;
+                }
+                TransactionIds.Entries++;
+                return true;
+            }
+        }
+        probed += count;
+        slot = (slot + count) & mask;
+    }
+    return false;
+}
+// Add ledger lines from the header's coverage to the ledger end, then write the header
+bool indexTransactionIdTail(const string& ledgerFileName) {
+    bool added = true;
+    forEachLedgerLine(ledgerFileName, TransactionIds.IndexedBytes,
+        [&](long long offset, long long nextOffset, string_view line) {
+        if (!added) return;
+        string_view transactionID = getLedgerLineTransactionId(line);
+        added = transactionID.empty() || addTransactionIdEntry(hashTransactionId(transactionID), offset);
+        if (added) {
+            TransactionIds.IndexedBytes = nextOffset;
+        }
+    });
+    return writeTransactionIdHeader() && added;
+}
+// Make sure the table is open and covers the whole ledger; false if it cannot be used
+bool ensureTransactionIdIndex(const string& ledgerFileName) {
+    long long ledgerSize = getLedgerSize(ledgerFileName);
+
+    bool current = TransactionIds.LedgerFile == ledgerFileName && TransactionIds.Fd >= 0 && readTransactionIdHeader(-1);
+    if (!current && !openTransactionIdIndex(ledgerFileName)) {
+        return rebuildTransactionIdIndex(ledgerFileName);
+    }
+
+    // Coverage past the end means the ledger was replaced, not appended to
+    if (TransactionIds.IndexedBytes > ledgerSize) {
+        return rebuildTransactionIdIndex(ledgerFileName);
+    }
+    if (TransactionIds.IndexedBytes < ledgerSize && !indexTransactionIdTail(ledgerFileName)) {
+        closeTransactionIdIndex();
+        return false;
+    }
+    return true;
+}
+// Index ledger lines just appended together (offsets holds each line start plus the end)
+void appendTransactionIds(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<long long>& offsets) {
+    if (transactions.empty() || offsets.size() != transactions.size() + 1) {
+        return;
+    }
+
+    // No table yet is left to the first lookup; one that does not end at the first line is caught up there
+    bool open = TransactionIds.LedgerFile == ledgerFileName && TransactionIds.Fd >= 0 ?
+        readTransactionIdHeader(-1) : openTransactionIdIndex(ledgerFileName);
+    if (!open || TransactionIds.IndexedBytes != offsets.front()) {
+        return;
+    }
+
+    for (size_t i = 0; i < transactions.size(); i++) {
+        if (!addTransactionIdEntry(hashTransactionId(transactions[i].TransactionID), offsets[i])) {
+            closeTransactionIdIndex();
+            return;
+        }
+    }
+    TransactionIds.IndexedBytes = offsets.back();
+    if (!writeTransactionIdHeader()) {
+        closeTransactionIdIndex();
+    }
+}
+// Find a ledger record by transaction ID through the table: one slot read and one line read in nearly every case
+bool findTransactionById(const string& ledgerFileName, const string& transactionID, Transaction& found) {
+    TransactionIds.Lookups++;
+    if (transactionID.empty()) {
+        return false;
+    }
+    if (!ensureTransactionIdIndex(ledgerFileName)) {
+        logMessage("Transaction ID index unavailable, scanning the ledger for " + transactionID, WARNING);
+        return findLedgerTransaction(ledgerFileName, transactionID, found);
+    }
+
+    uint64_t hash = hashTransactionId(transactionID);
+    uint64_t mask = TransactionIds.SlotCount - 1;
+    uint64_t slot = hash & mask;
+    strTransactionIdSlot block[TransactionIdsProbeSlots];
+    strLedgerReader reader;
+    string line, error;
+
+    for (uint64_t probed = 0; probed < TransactionIds.SlotCount;) {
+        size_t count = static_cast<size_t>(min<uint64_t>(TransactionIdsProbeSlots, TransactionIds.SlotCount - slot));
+        TransactionIds.Probes++;
+        if (!readTransactionIdBytes(getTransactionIdSlotOffset(slot), block, count * sizeof(block[0]))) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (block[i].Hash == 0) {
+                return false;
+            }
+            if (block[i].Hash == hash && readLedgerLine(reader, ledgerFileName, block[i].Offset, line) &&
+                getLedgerLineTransactionId(line) == transactionID && parseTransactionRecord(line, found, error)) {
+                return true;
+            }
+        }
+        probed += count;
+        slot = (slot + count) & mask;
+    }
+    return false;
+}
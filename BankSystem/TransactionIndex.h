@@ -0,0 +1,331 @@
+#pragma once
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  || File: TransactionIndex.h                               ||
+//  || Section: Transaction Index                             ||
+//  || Sidecar index of ledger byte offsets per account, so   ||
+//  || one account's history is read without a full scan.     ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "Logger.h"
+#include "FileManager.h"
+#include "AccountDictionary.h"
+#include "Ledger.h"
+#include "LedgerView.h"
+
+//=====================================================
+//================= Transaction Index =================
+// <Transactions>.idx holds one line per ledger record
+// (offsets are logical offsets across all segments):
+//   Offset#//#NextOffset#//#FromId#//#ToId
+// where the ids come from the account dictionary (ToId
+// is empty when the record has no second account); in
+// memory each account id has a vector of offsets.
+// 1. saveTransactionToFile() appends an entry right after
+//    the ledger line, when the sidecar ends where the
+//    ledger did before the append
+// 2. The first history query loads the sidecar into
+//    memory and indexes any ledger tail it does not cover
+// 3. A missing or inconsistent sidecar is rebuilt with
+//    one scan of the ledger
+//=====================================================
+
+// Build index file name for a ledger file
+string getTransactionIndexFileName(const string& ledgerFileName) {
+    return ledgerFileName + ".idx";
+}
+// Convert index entry to file line
+string serializeTransactionIndexRecord(long long offset, long long nextOffset,
+    uint32_t fromId, uint32_t toId, const string& separator = Separator) {
+    return to_string(offset) + separator + to_string(nextOffset) + separator +
+        to_string(fromId) + separator + (toId == NoAccountId ? string() : to_string(toId));
+}
+// Parse an account id field ("" = NoAccountId), false if malformed
+bool parseAccountIdField(string_view field, uint32_t& id) {
+    if (field.empty()) {
+        id = NoAccountId;
+        return true;
+    }
+    const char* end = field.data() + field.size();
+    return from_chars(field.data(), end, id).ptr == end && id != NoAccountId;
+}
+// Convert file line to index entry, false if malformed
+bool deserializeTransactionIndexRecord(string_view line, long long& offset, long long& nextOffset,
+    uint32_t& fromId, uint32_t& toId, string_view separator = Separator) {
+    string_view fields[4];
+    if (splitFieldViews(line, separator, fields, 4) < 3) {
+        return false;
+    }
+
+    const char* end = fields[0].data() + fields[0].size();
+    if (from_chars(fields[0].data(), end, offset).ptr != end) return false;
+    end = fields[1].data() + fields[1].size();
+    if (from_chars(fields[1].data(), end, nextOffset).ptr != end) return false;
+
+    return parseAccountIdField(fields[2], fromId) && fromId != NoAccountId &&
+        parseAccountIdField(fields[3], toId) && offset < nextOffset;
+}
+// Record one ledger line under both of its accounts in the in-memory index
+void addToTransactionIndex(long long offset, uint32_t fromId, uint32_t toId) {
+    vector<vector<long long>>& offsets = TransactionIndex.Offsets;
+    size_t needed = max<size_t>(fromId, toId == NoAccountId ? 0 : toId) + 1;
+    if (offsets.size() < needed) {
+        offsets.resize(max(needed, getAccountIdCount()));
+    }
+
+    offsets[fromId].push_back(offset);
+    if (toId != NoAccountId && toId != fromId) {
+        offsets[toId].push_back(offset);
+    }
+}
+// Read NextOffset of the last sidecar entry: 0 if empty or missing, -1 if unreadable
+long long readLastIndexedOffset(const string& indexFileName) {
+    ifstream file(indexFileName, ios::binary | ios::ate);
+    if (!file.is_open()) {
+        return 0;
+    }
+
+    long long size = file.tellg();
+    if (size <= 0) {
+        return 0;
+    }
+
+    long long tailSize = min<long long>(size, 512);
+    string tail(static_cast<size_t>(tailSize), '\0');
+    file.seekg(size - tailSize);
+    file.read(&tail[0], tailSize);
+
+    while (!tail.empty() && (tail.back() == '\n' || tail.back() == '\r')) tail.pop_back();
+    size_t lineStart = tail.rfind('\n');
+    string_view lastLine = string_view(tail).substr(lineStart == string::npos ? 0 : lineStart + 1);
+
+    long long offset, nextOffset;
+    uint32_t fromId, toId;
+    if (!deserializeTransactionIndexRecord(lastLine, offset, nextOffset, fromId, toId)) {
+        return -1;
+    }
+    return nextOffset;
+}
+// Scan ledger lines from startOffset, index them and return their sidecar lines (new account ids are stored first)
+string indexLedgerTail(const string& ledgerFileName, long long startOffset) {
+    string entries;
+
+    forEachLedgerLine(ledgerFileName, startOffset, [&](long long offset, long long nextOffset, string_view line) {
+        string_view fields[4];
+        if (splitFieldViews(trimView(line), Separator, fields, 4) >= 4 && !trimView(fields[2]).empty()) {
+            uint32_t fromId = internAccountId(trimView(fields[2]));
+            uint32_t toId = internAccountId(trimView(fields[3]));
+            addToTransactionIndex(offset, fromId, toId);
+            entries += serializeTransactionIndexRecord(offset, nextOffset, fromId, toId) + "\n";
+        }
+        TransactionIndex.IndexedBytes = nextOffset;
+    });
+    flushAccountDictionary();
+    return entries;
+}
+// Rebuild the sidecar from a full ledger scan
+void rebuildTransactionIndex(const string& ledgerFileName) {
+    TransactionIndex.Offsets.assign(getAccountIdCount(), vector<long long>());
+    TransactionIndex.LedgerFile = ledgerFileName;
+    TransactionIndex.IndexedBytes = 0;
+
+    string entries = indexLedgerTail(ledgerFileName, 0);
+
+    string indexFile = getTransactionIndexFileName(ledgerFileName);
+    string tempFile = indexFile + ".tmp";
+    ofstream out(tempFile, ios::binary | ios::trunc);
+    if (!out.is_open()) {
+        logMessage("Failed to open transaction index for writing: " + tempFile, ERROR_LOG);
+        return;
+    }
+    out << entries;
+    out.close();
+
+#ifdef _WIN32
+    remove(indexFile.c_str());
+#endif
+
+    if (rename(tempFile.c_str(), indexFile.c_str()) != 0) {
+        logMessage("Failed to rename transaction index: " + indexFile, ERROR_LOG);
+        return;
+    }
+    logMessage("Rebuilt transaction index (" + to_string(TransactionIndex.IndexedBytes) + " ledger bytes)", INFO);
+}
+// Check that the ledger line at offset still spans to nextOffset and names the same accounts
+bool ledgerRecordMatches(const string& ledgerFileName, long long offset, long long nextOffset,
+    uint32_t fromId, uint32_t toId) {
+    strLedgerReader reader;
+    string line;
+    if (!readLedgerLine(reader, ledgerFileName, offset, line) ||
+        offset + static_cast<long long>(line.size()) + 1 > nextOffset) {
+        return false;
+    }
+
+    string_view fields[4];
+    return splitFieldViews(trimView(line), Separator, fields, 4) >= 4 &&
+        trimView(fields[2]) == getAccountNumberById(fromId) && trimView(fields[3]) == getAccountNumberById(toId);
+}
+// Load sidecar into memory, false if missing or inconsistent with the ledger
+bool loadTransactionIndex(const string& ledgerFileName, long long ledgerSize) {
+    string content;
+    if (!readFileToString(getTransactionIndexFileName(ledgerFileName), content)) {
+        return false;
+    }
+
+    // Entries another process appended may name ids it gave since the dictionary was read
+    refreshAccountDictionary();
+    size_t accountIds = getAccountIdCount();
+    TransactionIndex.Offsets.assign(accountIds, vector<long long>());
+    TransactionIndex.LedgerFile = ledgerFileName;
+    TransactionIndex.IndexedBytes = 0;
+
+    // Ids the dictionary does not have were written by another dictionary
+    uint32_t fromId = 0, toId = NoAccountId;
+    long long offset = 0, nextOffset = 0;
+    long long lastOffset = -1;
+    bool valid = true;
+
+    forEachLine(content, [&](string_view line) {
+        if (!valid || trimView(line).empty()) return;
+
+        if (!deserializeTransactionIndexRecord(trimView(line), offset, nextOffset, fromId, toId) ||
+            offset < TransactionIndex.IndexedBytes || nextOffset > ledgerSize ||
+            fromId >= accountIds || (toId != NoAccountId && toId >= accountIds)) {
+            valid = false;
+            return;
+        }
+        addToTransactionIndex(offset, fromId, toId);
+        TransactionIndex.IndexedBytes = nextOffset;
+        lastOffset = offset;
+    });
+    if (!valid) {
+        return false;
+    }
+
+    // Cheap guard against a ledger that was replaced rather than appended to
+    return lastOffset < 0 ||
+        ledgerRecordMatches(ledgerFileName, lastOffset, TransactionIndex.IndexedBytes, fromId, toId);
+}
+// Make sure the in-memory index covers the whole ledger
+void ensureTransactionIndex(const string& ledgerFileName) {
+    long long ledgerSize = getLedgerSize(ledgerFileName);
+
+    bool loaded = TransactionIndex.LedgerFile == ledgerFileName &&
+        TransactionIndex.IndexedBytes >= 0 && TransactionIndex.IndexedBytes <= ledgerSize;
+    if (!loaded && !loadTransactionIndex(ledgerFileName, ledgerSize)) {
+        rebuildTransactionIndex(ledgerFileName);
+        return;
+    }
+    if (TransactionIndex.IndexedBytes == ledgerSize) {
+        return;
+    }
+
+    // Ledger lines written without an index entry (crash, older version, failed append)
+    string entries = indexLedgerTail(ledgerFileName, TransactionIndex.IndexedBytes);
+    if (!entries.empty()) {
+        ofstream out(getTransactionIndexFileName(ledgerFileName), ios::binary | ios::app);
+        out << entries;
+    }
+}
+// Index ledger lines just appended together (offsets holds each line start plus the end)
+void appendRecordsToTransactionIndex(const string& ledgerFileName, const vector<Transaction>& transactions,
+    const vector<long long>& offsets) {
+    if (transactions.empty() || offsets.size() != transactions.size() + 1) {
+        return;
+    }
+
+    string indexFile = getTransactionIndexFileName(ledgerFileName);
+    bool inMemory = TransactionIndex.LedgerFile == ledgerFileName && TransactionIndex.IndexedBytes == offsets.front();
+
+    // A sidecar that does not end at the first line's offset is caught up on the next query
+    if (!inMemory && readLastIndexedOffset(indexFile) != offsets.front()) {
+        return;
+    }
+
+    string entries;
+    for (size_t i = 0; i < transactions.size(); i++) {
+        const Transaction& transaction = transactions[i];
+        uint32_t fromId = internAccountId(transaction.FromAccount);
+        uint32_t toId = internAccountId(transaction.ToAccount);
+        if (fromId == NoAccountId) continue;
+        if (inMemory) {
+            addToTransactionIndex(offsets[i], fromId, toId);
+        }
+        entries += serializeTransactionIndexRecord(offsets[i], offsets[i + 1], fromId, toId) + "\n";
+    }
+    if (inMemory) {
+        TransactionIndex.IndexedBytes = offsets.back();
+    }
+
+    // A sidecar entry must never name an id the dictionary file lacks
+    if (!flushAccountDictionary()) {
+        TransactionIndex.IndexedBytes = -1;
+        return;
+    }
+
+    ofstream out(indexFile, ios::binary | ios::app);
+    out << entries;
+    if (!out) {
+        logMessage("Failed to append to transaction index: " + indexFile, WARNING);
+        TransactionIndex.IndexedBytes = -1;
+    }
+}
+// Number of ledger records of an account the index knows of
+size_t countAccountTransactions(const string& accountNumber) {
+    uint32_t accountId = getAccountId(accountNumber);
+    return accountId < TransactionIndex.Offsets.size() ? TransactionIndex.Offsets[accountId].size() : 0;
+}
+// Index a ledger line just appended by saveTransactionToFile
+void appendToTransactionIndex(const string& ledgerFileName, long long offset, long long nextOffset,
+    const Transaction& transaction) {
+    appendRecordsToTransactionIndex(ledgerFileName, { transaction }, { offset, nextOffset });
+}
+// Load the ledger records of one account in file order (only the last lastCount, 0 = all), via the index
+// and a mapped ledger view
+vector<Transaction> loadAccountTransactions(const string& ledgerFileName, const string& accountNumber,
+    bool allowRebuild = true, size_t lastCount = 0) {
+    vector<Transaction> transactions;
+    ensureTransactionIndex(ledgerFileName);
+
+    uint32_t accountId = getAccountId(accountNumber);
+    if (accountId >= TransactionIndex.Offsets.size() || TransactionIndex.Offsets[accountId].empty()) {
+        return transactions;
+    }
+    const vector<long long>& accountOffsets = TransactionIndex.Offsets[accountId];
+    size_t first = (lastCount == 0 || lastCount >= accountOffsets.size()) ? 0 : accountOffsets.size() - lastCount;
+
+    strLedgerView view;
+    openLedgerView(ledgerFileName, view);
+    string_view line;
+    string error;
+    strTransactionView record;
+    transactions.reserve(accountOffsets.size() - first);
+    bool stale = false;
+
+    for (size_t i = first; i < accountOffsets.size(); i++) {
+        long long offset = accountOffsets[i];
+        if (!readLedgerViewLine(view, offset, line)) break;
+
+        if (!parseTransactionView(line, record, error)) {
+            logMessage(error, ERROR_LOG);
+            continue;
+        }
+        if (record.FromAccount != accountNumber && record.ToAccount != accountNumber) {
+            if (!allowRebuild) continue;
+            stale = true;
+            break;
+        }
+        transactions.push_back(toTransaction(record));
+    }
+    closeLedgerView(view);
+
+    if (stale) {
+        logMessage("Transaction index out of date, rebuilding", WARNING);
+        rebuildTransactionIndex(ledgerFileName);
+        return loadAccountTransactions(ledgerFileName, accountNumber, false, lastCount);
+    }
+    return transactions;
+}
@@ -10,38 +10,35 @@
 
 #include "Globals.h"
 #include "Utilities.h"
+#include "ScreenRenderer.h"
 #include "InputManager.h"
 #include "FileManager.h"
+#include "Journal.h"
+#include "TransactionIndex.h"
+#include "RecentTransactions.h"
+#include "Ledger.h"
+#include "TransactionIdIndex.h"
+#include "IdGenerator.h"
 #include "Logger.h"
+#include "Metrics.h"
 #include "ClientManager.h"
+#include "ClientColumns.h"
 
 //=====================================================
 //=============== Transactions Manager ================
 //=====================================================
 
-// Generate unique transaction ID
-string generateTransactionID() {
-    auto now = chrono::high_resolution_clock::now();
-    auto timestamp = chrono::duration_cast<chrono::microseconds>(
-        now.time_since_epoch()).count();
-
-    uint32_t randomNum = randombytes_random();
-
-    stringstream ss;
-    ss << "TXN" << timestamp << hex << setw(8) << setfill('0') << randomNum;
-    return ss.str();
-}
 // Deposit amount to client account
-bool depositToClientAccount(strClient* client, double depositAmount) {
+bool depositToClientAccount(strClient* client, Money depositAmount) {
     if (client == nullptr) {
         return false;
     }
     client->AccountBalance += depositAmount;
-    showSuccessMessage("Done Successfully . New Balance is : " + formatDouble(client->AccountBalance));
+    showSuccessMessage("Done Successfully . New Balance is : " + formatMoney(client->AccountBalance));
     return true;
 }
 // Create deposit transaction record
-Transaction createDepositTransaction(const string& account, double amount, const string& description = "Deposit operation") {
+Transaction createDepositTransaction(const string& account, Money amount, const string& description = "Deposit operation") {
     Transaction txn;
     txn.TransactionID = generateTransactionID();
     txn.Type = DEPOSIT;
@@ -73,63 +70,67 @@ void showDepositScreen(vector<strClient>& vClients) {
     }
 
     showClientCard(*client);
-    double depositAmount = readPositiveNumber("Enter Deposit Amount: ");
+    Money depositAmount = readPositiveAmount("Enter Deposit Amount: ");
 
-    if (!confirmAction("Confirm deposit of " + formatDouble(depositAmount) + "?")) {
+    if (!confirmAction("Confirm deposit of " + formatMoney(depositAmount) + "?")) {
         showErrorMessage("Deposit cancelled");
         logUserAction("DEPOSIT_CANCELLED", "Account: " + accountNumber);
         backToMenu();
         return;
     }
 
-    double originalBalance = client->AccountBalance;
+    Money originalBalance = client->AccountBalance;
+    chrono::steady_clock::time_point posted = chrono::steady_clock::now();
 
     if (depositToClientAccount(client, depositAmount)) {
         Transaction depositTransaction = createDepositTransaction(client->AccountNumber, depositAmount);
         saveTransactionToFile(depositTransaction);
-        saveClientsToFile(ClientsFileName, vClients);
+        commitBalanceChange(vClients, depositTransaction.TransactionID,
+            { { client->AccountNumber, depositAmount } });
 
         logTransaction(depositTransaction);
-        logUserAction("DEPOSIT", "Account: " + accountNumber + " - Amount: " + formatDouble(depositAmount));
+        recordMetric(METRIC_DEPOSIT, posted);
+        logUserAction("DEPOSIT", "Account: " + accountNumber + " - Amount: " + formatMoney(depositAmount));
 
         string successMessage = string("Transaction completed successfully!\n") +
             "Transaction ID: " + depositTransaction.TransactionID + "\n" +
-            "Deposited Amount: " + formatDouble(depositAmount) + "\n" +
-            "Previous Balance: " + formatDouble(originalBalance) + "\n" +
-            "New Balance: " + formatDouble(originalBalance + depositAmount);
+            "Deposited Amount: " + formatMoney(depositAmount) + "\n" +
+            "Previous Balance: " + formatMoney(originalBalance) + "\n" +
+            "New Balance: " + formatMoney(originalBalance + depositAmount);
 
         showSuccessMessage(successMessage);
         backToMenu();
     }
 }
-// Withdraw amount from client account
-bool withdrawToClientAccount(strClient* client, double withdrawAmount) {
+// Check a withdrawal against the client balance, return error message or "" if valid
+string checkWithdrawAmount(const strClient* client, Money withdrawAmount) {
     if (client == nullptr) {
-        showErrorMessage("Client not found!");
-        backToMenu();
-        return false;
+        return "Client not found!";
     }
-
     if (withdrawAmount <= 0) {
-        showErrorMessage("Invalid amount! Please enter a positive value.");
-        backToMenu();
-        return false;
+        return "Invalid amount! Please enter a positive value.";
     }
-
     if (withdrawAmount > client->AccountBalance) {
-        showErrorMessage("Insufficient funds! Available balance: " +
-            formatDouble(client->AccountBalance));
+        return "Insufficient funds! Available balance: " + formatMoney(client->AccountBalance);
+    }
+    return "";
+}
+// Withdraw amount from client account
+bool withdrawToClientAccount(strClient* client, Money withdrawAmount) {
+    string error = checkWithdrawAmount(client, withdrawAmount);
+    if (!error.empty()) {
+        showErrorMessage(error);
         backToMenu();
         return false;
     }
 
     client->AccountBalance -= withdrawAmount;
     showSuccessMessage("Withdrawal successful! Remaining balance: " +
-        formatDouble(client->AccountBalance));
+        formatMoney(client->AccountBalance));
     return true;
 }
 // Create withdrawal transaction record
-Transaction createWithdrawTransaction(const string& account, double amount, const string& description = "Withdrawal operation") {
+Transaction createWithdrawTransaction(const string& account, Money amount, const string& description = "Withdrawal operation") {
     Transaction txn;
     txn.TransactionID = generateTransactionID();
     txn.Type = WITHDRAWAL;
@@ -161,7 +162,7 @@ void showWithdrawScreen(vector<strClient>& vClients) {
     }
 
     showClientCard(*client);
-    double withdrawAmount = readPositiveNumber("Enter Withdraw Amount: ");
+    Money withdrawAmount = readPositiveAmount("Enter Withdraw Amount: ");
 
     while (withdrawAmount > client->AccountBalance) {
         showErrorMessage("Amount exceeds balance! Available: " + formatCurrency(client->AccountBalance));
@@ -171,72 +172,94 @@ void showWithdrawScreen(vector<strClient>& vClients) {
             backToMenu();
             return;
         }
-        withdrawAmount = readPositiveNumber("Enter Withdraw Amount: ");
+        withdrawAmount = readPositiveAmount("Enter Withdraw Amount: ");
     }
 
-    if (!confirmAction("Confirm withdrawal of " + formatDouble(withdrawAmount) + "?")) {
+    if (!confirmAction("Confirm withdrawal of " + formatMoney(withdrawAmount) + "?")) {
         showErrorMessage("Withdrawal cancelled");
         logUserAction("WITHDRAWAL_CANCELLED", "Account: " + accountNumber);
         backToMenu();
         return;
     }
 
-    double originalBalance = client->AccountBalance;
+    Money originalBalance = client->AccountBalance;
+    chrono::steady_clock::time_point posted = chrono::steady_clock::now();
 
     if (withdrawToClientAccount(client, withdrawAmount)) {
         Transaction withdrawalTransaction = createWithdrawTransaction(client->AccountNumber, withdrawAmount);
         saveTransactionToFile(withdrawalTransaction);
-        saveClientsToFile(ClientsFileName, vClients);
+        commitBalanceChange(vClients, withdrawalTransaction.TransactionID,
+            { { client->AccountNumber, -withdrawAmount } });
 
         logTransaction(withdrawalTransaction);
+        recordMetric(METRIC_WITHDRAW, posted);
         logUserAction("WITHDRAWAL", "Account: " + accountNumber + " - Amount: " + formatCurrency(withdrawalTransaction.Amount));
 
         string successMessage = string("Transaction completed successfully!\n") +
             "Transaction ID: " + withdrawalTransaction.TransactionID + "\n" +
-            "Withdrawn Amount: " + formatDouble(withdrawAmount) + "\n" +
-            "Previous Balance: " + formatDouble(originalBalance) + "\n" +
-            "New Balance: " + formatDouble(originalBalance - withdrawAmount);
+            "Withdrawn Amount: " + formatMoney(withdrawAmount) + "\n" +
+            "Previous Balance: " + formatMoney(originalBalance) + "\n" +
+            "New Balance: " + formatMoney(originalBalance - withdrawAmount);
 
         showSuccessMessage(successMessage);
         backToMenu();
     }
 }
-// Validate source and destination accounts
-bool validateTransferAccounts(const string& fromAccount, const string& toAccount,
+// Find source and destination accounts, return error message or "" if valid
+string checkTransferAccounts(const string& fromAccount, const string& toAccount,
     strClient*& fromClient, strClient*& toClient,
     vector<strClient>& vClients) {
 
     fromClient = findClientByAccountNumber(fromAccount, vClients);
     if (!fromClient) {
-        showErrorMessage("Your account not found!");
-        return false;
+        return "Your account not found!";
     }
 
     toClient = findClientByAccountNumber(toAccount, vClients);
     if (!toClient) {
-        showErrorMessage("Recipient account not found!");
-        return false;
+        return "Recipient account not found!";
     }
 
     if (fromAccount == toAccount) {
-        showErrorMessage("Cannot transfer to the same account!");
-        return false;
+        return "Cannot transfer to the same account!";
     }
 
+    return "";
+}
+// Validate source and destination accounts
+bool validateTransferAccounts(const string& fromAccount, const string& toAccount,
+    strClient*& fromClient, strClient*& toClient,
+    vector<strClient>& vClients) {
+    string error = checkTransferAccounts(fromAccount, toAccount, fromClient, toClient, vClients);
+    if (!error.empty()) {
+        showErrorMessage(error);
+        return false;
+    }
     return true;
 }
-// Validate transfer amount and fees
-bool validateTransferAmount(double transferAmount, double transferFee, strClient* fromClient) {
+// Calculate transfer fee (TransferFeePercent of amount, rounded half up to the cent)
+Money calculateTransferFee(Money transferAmount) {
+    return (transferAmount * TransferFeePercent + 50) / 100;
+}
+// Check transfer amount plus fee against the source balance, return error message or "" if valid
+string checkTransferAmount(Money transferAmount, Money transferFee, const strClient* fromClient) {
     if (fromClient->AccountBalance < (transferAmount + transferFee)) {
-        showErrorMessage("Insufficient balance! Total required: " +
-            formatDouble(transferAmount + transferFee));
+        return "Insufficient balance! Total required: " + formatMoney(transferAmount + transferFee);
+    }
+    return "";
+}
+// Validate transfer amount and fees
+bool validateTransferAmount(Money transferAmount, Money transferFee, strClient* fromClient) {
+    string error = checkTransferAmount(transferAmount, transferFee, fromClient);
+    if (!error.empty()) {
+        showErrorMessage(error);
         return false;
     }
     return true;
 }
 // Execute transfer between accounts
 bool executeTransfer(strClient* fromClient, strClient* toClient,
-    double transferAmount, double transferFee) {
+    Money transferAmount, Money transferFee) {
     fromClient->AccountBalance -= (transferAmount + transferFee);
     toClient->AccountBalance += transferAmount;
     return true;
@@ -244,20 +267,20 @@ bool executeTransfer(strClient* fromClient, strClient* toClient,
 // Display transfer details before confirm
 void showTransferConfirmation(strClient* fromClient, strClient* toClient,
     const string& fromAccount, const string& toAccount,
-    double transferAmount, double transferFee) {
+    Money transferAmount, Money transferFee) {
 
     cout << "\nTransfer Details:\n";
     cout << "From: " << fromClient->Name << " (" << fromAccount << ")\n";
     cout << "To: " << toClient->Name << " (" << toAccount << ")\n";
-    cout << "Amount: " << transferAmount << "\n";
-    cout << "Fee: " << transferFee << "\n";
-    cout << "Total: " << (transferAmount + transferFee) << "\n";
+    cout << "Amount: " << formatMoney(transferAmount) << "\n";
+    cout << "Fee: " << formatMoney(transferFee) << "\n";
+    cout << "Total: " << formatMoney(transferAmount + transferFee) << "\n";
 }
 // Create transfer transaction record
 Transaction createTransferTransaction(const string& fromAccount,
     const string& toAccount,
-    double transferAmount,
-    double transferFee,
+    Money transferAmount,
+    Money transferFee,
     const string& description) {
     Transaction transaction;
     transaction.TransactionID = generateTransactionID();
@@ -290,8 +313,8 @@ void showTransferScreen(vector<strClient>& vClients) {
         return;
     }
 
-    double transferAmount = readPositiveNumber("Enter Transfer Amount: ");
-    double transferFee = transferAmount * 0.01;
+    Money transferAmount = readPositiveAmount("Enter Transfer Amount: ");
+    Money transferFee = calculateTransferFee(transferAmount);
 
     while (!validateTransferAmount(transferAmount, transferFee, fromClient)) {
         if (!confirmAction("Do you want to enter a different amount?")) {
@@ -299,8 +322,8 @@ void showTransferScreen(vector<strClient>& vClients) {
             backToMenu();
             return;
         }
-        transferAmount = readPositiveNumber("Enter Transfer Amount: ");
-        transferFee = transferAmount * 0.01;
+        transferAmount = readPositiveAmount("Enter Transfer Amount: ");
+        transferFee = calculateTransferFee(transferAmount);
     }
 
     showTransferConfirmation(fromClient, toClient, fromAccount, toAccount, transferAmount, transferFee);
@@ -311,70 +334,90 @@ void showTransferScreen(vector<strClient>& vClients) {
         return;
     }
 
-    double originalBalance = fromClient->AccountBalance;
+    Money originalBalance = fromClient->AccountBalance;
+    chrono::steady_clock::time_point posted = chrono::steady_clock::now();
     executeTransfer(fromClient, toClient, transferAmount, transferFee);
 
     string description = "Transfer to " + toClient->Name;
     Transaction transferTransaction = createTransferTransaction(fromAccount, toAccount,
         transferAmount, transferFee, description);
     saveTransactionToFile(transferTransaction);
-    saveClientsToFile(ClientsFileName, vClients);
+    commitBalanceChange(vClients, transferTransaction.TransactionID,
+        { { fromAccount, -(transferAmount + transferFee) }, { toAccount, transferAmount } });
 
     logTransaction(transferTransaction);
+    recordMetric(METRIC_TRANSFER, posted);
     logUserAction("TRANSFER", "From: " + fromAccount + " To: " + toAccount + " - Amount: " + formatCurrency(transferAmount));
 
     string successMessage = string("Transfer completed successfully!\n") +
         "Transaction ID: " + transferTransaction.TransactionID + "\n" +
-        "Transferred Amount: " + formatDouble(transferAmount) + "\n" +
-        "Fee: " + formatDouble(transferFee) + "\n" +
-        "Previous Balance: " + formatDouble(originalBalance) + "\n" +
-        "New Balance: " + formatDouble(fromClient->AccountBalance);
+        "Transferred Amount: " + formatMoney(transferAmount) + "\n" +
+        "Fee: " + formatMoney(transferFee) + "\n" +
+        "Previous Balance: " + formatMoney(originalBalance) + "\n" +
+        "New Balance: " + formatMoney(fromClient->AccountBalance);
 
     showSuccessMessage(successMessage);
 
-    vClients = loadClientsDataFromFile(ClientsFileName);
+    refreshClientsFromFile(ClientsFileName, vClients);
     backToMenu();
 }
+// Sum all client balances exactly (integer cents)
+Money sumClientBalances(const vector<strClient>& vClients) {
+    Money total = 0;
+    for (const strClient& client : vClients) {
+        total += client.AccountBalance;
+    }
+    return total;
+}
 // Show report of total balances for all clients
 void showTotalBalancesReport(const vector<strClient>& vClients) {
-    clearScreen();
-    showScreenHeader("Total Balances Report");
+    strClientColumns columns;
+    buildClientColumns(vClients, columns);
+    strBalanceSummary summary = summarizeBalanceColumn(columns.Balances);
 
-    double totalBalance = 0;
+    beginScreen("Total Balances Report");
+    string& out = ScreenBuffer.Text;
+    out += "Total Clients: " + to_string(summary.Count) + "\n\n";
 
-    cout << "Total Clients: " << vClients.size() << "\n\n";
-
-    if (vClients.size() == 0) {
+    if (summary.Count == 0) {
+        writeScreenBuffer();
         showErrorMessage("No clients available in the system!");
         backToMenu();
         return;
     }
 
-    showBorderLine(80, '-', CYAN);
-    cout << CYAN << "| " << left << setw(18) << "Account Number"
-        << "| " << setw(35) << "Client Name"
-        << "| " << setw(22) << "Balance" << "|\n";
-    showBorderLine(80, '-', CYAN);
-
-    for (const strClient& Client : vClients) {
-        totalBalance += Client.AccountBalance;
-        string balanceColor = (Client.AccountBalance >= 0) ? GREEN : RED;
-        cout << CYAN << "| " << RESET << left << setw(18) << Client.AccountNumber
-            << CYAN << "| " << RESET << setw(35) << Client.Name
-            << CYAN << "| " << RESET << balanceColor << setw(22)
-            << formatCurrency(Client.AccountBalance) << CYAN << "|\n" << RESET;
+    vector<strTableColumn> tableColumns = { { "Account Number", 18 }, { "Client Name", 35 }, { "Balance", 22 } };
+    showPagedTable(tableColumns, summary.Count, [&](string& row, size_t i) {
+        Money balance = columns.Balances[i];
+        appendTextCell(row, getColumnAccount(columns, i), 18);
+        appendTextCell(row, getColumnName(columns, i), 35);
+        appendMoneyCell(row, balance, 22, balance >= 0 ? GREEN : RED);
+        appendRowEnd(row);
+    });
+    appendTextCell(out, "TOTAL BALANCE", 55, CYAN);
+    appendMoneyCell(out, summary.Total, 22, YELLOW);
+    appendRowEnd(out);
+    appendBorderLine(out, getTableBorderLength(tableColumns), '-', CYAN);
+
+    out += "\nLowest Balance  : " + formatCurrency(summary.Minimum) + "\n";
+    out += "Highest Balance : " + formatCurrency(summary.Maximum) + "\n";
+    out += "Average Balance : " + formatCurrency(summary.Total / static_cast<Money>(summary.Count)) + "\n";
+    out += "Negative Clients: " + to_string(summary.Negative) + "\n\n";
+
+    vector<strTableColumn> bucketColumns = { { "Balance Range", 33 }, { "Clients", 14 } };
+    appendTableHeader(out, bucketColumns);
+    for (size_t bucket = 0; bucket < BalanceBucketCount; bucket++) {
+        appendTextCell(out, getBalanceBucketLabel(bucket), 33);
+        appendCountCell(out, summary.Buckets[bucket], 14);
+        appendRowEnd(out);
     }
-    showBorderLine(80, '-', CYAN);
-    cout << CYAN << "| " << left << setw(55) << "TOTAL BALANCE"
-        << "| " << YELLOW << setw(22) << formatCurrency(totalBalance) << CYAN << "|\n";
-    showBorderLine(80, '-', CYAN);
+    appendBorderLine(out, getTableBorderLength(bucketColumns), '-', CYAN);
 
+    writeScreenBuffer();
     backToMenu();
 }
 // Show transaction history for account
 void showTransactionsHistory() {
-    vector<Transaction> transactions = loadTransactionsFromFile(TransactionsFileName);
-
     clearScreen();
     showScreenHeader("Transaction History");
     showBackOrExit(false);
@@ -383,46 +426,195 @@ void showTransactionsHistory() {
     string accountNumber = readNonEmptyString("Enter Account Number (or 0 to Back)? ");
     if (accountNumber == "0") return;
 
-    cout << "Account Number: " << accountNumber << "\n\n";
-
-    showBorderLine(150, '-', CYAN);
-    cout << CYAN << "| " << left << setw(28) << "Transaction ID"
-        << "| " << setw(12) << "Type"
-        << "| " << setw(15) << "From Account"
-        << "| " << setw(15) << "To Account"
-        << "| " << setw(12) << "Amount"
-        << "| " << setw(8) << "Fees"
-        << "| " << setw(20) << "Timestamp"
-        << "| " << setw(25) << "Description" << "|\n";
-    showBorderLine(150, '-', CYAN);
-
-    bool found = false;
-    for (const Transaction& txn : transactions) {
-        if (txn.FromAccount == accountNumber || txn.ToAccount == accountNumber) {
-            found = true;
-            string typeColor = (txn.Type == DEPOSIT) ? GREEN : (txn.Type == WITHDRAWAL) ? RED : YELLOW;
-            string type = (txn.Type == DEPOSIT ? "Deposit" : txn.Type == WITHDRAWAL ? "Withdraw" : "Transfer");
-
-            cout << CYAN << "| " << RESET << left << setw(28) << txn.TransactionID
-                << CYAN << "| " << RESET << typeColor << setw(12) << type << RESET
-                << CYAN << "| " << RESET << setw(15) << txn.FromAccount
-                << CYAN << "| " << RESET << setw(15) << txn.ToAccount
-                << CYAN << "| " << RESET << GREEN << setw(12) << fixed << setprecision(2) << formatCurrency(txn.Amount) << RESET
-                << CYAN << "| " << RESET << YELLOW << setw(8) << txn.Fees << RESET
-                << CYAN << "| " << RESET << setw(20) << txn.Timestamp
-                << CYAN << "| " << RESET << setw(25) << txn.Description << CYAN << "|\n" << RESET;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    size_t total = 0;
+    vector<Transaction> transactions = getRecentTransactions(accountNumber, total);
+    recordMetric(METRIC_HISTORY, started);
+
+    // Older records are read from the ledger only when asked for
+    if (total > transactions.size()) {
+        cout << "\nShowing the last " << transactions.size() << " of " << to_string(total) << " transactions.\n";
+        if (confirmAction("Show all " + to_string(total) + " transactions?")) {
+            started = chrono::steady_clock::now();
+            transactions = loadAccountTransactions(TransactionsFileName, accountNumber);
+            recordMetric(METRIC_HISTORY, started);
         }
     }
 
-    showBorderLine(150, '-', CYAN);
-
-    if (!found) {
+    string& out = ScreenBuffer.Text;
+    out.clear();
+    out += "Account Number: " + accountNumber + "\n\n";
+
+    vector<strTableColumn> columns = {
+        { "Transaction ID", 32 }, { "Type", 12 }, { "From Account", 15 }, { "To Account", 15 },
+        { "Amount", 12 }, { "Fees", 8 }, { "Timestamp", 20 }, { "Description", 25 } };
+    showPagedTable(columns, transactions.size(), [&](string& row, size_t i) {
+        const Transaction& txn = transactions[i];
+        const string& typeColor = (txn.Type == DEPOSIT) ? GREEN : (txn.Type == WITHDRAWAL) ? RED :
+            (txn.Type == REVERSAL) ? MAGENTA : YELLOW;
+        const char* type = getTransactionTypeName(txn.Type);
+
+        appendTextCell(row, txn.TransactionID, 32);
+        appendTextCell(row, type, 12, typeColor);
+        appendTextCell(row, txn.FromAccount, 15);
+        appendTextCell(row, txn.ToAccount, 15);
+        appendMoneyCell(row, txn.Amount, 12, GREEN);
+        appendMoneyCell(row, txn.Fees, 8, YELLOW, false);
+        appendTextCell(row, txn.Timestamp, 20);
+        appendTextCell(row, txn.Description, 25);
+        appendRowEnd(row);
+    });
+    writeScreenBuffer();
+
+    if (transactions.empty()) {
         cout << "\n";
         showErrorMessage("No transactions found for this account.");
     }
 
     backToMenu();
 }
+// Display a ledger record in formatted card
+void showTransactionCard(const Transaction& txn) {
+    cout << "\n";
+    showBorderLine(58, '=');
+    cout << "|  " << left << setw(56) << "Transaction Information" << "|\n";
+    cout << "+" << string(58, '=') << "+\n";
+
+    cout << "|  Transaction ID : " << left << setw(39) << txn.TransactionID << "|\n";
+    cout << "|  Type           : " << left << setw(39) << getTransactionTypeName(txn.Type) << "|\n";
+    cout << "|  From Account   : " << left << setw(39) << txn.FromAccount << "|\n";
+    cout << "|  To Account     : " << left << setw(39) << txn.ToAccount << "|\n";
+    cout << "|  Amount         : " << left << setw(39) << formatCurrency(txn.Amount) << "|\n";
+    cout << "|  Fees           : " << left << setw(39) << formatCurrency(txn.Fees) << "|\n";
+    cout << "|  Timestamp      : " << left << setw(39) << txn.Timestamp << "|\n";
+    cout << "|  Description    : " << left << setw(39) << txn.Description << "|\n";
+
+    showBorderLine(58, '=');
+}
+// Balance changes that undo a transaction (none for a reversal)
+vector<strJournalLeg> buildReversalLegs(const Transaction& txn) {
+    switch (txn.Type) {
+    case DEPOSIT:    return { { txn.ToAccount, -txn.Amount } };
+    case WITHDRAWAL: return { { txn.FromAccount, txn.Amount } };
+    case TRANSFER:   return { { txn.FromAccount, txn.Amount + txn.Fees }, { txn.ToAccount, -txn.Amount } };
+    default:         return {};
+    }
+}
+// Check that a transaction can be reversed now, return error message or "" if valid
+string checkReversal(const Transaction& txn, const vector<strJournalLeg>& legs, vector<strClient>& vClients) {
+    if (txn.Type == REVERSAL) {
+        return "A reversal cannot be reversed.";
+    }
+    if (legs.empty()) {
+        return "Transactions of this type cannot be reversed.";
+    }
+
+    Transaction reversal;
+    if (findTransactionById(TransactionsFileName, txn.TransactionID + ReversalIdSuffix, reversal)) {
+        return "Already reversed by " + reversal.TransactionID + " on " + reversal.Timestamp + ".";
+    }
+
+    for (const strJournalLeg& leg : legs) {
+        const strClient* client = findClientByAccountNumber(leg.AccountNumber, vClients);
+        if (client == nullptr) {
+            return "Account " + leg.AccountNumber + " no longer exists.";
+        }
+        if (client->AccountBalance + leg.Delta < 0) {
+            return "Insufficient balance in " + leg.AccountNumber + " to reverse! Available balance: " +
+                formatMoney(client->AccountBalance);
+        }
+    }
+    return "";
+}
+// Create reversal transaction record; its ID is the reversed ID plus ReversalIdSuffix
+Transaction createReversalTransaction(const Transaction& original) {
+    Transaction transaction;
+    transaction.TransactionID = original.TransactionID + ReversalIdSuffix;
+    transaction.Type = REVERSAL;
+    transaction.FromAccount = original.FromAccount;
+    transaction.ToAccount = original.ToAccount;
+    transaction.Amount = original.Amount;
+    transaction.Fees = original.Fees;
+    transaction.Timestamp = getCurrentTimestamp();
+    transaction.Description = "Reversal of " + original.TransactionID;
+    return transaction;
+}
+// Show find / reverse transaction screen: lookup by ID through the ID index, optional reversal
+void showFindTransactionScreen(vector<strClient>& vClients) {
+    clearScreen();
+    showScreenHeader("Find / Reverse Transaction");
+    showBackOrExit();
+    showLine();
+
+    string transactionID = readNonEmptyString("Enter Transaction ID (or 0 to Back)? ");
+    if (transactionID == "0") return;
+
+    Transaction transaction;
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    bool found = findTransactionById(TransactionsFileName, transactionID, transaction);
+    recordMetric(METRIC_ID_LOOKUP, started);
+
+    if (!found) {
+        showErrorMessage("Transaction " + transactionID + " not found. Please check the transaction ID.");
+        logUserAction("FIND_TRANSACTION_FAILED", "Transaction not found: " + transactionID);
+        backToMenu();
+        return;
+    }
+
+    showTransactionCard(transaction);
+    logUserAction("FIND_TRANSACTION", "Transaction: " + transactionID);
+
+    vector<strJournalLeg> legs = buildReversalLegs(transaction);
+    string error = checkReversal(transaction, legs, vClients);
+    if (!error.empty()) {
+        showErrorMessage(error);
+        backToMenu();
+        return;
+    }
+
+    if (!confirmAction("Reverse this transaction?")) {
+        showErrorMessage("Reversal cancelled");
+        backToMenu();
+        return;
+    }
+
+    chrono::steady_clock::time_point posted = chrono::steady_clock::now();
+    Transaction reversal = createReversalTransaction(transaction);
+    {
+        // Another teller may have reversed it or moved the balances while this one confirmed: check again on
+        // fresh clients, holding the ledger lock until the reversal and its balances are written
+        strLedgerLock lock(TransactionsFileName);
+        refreshClientsFromFile(ClientsFileName, vClients);
+        error = checkReversal(transaction, legs, vClients);
+        if (error.empty()) {
+            for (const strJournalLeg& leg : legs) {
+                findClientByAccountNumber(leg.AccountNumber, vClients)->AccountBalance += leg.Delta;
+            }
+
+            // One ledger record, and one journal record carrying every leg: the balances change together or not at all
+            saveTransactionToFile(reversal);
+            commitBalanceChange(vClients, reversal.TransactionID, legs);
+        }
+    }
+    if (!error.empty()) {
+        showErrorMessage(error);
+        backToMenu();
+        return;
+    }
+
+    logTransaction(reversal);
+    recordMetric(METRIC_REVERSAL, posted);
+    logUserAction("REVERSAL", "Transaction: " + transactionID + " - Reversal: " + reversal.TransactionID);
+
+    string successMessage = string("Transaction reversed successfully!\n") +
+        "Reversal ID: " + reversal.TransactionID;
+    for (const strJournalLeg& leg : legs) {
+        successMessage += "\nNew Balance of " + leg.AccountNumber + ": " +
+            formatMoney(findClientByAccountNumber(leg.AccountNumber, vClients)->AccountBalance);
+    }
+    showSuccessMessage(successMessage);
+    backToMenu();
+}
 // Execute selected transaction option
 void executeTransactionOption(TransactionsOption TransactionMenuOption, vector<strClient>& vClients) {
     switch (TransactionMenuOption) {
@@ -450,6 +642,10 @@ void executeTransactionOption(TransactionsOption TransactionMenuOption, vector<s
         showTransactionsHistory();
         break;
 
+    case TransactionsOption::FindTransaction:
+        showFindTransactionScreen(vClients);
+        break;
+
     case TransactionsOption::ShowMainMenu:
         break;
     }
@@ -458,7 +654,8 @@ void executeTransactionOption(TransactionsOption TransactionMenuOption, vector<s
 void showTransactionsMenuScreen() {
     clearScreen();
     showScreenHeader("Transactions Menu Screen");
-    vector<string> options = { "Deposit","Withdraw","Transfer","Total Balances","Transactions History" };
+    vector<string> options = { "Deposit","Withdraw","Transfer","Total Balances","Transactions History",
+        "Find / Reverse Transaction" };
     showOptions(options);
     showBackOrExit();
     showLine(60, '-', CYAN);
@@ -468,9 +665,9 @@ void manageTransactions(vector<strClient>& vClients) {
     int choice;
     do {
         showTransactionsMenuScreen();
-        choice = readMenuOption(1, 5);
+        choice = readMenuOption(1, 6);
         if (choice == 0) break;
         executeTransactionOption((TransactionsOption)choice, vClients);
-        vClients = loadClientsDataFromFile(ClientsFileName);
+        refreshClientsFromFile(ClientsFileName, vClients);
     } while (choice != 0);
 }
@@ -10,9 +10,12 @@
 
 #include "Globals.h"
 #include "Utilities.h"
+#include "ScreenRenderer.h"
 #include "InputManager.h"
 #include "FileManager.h"
+#include "HashIndex.h"
 #include "Logger.h"
+#include "Metrics.h"
 
 //=====================================================
 //==================== User Manager ===================
@@ -22,13 +25,9 @@
 string hashPassword(const string& password);
 bool   verifyPassword(const string& password, const string& hashedPassword);
 
-// Find user by username
+// Find user by username (hash index)
 strUser* findUserByUsername(const string& userName, vector<strUser>& vUsers) {
-    for (auto& user : vUsers) {
-        if (user.UserName == userName)
-            return &user;
-    }
-    return nullptr;
+    return findInHashIndex(UserIndex, vUsers, userName);
 }
 // Mark User for deletion using pointer
 bool markUserForDelete(strUser* user) {
@@ -49,6 +48,7 @@ strUser readUserData(const string& userName) {
 }
 // Verify raw password against hashed password
 bool verifyPassword(const string& password, const string& hashedPassword) {
+    strMetricTimer timer(METRIC_VERIFY_PASSWORD);
     if (hashedPassword.empty()) {
         return false;
     }
@@ -117,30 +117,26 @@ int countFullAccessUsers(const vector<strUser>& vUsers) {
 }
 // Display all users in table format
 void showUsersListScreen(const vector<strUser>& vUsers) {
-    clearScreen();
-    showScreenHeader("Users List");
-
-    cout << "Total Users: " << vUsers.size() << "\n\n";
+    beginScreen("Users List");
+    string& out = ScreenBuffer.Text;
+    out += "Total Users: " + to_string(vUsers.size()) + "\n\n";
 
     if (vUsers.size() == 0) {
+        writeScreenBuffer();
         showErrorMessage("No users available in the system!");
         backToMenu();
         return;
     }
 
-    showBorderLine(120, '-', CYAN);
-    cout << CYAN << "| " << left << setw(25) << "Username"
-        << "| " << setw(92) << "Permissions" << "|\n";
-    showBorderLine(120, '-', CYAN);
-
-    for (const strUser& user : vUsers) {
-        cout << CYAN << "| " << RESET << left << setw(25) << user.UserName
-            << CYAN << "| " << RESET << setw(92) << formatPermissions(user.Permissions) << CYAN << "|\n" << RESET;
-    }
-
-    showBorderLine(120, '-', CYAN);
-    cout << "\n";
+    vector<strTableColumn> columns = { { "Username", 25 }, { "Permissions", 92 } };
+    showPagedTable(columns, vUsers.size(), [&](string& row, size_t i) {
+        appendTextCell(row, vUsers[i].UserName, 25);
+        appendTextCell(row, formatPermissions(vUsers[i].Permissions), 92);
+        appendRowEnd(row);
+    });
+    out += "\n";
 
+    writeScreenBuffer();
     backToMenu();
 }
 // Add new user with unique username
@@ -9,6 +9,7 @@
 //  ||========================================================||
 
 #include "Globals.h"
+#include <sys/stat.h>
 
 //=====================================================
 //==================== Utilities ======================
@@ -24,11 +25,36 @@ string formatDouble(double value, int precision) {
 string formatInt(int value) {
     return to_string(value);
 }
+// Write cents as a fixed 2-decimal amount into a buffer of at least MoneyTextSize chars, return the end
+char* writeMoney(char* buffer, Money value) {
+    char* p = buffer;
+    uint64_t magnitude = (value < 0) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+    if (value < 0) *p++ = '-';
+    p = to_chars(p, buffer + MoneyTextSize, magnitude / 100).ptr;
+    *p++ = '.';
+    *p++ = static_cast<char>('0' + magnitude % 100 / 10);
+    *p++ = static_cast<char>('0' + magnitude % 10);
+    return p;
+}
+// Format cents as a fixed 2-decimal amount using integer arithmetic only
+string formatMoney(Money value) {
+    char buffer[MoneyTextSize];
+    return string(buffer, writeMoney(buffer, value));
+}
 // Format currency with $ sign
-string formatCurrency(double value) {
-    ostringstream out;
-    out << "$" << fixed << setprecision(2) << value;
-    return out.str();
+string formatCurrency(Money value) {
+    return "$" + formatMoney(value);
+}
+// Display name of a transaction type
+const char* getTransactionTypeName(TransactionType type) {
+    switch (type) {
+    case DEPOSIT:    return "Deposit";
+    case WITHDRAWAL: return "Withdraw";
+    case TRANSFER:   return "Transfer";
+    case REVERSAL:   return "Reversal";
+    default:         return "Unknown";
+    }
 }
 // Remove leading and trailing whitespace from string
 string trim(const string& str) {
@@ -38,6 +64,63 @@ string trim(const string& str) {
     size_t end = str.find_last_not_of(" \t\n\r\f\v");
     return str.substr(start, end - start + 1);
 }
+// Remove leading and trailing whitespace from a view (no allocation)
+string_view trimView(string_view str) {
+    const char* whitespace = " \t\n\r\f\v";
+    size_t start = str.find_first_not_of(whitespace);
+    if (start == string_view::npos) return string_view();
+
+    size_t end = str.find_last_not_of(whitespace);
+    return str.substr(start, end - start + 1);
+}
+// Parse decimal amount into exact cents ("1500.5" -> 150050), rounding half up past 2 decimals
+errc parseMoneyField(string_view field, Money& value) {
+    field = trimView(field);
+    bool negative = false;
+    if (!field.empty() && (field[0] == '+' || field[0] == '-')) {
+        negative = (field[0] == '-');
+        field.remove_prefix(1);
+    }
+
+    const uint64_t maxUnits = static_cast<uint64_t>(numeric_limits<Money>::max()) / 100 - 1;
+    uint64_t units = 0;
+    uint64_t cents = 0;
+    size_t intDigits = 0;
+    size_t fracDigits = 0;
+    size_t pos = 0;
+
+    for (; pos < field.size() && isdigit(static_cast<unsigned char>(field[pos])); pos++, intDigits++) {
+        units = units * 10 + (field[pos] - '0');
+        if (units > maxUnits) return errc::result_out_of_range;
+    }
+    if (pos < field.size() && field[pos] == '.') {
+        for (pos++; pos < field.size() && isdigit(static_cast<unsigned char>(field[pos])); pos++, fracDigits++) {
+            int digit = field[pos] - '0';
+            if (fracDigits < 2) cents = cents * 10 + digit;
+            else if (fracDigits == 2 && digit >= 5) cents++;
+        }
+        if (fracDigits == 1) cents *= 10;
+    }
+    if (intDigits == 0 && fracDigits == 0) {
+        return errc::invalid_argument;
+    }
+
+    if (pos < field.size()) {
+        // Not plain decimal notation (e.g. "1e3"): fall back to a double parse
+        double number = 0;
+        from_chars_result result = from_chars(field.data(), field.data() + field.size(), number);
+        if (result.ec != errc()) return result.ec;
+        if (result.ptr != field.data() + field.size()) return errc::invalid_argument;
+        if (number * 100 >= static_cast<double>(numeric_limits<Money>::max())) return errc::result_out_of_range;
+        value = static_cast<Money>(llround(number * 100));
+        if (negative) value = -value;
+        return errc();
+    }
+
+    value = static_cast<Money>(units * 100 + cents);
+    if (negative) value = -value;
+    return errc();
+}
 // Get current date and time as formatted string
 string getCurrentTimestamp() {
     time_t now = time(0);
@@ -57,13 +140,68 @@ string getCurrentTimestamp() {
 #endif
     return ss.str();
 }
-// Clear console screen (Windows/Linux)
-void clearScreen() {
-#ifdef _WIN32
-    system("cls");
-#else
-    system("clear");
+// Read existence, mtime, inode and size of a file
+strFileStamp readFileStamp(const string& fileName) {
+    strFileStamp stamp;
+    struct stat info;
+    stamp.Exists = (stat(fileName.c_str(), &info) == 0);
+    if (!stamp.Exists) {
+        return stamp;
+    }
+
+    stamp.ModifiedTime = static_cast<long long>(info.st_mtime);
+#ifdef __linux__
+    stamp.ModifiedTime = stamp.ModifiedTime * 1000000000LL + info.st_mtim.tv_nsec;
 #endif
+    stamp.Inode = static_cast<long long>(info.st_ino);
+    stamp.Size = static_cast<long long>(info.st_size);
+    return stamp;
+}
+// Compare two file stamps
+bool sameFileStamp(const strFileStamp& a, const strFileStamp& b) {
+    return a.Exists == b.Exists && a.ModifiedTime == b.ModifiedTime && a.Inode == b.Inode && a.Size == b.Size;
+}
+// Compute CRC-32 (IEEE) of a buffer, optionally continuing a previous CRC (slice-by-8: eight bytes per step)
+uint32_t computeCRC32(const char* data, size_t length, uint32_t crc) {
+    // Built once, thread-safe: table[k][i] is the CRC of byte i followed by k zero bytes
+    static const vector<array<uint32_t, 256>> table = [] {
+        vector<array<uint32_t, 256>> tables(8);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            }
+            tables[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int k = 1; k < 8; k++) {
+                tables[k][i] = tables[0][tables[k - 1][i] & 0xFF] ^ (tables[k - 1][i] >> 8);
+            }
+        }
+        return tables;
+    }();
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (; length >= 8; length -= 8, bytes += 8) {
+        uint32_t low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24] ^
+            table[3][bytes[4]] ^ table[2][bytes[5]] ^ table[1][bytes[6]] ^ table[0][bytes[7]];
+    }
+    for (; length > 0; length--, bytes++) {
+        crc = table[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+// Format 32-bit value as 8 lowercase hex digits
+string formatHex32(uint32_t value) {
+    ostringstream out;
+    out << hex << setw(8) << setfill('0') << value;
+    return out.str();
+}
+// Clear console screen with ANSI sequences (no shell subprocess; the colors already need ANSI)
+void clearScreen() {
+    cout << ClearScreenSequence << flush;
 }
 // Draw a line with given length, symbol, and color (no newlines)
 void drawLine(int length, char symbol, string color) {
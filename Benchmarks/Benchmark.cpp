@@ -0,0 +1,2628 @@
+
+//  ||========================================================||
+//  || BankSystem Project - Version v1.4.1                    ||
+//  ||========================================================||
+//  || File: Benchmark.cpp                                    ||
+//  || Performance benchmarks for the BankSystem hot paths.   ||
+//  ||                                                        ||
+//  || Build (from this folder):                              ||
+//  ||   g++ -O2 -std=c++17 -I../BankSystem -o Benchmark      ||
+//  ||       Benchmark.cpp -pthread -lsodium                  ||
+//  ||                                                        ||
+//  || Run:                                                   ||
+//  ||   ./Benchmark              : run every benchmark       ||
+//  ||   ./Benchmark journal ...  : run selected benchmarks   ||
+//  ||                                                        ||
+//  || All data files are created inside ./BenchmarkData so   ||
+//  || the real Clients.txt / Users.txt are never touched.    ||
+//  ||========================================================||
+
+#include "Globals.h"
+#include "Utilities.h"
+#include "ScreenRenderer.h"
+#include "Crypto.h"
+#include "Session.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Durability.h"
+#include "HashIndex.h"
+#include "FileManager.h"
+#include "AccountDictionary.h"
+#include "ClientStore.h"
+#include "Journal.h"
+#include "BinaryClients.h"
+#include "Ledger.h"
+#include "LedgerView.h"
+#include "TransactionIndex.h"
+#include "RecentTransactions.h"
+#include "TransactionIdIndex.h"
+#include "IdGenerator.h"
+#include "InputManager.h"
+#include "PermissionManager.h"
+#include "ClientManager.h"
+#include "ClientColumns.h"
+#include "TransactionManager.h"
+#include "ConcurrentLedger.h"
+#include "BatchManager.h"
+#include "UserManager.h"
+#include "ServerManager.h"
+#include "AuthManager.h"
+#include "MenuManager.h"
+#include <random>
+#include <future>
+
+#ifdef _WIN32
+#include <direct.h>
+#define chdir _chdir
+#define mkdir(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#ifdef __linux__
+#include <malloc.h>
+#endif
+#define mkdir(path) mkdir(path, 0755)
+#endif
+
+//=====================================================
+// Global variable definitions (declared extern in Globals.h)
+//=====================================================
+strUser CurrentUser;
+strJournalState JournalState;
+strHashIndex ClientIndex;
+strHashIndex UserIndex;
+strLedger Ledger;
+strTransactionIndex TransactionIndex;
+strAsyncLogger AsyncLogger;
+strSessionCache SessionCache;
+strClientStore ClientStore;
+strServerControl ServerControl;
+strServerLogins ServerLogins;
+strScreenBuffer ScreenBuffer;
+strDurability Durability;
+strMetrics Metrics;
+strClientFile ClientFile;
+strAccountDictionary AccountIds;
+strRecentCache RecentCache;
+strTransactionIdIndex TransactionIds;
+strTransactionIdGenerator IdGenerator;
+
+//=====================================================
+// Heap allocation counter: every operator new of this
+// program is counted (read by the "allocations" case)
+//=====================================================
+atomic<long long> HeapAllocations{ 0 };
+
+void* operator new(size_t size) {
+    HeapAllocations.fetch_add(1, memory_order_relaxed);
+    if (void* block = malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw bad_alloc();
+}
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC pairs the inlined free() with the new-expression and reports a mismatch that is not there
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* block) noexcept {
+    free(block);
+}
+void operator delete(void* block, size_t) noexcept {
+    free(block);
+}
+
+//=====================================================
+//================= Benchmark Helpers =================
+//=====================================================
+
+typedef chrono::steady_clock BenchClock;
+
+// Seconds elapsed since start
+double secondsSince(BenchClock::time_point start) {
+    return chrono::duration<double>(BenchClock::now() - start).count();
+}
+// Build a synthetic client with a deterministic account number
+strClient makeSyntheticClient(int i) {
+    strClient client;
+    ostringstream account;
+    account << "AC" << setw(8) << setfill('0') << i;
+    client.AccountNumber = account.str();
+    client.PinCode = formatInt(1000 + i % 9000);
+    client.Name = "Client " + formatInt(i);
+    client.Phone = "0790" + formatInt(1000000 + i % 9000000);
+    client.AccountBalance = (1000 + i % 500) * 100;
+    return client;
+}
+// Build a vector of synthetic clients
+vector<strClient> makeSyntheticClients(int count) {
+    vector<strClient> vClients;
+    vClients.reserve(count);
+    for (int i = 0; i < count; i++) {
+        vClients.push_back(makeSyntheticClient(i));
+    }
+    return vClients;
+}
+// Build a synthetic transaction between two synthetic clients
+Transaction makeSyntheticTransaction(int i, int clientCount) {
+    Transaction txn;
+    txn.TransactionID = "TXN" + formatInt(1700000000 + i) + "0000abcd";
+    txn.Type = static_cast<TransactionType>(1 + i % 3);
+    txn.FromAccount = makeSyntheticClient(i % clientCount).AccountNumber;
+    txn.ToAccount = (txn.Type == TRANSFER) ? makeSyntheticClient((i * 31 + 7) % clientCount).AccountNumber : txn.FromAccount;
+    txn.Amount = (10 + i % 1000) * 100;
+    txn.Fees = (txn.Type == TRANSFER) ? calculateTransferFee(txn.Amount) : 0;
+    txn.Timestamp = "2026-01-01 12:00:00";
+    txn.Description = (txn.Type == TRANSFER) ? "Transfer to Client " + formatInt(i % clientCount) : "Deposit operation";
+    return txn;
+}
+// Write synthetic transactions straight to a ledger file
+void writeSyntheticTransactions(const string& fileName, int count, int clientCount) {
+    ofstream out(fileName, ios::trunc);
+    for (int i = 0; i < count; i++) {
+        out << serializeTransactionRecord(makeSyntheticTransaction(i, clientCount)) << "\n";
+    }
+}
+// Delete the segmented ledger, its manifest and indexes, and forget them in memory
+void resetLedgerFiles() {
+    openLedger(TransactionsFileName);
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        remove(segment.FileName.c_str());
+    }
+    remove(getLedgerManifestFileName(TransactionsFileName).c_str());
+    remove(getTransactionIndexFileName(TransactionsFileName).c_str());
+    closeTransactionIdIndex();
+    remove(getTransactionIdIndexFileName(TransactionsFileName).c_str());
+    remove((TransactionsFileName + ".bak").c_str());
+    for (int number = 1; remove((TransactionsFileName + ".bak." + to_string(number)).c_str()) == 0; number++) {
+    }
+    remove(TransactionsFileName.c_str());
+    closeLedger();
+    TransactionIndex = strTransactionIndex();
+}
+// Append a block of lines to a file once it is large
+void flushGeneratedLines(ofstream& out, string& block, bool force) {
+    if (force || block.size() >= 4 * 1024 * 1024) {
+        out.write(block.data(), block.size());
+        block.clear();
+    }
+}
+// Size of a file in bytes
+long long fileSizeOf(const string& fileName) {
+    ifstream file(fileName, ios::binary | ios::ate);
+    return file.is_open() ? static_cast<long long>(file.tellg()) : 0;
+}
+// Print lines/sec and bytes/sec for a load
+void printParseRate(const string& name, size_t lines, long long bytes, double seconds) {
+    cout << "  " << left << setw(34) << name
+        << right << setw(10) << lines << " lines"
+        << setw(10) << fixed << setprecision(3) << seconds << " s"
+        << setw(14) << setprecision(0) << lines / seconds << " lines/s"
+        << setw(10) << setprecision(1) << bytes / seconds / (1024 * 1024) << " MB/s\n";
+}
+// Print one result row
+void printBenchRow(const string& name, int scale, int ops, double seconds) {
+    cout << "  " << left << setw(28) << name
+        << right << setw(10) << scale
+        << setw(10) << ops
+        << setw(12) << fixed << setprecision(3) << seconds
+        << setw(14) << setprecision(1) << (seconds > 0 ? ops / seconds : 0) << " ops/s\n";
+}
+// Print table header
+void printBenchHeader(const string& title) {
+    cout << "\n" << title << "\n";
+    cout << "  " << left << setw(28) << "case"
+        << right << setw(10) << "clients"
+        << setw(10) << "ops"
+        << setw(12) << "seconds"
+        << setw(14) << "throughput" << "\n";
+}
+
+//=====================================================
+//========== Balance Persistence (Journal) ============
+//=====================================================
+
+// Compare full-file save per operation with journal append + checkpoints
+void benchmarkBalancePersistence() {
+    printBenchHeader("Balance persistence: full Clients.txt rewrite vs journal");
+
+    const int scales[] = { 10000, 100000, 1000000 };
+    for (int scale : scales) {
+        vector<strClient> vClients = makeSyntheticClients(scale);
+        remove(getJournalFileName(ClientsFileName).c_str());
+        remove(getCheckpointFileName(ClientsFileName).c_str());
+        saveClientsToFile(ClientsFileName, vClients);
+
+        // Legacy path: rewrite the whole file after every operation
+        int ops = 0;
+        BenchClock::time_point start = BenchClock::now();
+        while (ops < 3 || (secondsSince(start) < 3.0 && ops < 2000)) {
+            vClients[ops % scale].AccountBalance += 100;
+            saveClientsToFile(ClientsFileName, vClients);
+            ops++;
+        }
+        printBenchRow("full rewrite per op", scale, ops, secondsSince(start));
+
+        // Journal path: one appended record, checkpoint every JournalCheckpointInterval
+        vClients = loadClientsDataFromFile(ClientsFileName);
+        ops = 2 * JournalCheckpointInterval + JournalCheckpointInterval / 2;
+        start = BenchClock::now();
+        for (int i = 0; i < ops; i++) {
+            strClient& client = vClients[i % scale];
+            client.AccountBalance += 100;
+            commitBalanceChange(vClients, "BENCH" + formatInt(i), { { client.AccountNumber, 100 } });
+        }
+        printBenchRow("journal append + checkpoint", scale, ops, secondsSince(start));
+
+        Money expectedBalance = vClients[0].AccountBalance;
+        start = BenchClock::now();
+        vClients = loadClientsDataFromFile(ClientsFileName);
+        if (vClients.empty() || vClients[0].AccountBalance != expectedBalance) {
+            cout << "  ERROR: replayed balance does not match in-memory balance\n";
+        }
+        cout << "  startup load + replay of " << JournalState.PendingEntries << " records: "
+            << fixed << setprecision(3) << secondsSince(start) << " s\n";
+    }
+}
+
+//=====================================================
+//================ Binary Client File =================
+//=====================================================
+
+// Compare text and binary client storage: load, postings and a save with one change
+void benchmarkBinaryClients() {
+    printBenchHeader("Client storage: Clients.txt + journal vs Clients.dat slots");
+
+    const int scales[] = { 10000, 100000, 1000000 };
+    for (int scale : scales) {
+        vector<strClient> vClients = makeSyntheticClients(scale);
+        string binaryFileName = getBinaryClientsFileName(ClientsFileName);
+        for (const string& fileName : { ClientsFileName, binaryFileName }) {
+            remove(getJournalFileName(fileName).c_str());
+            remove(getCheckpointFileName(fileName).c_str());
+        }
+        ClientFile.Format = CLIENTS_TEXT;
+        saveClientsToFile(ClientsFileName, vClients);
+        writeBinaryClientsFile(binaryFileName, vClients, 0);
+
+        const int ops = 2 * JournalCheckpointInterval + JournalCheckpointInterval / 2;
+        for (ClientFileFormat format : { CLIENTS_TEXT, CLIENTS_BINARY }) {
+            ClientFile.Format = format;
+            string label = (format == CLIENTS_TEXT) ? "text " : "binary ";
+
+            BenchClock::time_point start = BenchClock::now();
+            vClients = loadClientsDataFromFile(ClientsFileName);
+            printBenchRow(label + "load", scale, 1, secondsSince(start));
+
+            start = BenchClock::now();
+            for (int i = 0; i < ops; i++) {
+                strClient& client = vClients[i % scale];
+                client.AccountBalance += 100;
+                commitBalanceChange(vClients, "BENCH" + formatInt(i), { { client.AccountNumber, 100 } });
+            }
+            printBenchRow(label + "deposit commit", scale, ops, secondsSince(start));
+
+            start = BenchClock::now();
+            for (int i = 0; i < ops; i++) {
+                strClient& from = vClients[i % scale];
+                strClient& to = vClients[(i + 1) % scale];
+                from.AccountBalance -= 100;
+                to.AccountBalance += 100;
+                commitBalanceChange(vClients, "BENCH" + formatInt(i),
+                    { { from.AccountNumber, -100 }, { to.AccountNumber, 100 } });
+            }
+            printBenchRow(label + "transfer commit", scale, ops, secondsSince(start));
+
+            vClients[scale / 2].Name = "Renamed client";
+            start = BenchClock::now();
+            saveClientsToFile(ClientsFileName, vClients);
+            printBenchRow(label + "save, 1 client changed", scale, 1, secondsSince(start));
+
+            Money expectedBalance = vClients[1].AccountBalance;
+            vClients = loadClientsDataFromFile(ClientsFileName);
+            if (vClients.size() != static_cast<size_t>(scale) || vClients[1].AccountBalance != expectedBalance) {
+                cout << "  ERROR: reloaded " << label << "clients do not match memory\n";
+            }
+        }
+        cout << "  file size: text " << fileSizeOf(ClientsFileName) / 1024 << " KB, binary "
+            << fileSizeOf(binaryFileName) / 1024 << " KB\n";
+    }
+
+    // A file of another version is loaded as empty and must never be written over
+    ClientFile.Format = CLIENTS_BINARY;
+    string binaryFileName = getBinaryClientsFileName(ClientsFileName);
+    remove(getJournalFileName(binaryFileName).c_str());
+    writeBinaryClientsFile(binaryFileName, makeSyntheticClients(10), 0);
+    {
+        fstream file(binaryFileName, ios::binary | ios::in | ios::out);
+        uint32_t version = BinaryClientsVersion + 1;
+        file.seekp(offsetof(strBinaryClientHeader, Version));
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    string before, after;
+    readFileToString(binaryFileName, before);
+    vector<strClient> newer = loadClientsDataFromFile(ClientsFileName);
+    bool refused = !appendBinaryClient(binaryFileName, makeSyntheticClients(11).back()) &&
+        !saveClientsToFileAtomic(ClientsFileName, newer);
+    readFileToString(binaryFileName, after);
+    cout << "  newer version file: " << (refused && before == after ? "left untouched: OK" : "overwritten: ERROR") << "\n";
+    remove(binaryFileName.c_str());
+    ClientFile.Format = CLIENTS_TEXT;
+    closeBinaryClientFile();
+}
+
+//=====================================================
+//================= Lookup (Hash Index) ===============
+//=====================================================
+
+// Linear scan used by findClientByAccountNumber before the hash index
+strClient* findClientByLinearScan(const string& accountNumber, vector<strClient>& vClients) {
+    for (auto& c : vClients) {
+        if (c.AccountNumber == accountNumber)
+            return &c;
+    }
+    return nullptr;
+}
+// Compare per-lookup latency of linear scan and hash index at 1M accounts
+void benchmarkAccountLookup() {
+    const int scale = 1000000;
+    vector<strClient> vClients = makeSyntheticClients(scale);
+    vector<string> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back(makeSyntheticClient((i * 7919) % scale).AccountNumber);
+    }
+    keys.push_back("MISSING0000");
+
+    cout << "\nAccount lookup latency (" << scale << " accounts)\n";
+
+    BenchClock::time_point start = BenchClock::now();
+    invalidateHashIndex(ClientIndex);
+    findClientByAccountNumber(keys[0], vClients);
+    cout << "  index build              : " << fixed << setprecision(3) << secondsSince(start) << " s\n";
+
+    int found = 0;
+    int lookups = 200;
+    start = BenchClock::now();
+    for (int i = 0; i < lookups; i++) {
+        if (findClientByLinearScan(keys[i % keys.size()], vClients)) found++;
+    }
+    cout << "  linear scan              : " << setprecision(1)
+        << secondsSince(start) * 1e9 / lookups << " ns/lookup\n";
+
+    lookups = 2000000;
+    start = BenchClock::now();
+    for (int i = 0; i < lookups; i++) {
+        if (findClientByAccountNumber(keys[i % keys.size()], vClients)) found++;
+    }
+    cout << "  hash index               : " << setprecision(1)
+        << secondsSince(start) * 1e9 / lookups << " ns/lookup (" << found << " hits)\n";
+}
+
+//=====================================================
+//================= Record Parsing ====================
+//=====================================================
+
+// Tokenizer used before the string_view scanner: copy by value, erase per field
+vector<string> splitStringByErase(string S1, string delim = Separator) {
+    vector<string> split;
+    size_t pos = 0;
+    string sWord;
+
+    while ((pos = S1.find(delim)) != string::npos) {
+        sWord = S1.substr(0, pos);
+        if (sWord != "") {
+            split.push_back(sWord);
+        }
+        S1.erase(0, pos + delim.length());
+    }
+    if (S1 != "") {
+        split.push_back(S1);
+    }
+    return split;
+}
+// Report lines/sec and bytes/sec of the client and transaction loaders
+void benchmarkRecordParsing() {
+    const int clientCount = 1000000;
+    const int transactionCount = 1000000;
+
+    cout << "\nRecord parsing\n";
+
+    saveClientsToFile(ClientsFileName, makeSyntheticClients(clientCount));
+    writeSyntheticTransactions(TransactionsFileName, transactionCount, clientCount);
+    remove(getJournalFileName(ClientsFileName).c_str());
+
+    BenchClock::time_point start = BenchClock::now();
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    printParseRate("loadClientsDataFromFile", vClients.size(), fileSizeOf(ClientsFileName), secondsSince(start));
+
+    start = BenchClock::now();
+    vector<Transaction> transactions = loadTransactionsFromFile(TransactionsFileName);
+    printParseRate("loadTransactionsFromFile", transactions.size(), fileSizeOf(TransactionsFileName), secondsSince(start));
+
+    // Tokenizer only, same ledger lines: legacy erase-based split vs view scanner
+    vector<string> lines;
+    for (int i = 0; i < 200000; i++) {
+        lines.push_back(serializeTransactionRecord(makeSyntheticTransaction(i, clientCount)));
+    }
+    long long bytes = 0;
+    for (const string& line : lines) bytes += line.size() + 1;
+
+    size_t fields = 0;
+    start = BenchClock::now();
+    for (const string& line : lines) fields += splitStringByErase(line, Separator).size();
+    printParseRate("tokenize: erase-based split", lines.size(), bytes, secondsSince(start));
+
+    start = BenchClock::now();
+    string_view views[8];
+    for (const string& line : lines) fields += splitFieldViews(line, Separator, views, 8);
+    printParseRate("tokenize: string_view scanner", lines.size(), bytes, secondsSince(start));
+
+    if (fields == 0) cout << "  (no fields parsed)\n";
+}
+
+//=====================================================
+//================ Parallel Loading ===================
+//=====================================================
+
+// Loader used before chunked loading: getline + per-line parse on one thread
+vector<strClient> loadClientsSequential(const string& fileName) {
+    vector<strClient> vClients;
+    ifstream file(fileName);
+    string line;
+    while (getline(file, line)) {
+        if (trimView(line).empty()) continue;
+        strClient client;
+        string error;
+        parseClientRecord(line, client, error);
+        if (!client.MarkForDelete || !client.AccountNumber.empty()) {
+            vClients.push_back(move(client));
+        }
+    }
+    return vClients;
+}
+// Transaction loader used before chunked loading
+vector<Transaction> loadTransactionsSequential(const string& fileName) {
+    vector<Transaction> transactions;
+    ifstream file(fileName);
+    string line;
+    while (getline(file, line)) {
+        if (line.empty()) continue;
+        Transaction txn;
+        string error;
+        parseTransactionRecord(line, txn, error);
+        transactions.push_back(move(txn));
+    }
+    return transactions;
+}
+// Compare single-threaded getline loading with parallel chunked loading
+void benchmarkParallelLoading() {
+    const int clientCount = 1000000;
+    const int transactionScales[] = { 1000000, 10000000 };
+
+    cout << "\nParallel loading (" << max(1u, thread::hardware_concurrency()) << " hardware threads)\n";
+
+    saveClientsToFile(ClientsFileName, makeSyntheticClients(clientCount));
+    remove(getJournalFileName(ClientsFileName).c_str());
+    long long clientBytes = fileSizeOf(ClientsFileName);
+
+    BenchClock::time_point start = BenchClock::now();
+    size_t loaded = loadClientsSequential(ClientsFileName).size();
+    printParseRate("clients: sequential getline", loaded, clientBytes, secondsSince(start));
+
+    start = BenchClock::now();
+    loaded = loadClientsDataFromFile(ClientsFileName).size();
+    printParseRate("clients: parallel chunks", loaded, clientBytes, secondsSince(start));
+
+    for (int scale : transactionScales) {
+        writeSyntheticTransactions(TransactionsFileName, scale, clientCount);
+        long long transactionBytes = fileSizeOf(TransactionsFileName);
+
+        start = BenchClock::now();
+        loaded = loadTransactionsSequential(TransactionsFileName).size();
+        printParseRate("ledger " + formatInt(scale) + ": sequential", loaded, transactionBytes, secondsSince(start));
+
+        start = BenchClock::now();
+        loaded = loadTransactionsFromFile(TransactionsFileName).size();
+        printParseRate("ledger " + formatInt(scale) + ": parallel chunks", loaded, transactionBytes, secondsSince(start));
+    }
+    remove(TransactionsFileName.c_str());
+}
+
+//=====================================================
+//================ Transaction History ================
+//=====================================================
+
+// Compare full ledger load + filter with the per-account offset index
+void benchmarkTransactionHistory() {
+    const int clientCount = 100000;
+    const int transactionCount = 1000000;
+    const int queries = 1000;
+
+    cout << "\nTransaction history (" << transactionCount << " ledger lines, " << clientCount << " accounts)\n";
+
+    resetLedgerFiles();
+    writeSyntheticTransactions(TransactionsFileName, transactionCount, clientCount);
+
+    BenchClock::time_point start = BenchClock::now();
+    vector<Transaction> transactions = loadTransactionsFromFile(TransactionsFileName);
+    size_t matches = 0;
+    string account = makeSyntheticClient(42).AccountNumber;
+    for (const Transaction& txn : transactions) {
+        if (txn.FromAccount == account || txn.ToAccount == account) matches++;
+    }
+    cout << "  full load + filter       : " << fixed << setprecision(3) << secondsSince(start)
+        << " s/query (" << matches << " rows)\n";
+    transactions.clear();
+    transactions.shrink_to_fit();
+
+    start = BenchClock::now();
+    ensureTransactionIndex(TransactionsFileName);
+    cout << "  migrate + index (once)   : " << secondsSince(start) << " s\n";
+
+    closeLedger();
+    TransactionIndex = strTransactionIndex();
+    start = BenchClock::now();
+    ensureTransactionIndex(TransactionsFileName);
+    cout << "  index load (per session) : " << secondsSince(start) << " s\n";
+
+    matches = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        matches += loadAccountTransactions(TransactionsFileName, makeSyntheticClient(i * 97 % clientCount).AccountNumber).size();
+    }
+    cout << "  indexed history          : " << setprecision(1) << secondsSince(start) * 1e6 / queries
+        << " us/query (" << matches / queries << " rows avg)\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        saveTransactionToFile(makeSyntheticTransaction(transactionCount + i, clientCount));
+    }
+    cout << "  save + index append      : " << secondsSince(start) * 1e6 / queries << " us/op\n";
+
+    resetLedgerFiles();
+}
+
+//=====================================================
+//================== Transaction IDs ==================
+//=====================================================
+
+// Generator used before the Snowflake IDs: stringstream of microseconds + random
+string generateLegacyTransactionID() {
+    auto now = chrono::high_resolution_clock::now();
+    auto timestamp = chrono::duration_cast<chrono::microseconds>(
+        now.time_since_epoch()).count();
+
+    uint32_t randomNum = randombytes_random();
+
+    stringstream ss;
+    ss << "TXN" << timestamp << hex << setw(8) << setfill('0') << randomNum;
+    return ss.str();
+}
+// Print time and heap allocations per ID of one single-threaded generator
+template <typename Generate>
+void printIdGeneratorRate(const string& name, int count, Generate generate) {
+    size_t textBytes = 0;
+    long long allocations = HeapAllocations.load();
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < count; i++) {
+        textBytes += generate();
+    }
+    double seconds = secondsSince(start);
+    cout << "  " << left << setw(28) << name << right << fixed << setprecision(1) << setw(8)
+        << seconds * 1e9 / count << " ns/ID  " << setprecision(2)
+        << double(HeapAllocations.load() - allocations) / count << " allocations/ID  "
+        << textBytes / count << " chars\n";
+}
+// Threads taking IDs at once: IDs/s, duplicates, and IDs not above the previous one of their thread
+template <typename Id, typename Generate>
+void runIdGeneratorThreads(const string& name, int threadCount, int perThread, Generate generate) {
+    vector<vector<Id>> ids(threadCount);
+    vector<thread> threads;
+    BenchClock::time_point start = BenchClock::now();
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t] {
+            ids[t].reserve(perThread);
+            for (int i = 0; i < perThread; i++) {
+                ids[t].push_back(generate());
+            }
+        });
+    }
+    for (thread& worker : threads) {
+        worker.join();
+    }
+    double seconds = secondsSince(start);
+
+    long long outOfOrder = 0;
+    vector<Id> all;
+    all.reserve(static_cast<size_t>(threadCount) * perThread);
+    for (const vector<Id>& threadIds : ids) {
+        for (size_t i = 1; i < threadIds.size(); i++) {
+            if (!(threadIds[i - 1] < threadIds[i])) outOfOrder++;
+        }
+        all.insert(all.end(), threadIds.begin(), threadIds.end());
+    }
+    sort(all.begin(), all.end());
+    long long duplicates = 0;
+    for (size_t i = 1; i < all.size(); i++) {
+        if (all[i - 1] == all[i]) duplicates++;
+    }
+
+    cout << "  " << left << setw(12) << name << right << setw(8) << threadCount << setw(14) << fixed << setprecision(0)
+        << threadCount * perThread / seconds << setw(12) << duplicates << setw(14) << outOfOrder << "\n";
+}
+#ifndef _WIN32
+// Fork a worker process. Only this thread is copied: the log lock is held across the fork so no child
+// inherits it locked (the child's log lines are never written)
+pid_t forkBenchProcess() {
+    lock_guard<mutex> lock(AsyncLogger.Lock);
+    return fork();
+}
+// Snowflake IDs from concurrent processes, each claiming the lowest free node: duplicates and nodes used
+void runIdGeneratorProcesses(int processCount, int perProcess) {
+    vector<pid_t> children;
+    BenchClock::time_point start = BenchClock::now();
+    for (int p = 0; p < processCount; p++) {
+        pid_t pid = forkBenchProcess();
+        if (pid == 0) {
+            releaseTransactionNode();       // The parent's node lock is shared with the child; take a new node
+            vector<uint64_t> ids(perProcess);
+            for (uint64_t& id : ids) {
+                id = nextTransactionId();
+            }
+            ofstream out("ids_process" + to_string(p) + ".bin", ios::binary | ios::trunc);
+            out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(uint64_t));
+            out.close();
+            _exit(out ? 0 : 1);
+        }
+        if (pid > 0) {
+            children.push_back(pid);
+        }
+    }
+    for (pid_t child : children) {
+        waitpid(child, nullptr, 0);
+    }
+    double seconds = secondsSince(start);
+
+    vector<uint64_t> all;
+    for (int p = 0; p < processCount; p++) {
+        string fileName = "ids_process" + to_string(p) + ".bin";
+        string content;
+        if (readFileToString(fileName, content)) {
+            const uint64_t* ids = reinterpret_cast<const uint64_t*>(content.data());
+            all.insert(all.end(), ids, ids + content.size() / sizeof(uint64_t));
+        }
+        remove(fileName.c_str());
+    }
+    sort(all.begin(), all.end());
+    long long duplicates = 0;
+    vector<char> nodes(1u << TransactionIdNodeBits, 0);
+    for (size_t i = 0; i < all.size(); i++) {
+        if (i > 0 && all[i - 1] == all[i]) duplicates++;
+        nodes[(all[i] >> TransactionIdSequenceBits) & ((1u << TransactionIdNodeBits) - 1)] = 1;
+    }
+
+    cout << "  " << left << setw(12) << "processes" << right << setw(8) << processCount << setw(14) << fixed
+        << setprecision(0) << all.size() / seconds << setw(12) << duplicates << "   "
+        << count(nodes.begin(), nodes.end(), 1) << " nodes, " << all.size() << "/"
+        << static_cast<long long>(processCount) * perProcess << " IDs\n";
+}
+#endif
+// Legacy and Snowflake generators: cost per ID, then uniqueness and order under concurrent threads and processes
+void benchmarkTransactionIds() {
+    const int count = 1000000;
+
+    cout << "\nTransaction IDs (" << count << " per run)\n";
+    printIdGeneratorRate("legacy stringstream", count, [] { return generateLegacyTransactionID().size(); });
+    printIdGeneratorRate("generateTransactionID()", count, [] { return generateTransactionID().size(); });
+    string reused;
+    printIdGeneratorRate("assignTransactionID()", count, [&] {
+        assignTransactionID(reused);
+        return reused.size();
+    });
+    char buffer[TransactionIdTextSize];
+    printIdGeneratorRate("next + writeTransactionId()", count, [&] {
+        return static_cast<size_t>(writeTransactionId(buffer, nextTransactionId()) - buffer);
+    });
+
+    cout << "  " << left << setw(12) << "generator" << right << setw(8) << "threads" << setw(14) << "IDs/s"
+        << setw(12) << "duplicates" << setw(14) << "out of order" << "\n";
+    for (int threads : { 1, 2, 4, 8 }) {
+        runIdGeneratorThreads<string>("legacy", threads, count / threads, [] { return generateLegacyTransactionID(); });
+        runIdGeneratorThreads<uint64_t>("snowflake", threads, count / threads, [] { return nextTransactionId(); });
+    }
+#ifndef _WIN32
+    runIdGeneratorProcesses(4, count / 4);
+#endif
+    cout << "  snowflake IDs stamped ahead of the clock: " << IdGenerator.Borrowed.load() << "\n";
+}
+
+//=====================================================
+//=============== Transaction ID Lookup ===============
+//=====================================================
+
+// Lookup by transaction ID: scan of the segment whose ID range holds it vs the on-disk ID table
+void benchmarkTransactionIdLookup() {
+    const int clientCount = 100000;
+    const int transactionCount = 2000000;
+    const int scanQueries = 50;
+    const int queries = 10000;
+
+    cout << "\nTransaction ID lookup (" << transactionCount << " ledger lines)\n";
+
+    resetLedgerFiles();
+    writeSyntheticTransactions(TransactionsFileName, transactionCount, clientCount);
+    long long ledgerSize = getLedgerSize(TransactionsFileName);
+
+    Transaction found;
+    int matches = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < scanQueries; i++) {
+        string transactionID = makeSyntheticTransaction(i * 7919 % transactionCount, clientCount).TransactionID;
+        matches += findLedgerTransaction(TransactionsFileName, transactionID, found) ? 1 : 0;
+    }
+    cout << "  segment scan             : " << fixed << setprecision(1) << secondsSince(start) * 1e6 / scanQueries
+        << " us/query (" << matches << "/" << scanQueries << " found)\n";
+
+    start = BenchClock::now();
+    rebuildTransactionIdIndex(TransactionsFileName);
+    long long tableBytes = fileSizeOf(getTransactionIdIndexFileName(TransactionsFileName));
+    cout << "  table build (once)       : " << setprecision(3) << secondsSince(start) << " s, "
+        << setprecision(1) << tableBytes / 1048576.0 << " MB (" << tableBytes * 100.0 / ledgerSize << "% of ledger)\n";
+
+    matches = 0;
+    TransactionIds.Probes = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        string transactionID = makeSyntheticTransaction(i * 7919 % transactionCount, clientCount).TransactionID;
+        matches += findTransactionById(TransactionsFileName, transactionID, found) ? 1 : 0;
+    }
+    cout << "  table lookup             : " << secondsSince(start) * 1e6 / queries << " us/query (" << matches
+        << "/" << queries << " found, " << setprecision(2) << double(TransactionIds.Probes) / queries << " slot reads)\n";
+
+    matches = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        matches += findTransactionById(TransactionsFileName, "TXN" + formatInt(i) + ReversalIdSuffix, found) ? 1 : 0;
+    }
+    cout << "  table lookup, absent ID  : " << setprecision(1) << secondsSince(start) * 1e6 / queries
+        << " us/query (" << matches << " found)\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        saveTransactionToFile(makeSyntheticTransaction(transactionCount + i, clientCount));
+    }
+    cout << "  save + indexes           : " << secondsSince(start) * 1e6 / queries << " us/op ("
+        << TransactionIds.Entries << " IDs, " << TransactionIds.SlotCount << " slots)\n";
+
+    // A record repeating an indexed ID is not indexed, appended or rebuilt; lookups keep finding the first
+    Transaction first = makeSyntheticTransaction(transactionCount, clientCount);
+    Transaction repeated = first;
+    repeated.Description = "Same ID again";
+    uint64_t entries = TransactionIds.Entries;
+    saveTransactionToFile(repeated);
+    bool refused = TransactionIds.Entries == entries &&
+        findTransactionById(TransactionsFileName, first.TransactionID, found) && found.Description == first.Description;
+    rebuildTransactionIdIndex(TransactionsFileName);
+    refused = refused && TransactionIds.Entries == entries &&
+        findTransactionById(TransactionsFileName, first.TransactionID, found) && found.Description == first.Description;
+    cout << "  repeated ID              : " << (refused ? "not indexed: OK" : "indexed twice: ERROR") << "\n";
+
+    resetLedgerFiles();
+}
+
+//=====================================================
+//================ Recent Transactions ================
+//=====================================================
+
+// History and client card reads: full indexed history vs the recent transactions ring
+void benchmarkRecentTransactions() {
+    const int clientCount = 20000;
+    const int transactionCount = 1000000;
+    const int queries = 1000;
+
+    cout << "\nRecent transactions (" << transactionCount << " ledger lines, " << clientCount << " accounts)\n";
+
+    resetLedgerFiles();
+    writeSyntheticTransactions(TransactionsFileName, transactionCount, clientCount);
+    ensureTransactionIndex(TransactionsFileName);
+    clearRecentTransactions();
+
+    size_t rows = 0;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        rows += loadAccountTransactions(TransactionsFileName, makeSyntheticClient(i * 97 % clientCount).AccountNumber).size();
+    }
+    cout << "  full indexed history     : " << fixed << setprecision(1) << secondsSince(start) * 1e6 / queries
+        << " us/query (" << rows / queries << " rows avg)\n";
+
+    size_t total = 0;
+    rows = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        rows += getRecentTransactions(makeSyntheticClient(i * 97 % clientCount).AccountNumber, total).size();
+    }
+    string label = "ring miss (last " + to_string(RecentTransactionsCount) + ")";
+    label.resize(25, ' ');
+    cout << "  " << label << ": " << secondsSince(start) * 1e6 / queries
+        << " us/query (" << rows / queries << " rows avg)\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        rows += getRecentTransactions(makeSyntheticClient(i * 97 % clientCount).AccountNumber, total).size();
+    }
+    cout << "  ring hit                 : " << secondsSince(start) * 1e6 / queries << " us/query\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        saveTransactionToFile(makeSyntheticTransaction(transactionCount + i, clientCount));
+    }
+    cout << "  save + index + ring      : " << secondsSince(start) * 1e6 / queries << " us/op\n";
+
+    // Teller-style mix: most views go to a small set of busy accounts
+    clearRecentTransactions();
+    RecentCache.Hits = 0;
+    RecentCache.Misses = 0;
+    RecentCache.Updates = 0;
+    RecentCache.Evictions = 0;
+    for (int i = 0; i < queries * 10; i++) {
+        int client = (i % 10 < 9) ? (i * 7919) % 200 : (i * 7919) % clientCount;
+        getRecentTransactions(makeSyntheticClient(client).AccountNumber, total);
+        if (i % 4 == 0) {
+            saveTransactionToFile(makeSyntheticTransaction(transactionCount + queries + i, clientCount));
+        }
+    }
+    cout << "  mixed views + postings   : " << formatRecentCacheCounters() << "\n";
+
+    // A miss whose index load reloads the account dictionary (replaced by another process) must not hang
+    filesystem::resize_file(AccountIds.FileName, AccountIds.PersistedBytes / 2);
+    TransactionIndex = strTransactionIndex();
+    future<size_t> reloadMiss = async(launch::async, [&] {
+        return getRecentTransactions(makeSyntheticClient(1).AccountNumber, total).size();
+    });
+    if (reloadMiss.wait_for(chrono::seconds(60)) != future_status::ready) {
+        cout << "  ERROR: a ring miss that reloads the account dictionary deadlocked\n" << flush;
+        _exit(1);
+    }
+    cout << "  miss after dictionary reload: " << reloadMiss.get() << " rows\n";
+
+    clearRecentTransactions();
+    resetLedgerFiles();
+}
+
+//=====================================================
+//================= Segmented Ledger ==================
+//=====================================================
+
+// Synthetic transaction with a distinct timestamp per second
+Transaction makeTimedTransaction(int i, int clientCount) {
+    Transaction txn = makeSyntheticTransaction(i, clientCount);
+    ostringstream timestamp;
+    timestamp << "2026-01-" << setw(2) << setfill('0') << 1 + i / 86400 % 28 << " "
+        << setw(2) << i / 3600 % 24 << ":" << setw(2) << i / 60 % 60 << ":" << setw(2) << i % 60;
+    txn.Timestamp = timestamp.str();
+    return txn;
+}
+#ifndef _WIN32
+// Processes append to the same ledger past a seal; every segment must match the manifest and hold its records
+void checkLedgerProcesses(int processCount, int perProcess, int clientCount) {
+    refreshLedger(TransactionsFileName);
+    long long records = 0;
+    for (const strLedgerSegment& segment : Ledger.Segments) records += segment.Records;
+
+    vector<pid_t> children;
+    for (int p = 0; p < processCount; p++) {
+        pid_t pid = forkBenchProcess();
+        if (pid == 0) {
+            vector<Transaction> transactions;
+            vector<string> lines;
+            vector<long long> offsets;
+            for (int i = 0; i < perProcess; i++) {
+                transactions.push_back(makeTimedTransaction(p * perProcess + i, clientCount));
+                lines.push_back(serializeTransactionRecord(transactions.back()));
+                if (transactions.size() == 1000 || i == perProcess - 1) {
+                    appendLedgerRecords(TransactionsFileName, transactions, lines, offsets);
+                    transactions.clear();
+                    lines.clear();
+                }
+            }
+            _exit(0);
+        }
+        if (pid > 0) {
+            children.push_back(pid);
+        }
+    }
+    for (pid_t child : children) {
+        waitpid(child, nullptr, 0);
+    }
+
+    // Read back as a fresh process would
+    closeLedger();
+    openLedger(TransactionsFileName);
+    long long found = 0, wrong = 0, expectedOffset = 0;
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        if (segment.BaseOffset != expectedOffset || getFileSize(segment.FileName) != segment.Bytes) wrong++;
+        expectedOffset = segment.BaseOffset + segment.Bytes;
+        found += segment.Records;
+    }
+    cout << "  " << processCount << " processes appending    : " << found - records << " records, "
+        << Ledger.Segments.size() << " segments, " << wrong << " not matching the manifest\n";
+    if (wrong > 0 || found - records != static_cast<long long>(processCount) * perProcess) {
+        cout << "  ERROR: processes appended to a sealed segment\n";
+    }
+
+    // A single file written after the migration is not moved over the backup
+    closeLedger();
+    Transaction stray = makeTimedTransaction(0, clientCount);
+    stray.Description = "Written by an older version";
+    appendLineToFile(TransactionsFileName, serializeTransactionRecord(stray));
+    bool refused = false;
+    try {
+        openLedger(TransactionsFileName);
+    }
+    catch (const exception&) {
+        refused = true;
+    }
+    remove(TransactionsFileName.c_str());
+    cout << "  records outside segments : " << (refused ? "refused: OK" : "moved to backup: ERROR") << "\n";
+}
+#endif
+// Migration, append with rotation and range queries that skip sealed segments
+void benchmarkSegmentedLedger() {
+    const int clientCount = 10000;
+    const int transactionCount = 1000000;
+    const int appends = 100000;
+
+    cout << "\nSegmented ledger (" << transactionCount << " records)\n";
+
+    resetLedgerFiles();
+    {
+        ofstream out(TransactionsFileName, ios::trunc);
+        for (int i = 0; i < transactionCount; i++) {
+            out << serializeTransactionRecord(makeTimedTransaction(i, clientCount)) << "\n";
+        }
+    }
+
+    BenchClock::time_point start = BenchClock::now();
+    vector<Transaction> all = loadTransactionsFromFile(TransactionsFileName);
+    size_t matches = 0;
+    for (const Transaction& txn : all) {
+        if (txn.Timestamp >= "2026-01-03 00:00:00" && txn.Timestamp <= "2026-01-03 23:59:59") matches++;
+    }
+    cout << "  single file: one day     : " << fixed << setprecision(3) << secondsSince(start)
+        << " s (" << matches << " rows)\n";
+    all.clear();
+    all.shrink_to_fit();
+
+    start = BenchClock::now();
+    openLedger(TransactionsFileName);
+    cout << "  migrate to segments      : " << secondsSince(start) << " s ("
+        << Ledger.Segments.size() << " segments)\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < appends; i++) {
+        Transaction txn = makeTimedTransaction(transactionCount + i, clientCount);
+        long long offset, nextOffset;
+        appendLedgerRecord(TransactionsFileName, txn, serializeTransactionRecord(txn), offset, nextOffset);
+    }
+    cout << "  append (with rotation)   : " << setprecision(2) << secondsSince(start) * 1e6 / appends
+        << " us/record (" << Ledger.Segments.size() << " segments)\n";
+
+    for (int pass = 1; pass <= 2; pass++) {
+        start = BenchClock::now();
+        matches = loadLedgerTransactions(TransactionsFileName, "2026-01-03 00:00:00", "2026-01-03 23:59:59").size();
+        cout << "  segments: one day " << (pass == 1 ? "cold   : " : "warm   : ") << setprecision(3)
+            << secondsSince(start) << " s (" << matches << " rows)\n";
+    }
+#ifndef _WIN32
+    checkLedgerProcesses(2, 200000, clientCount);
+#endif
+    resetLedgerFiles();
+}
+
+//=====================================================
+//==================== Ledger View ====================
+//=====================================================
+
+// Heap (anonymous) memory of this process in MB; mapped file pages are not counted (0 if unknown)
+double privateMemoryMB() {
+#ifdef __linux__
+    ifstream statm("/proc/self/statm");
+    long long size = 0, resident = 0, shared = 0;
+    if (statm >> size >> resident >> shared) {
+        return static_cast<double>(resident - shared) * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+    }
+#endif
+    return 0;
+}
+// Print time and heap growth of one ledger read
+void printLedgerRead(const string& name, double seconds, double memoryMB, size_t rows) {
+    cout << "  " << left << setw(34) << name << right << fixed
+        << setw(9) << setprecision(3) << seconds << " s"
+        << setw(10) << setprecision(1) << memoryMB << " MB heap"
+        << setw(12) << rows << " rows\n";
+}
+// Materialized vector<Transaction> versus the mapped view over a ledger larger than the old 100 MB guard
+void benchmarkLedgerView() {
+    const int clientCount = 10000;
+    const int transactionCount = 2000000;
+
+    resetLedgerFiles();
+    {
+        ofstream out(TransactionsFileName, ios::trunc);
+        for (int i = 0; i < transactionCount; i++) {
+            out << serializeTransactionRecord(makeTimedTransaction(i, clientCount)) << "\n";
+        }
+    }
+    long long ledgerBytes = fileSizeOf(TransactionsFileName);
+    cout << "\nLedger view (" << transactionCount << " records, " << ledgerBytes / (1024 * 1024) << " MB)\n";
+
+    BenchClock::time_point start = BenchClock::now();
+    openLedger(TransactionsFileName);
+    printLedgerRead("migrate to " + formatInt(Ledger.Segments.size()) + " segments (mapped)", secondsSince(start), 0,
+        transactionCount);
+
+    // Whole ledger as records, as loadTransactionsFromFile() builds it
+    double memoryBefore = privateMemoryMB();
+    start = BenchClock::now();
+    vector<Transaction> all;
+    for (const strLedgerSegment& segment : Ledger.Segments) {
+        vector<Transaction> records = loadTransactionsFromFile(segment.FileName);
+        move(records.begin(), records.end(), back_inserter(all));
+    }
+    Money total = 0;
+    for (const Transaction& txn : all) total += txn.Amount;
+    printLedgerRead("vector<Transaction>: sum amounts", secondsSince(start), privateMemoryMB() - memoryBefore, all.size());
+    all.clear();
+    all.shrink_to_fit();
+
+    memoryBefore = privateMemoryMB();
+    start = BenchClock::now();
+    strLedgerView view;
+    openLedgerView(TransactionsFileName, view, true);
+    strLedgerCursor cursor;
+    strTransactionView record;
+    Money viewTotal = 0;
+    size_t rows = 0;
+    while (nextLedgerRecord(view, cursor, record)) {
+        viewTotal += record.Amount;
+        rows++;
+    }
+    printLedgerRead("view cursor: sum amounts", secondsSince(start), privateMemoryMB() - memoryBefore, rows);
+    closeLedgerView(view);
+
+    start = BenchClock::now();
+    rows = loadLedgerTransactions(TransactionsFileName, "2026-01-03 00:00:00", "2026-01-03 23:59:59").size();
+    printLedgerRead("view: one day", secondsSince(start), 0, rows);
+
+    Transaction found;
+    string lastID = makeTimedTransaction(transactionCount - 1, clientCount).TransactionID;
+    start = BenchClock::now();
+    rows = findLedgerTransaction(TransactionsFileName, lastID, found) ? 1 : 0;
+    printLedgerRead("view: find last ID", secondsSince(start), 0, rows);
+
+    start = BenchClock::now();
+    rebuildTransactionIndex(TransactionsFileName);
+    rows = loadAccountTransactions(TransactionsFileName, makeSyntheticClient(42).AccountNumber).size();
+    printLedgerRead("view: index rebuild + history", secondsSince(start), 0, rows);
+
+    if (total != viewTotal) {
+        cout << "  MISMATCH: totals differ\n";
+    }
+    resetLedgerFiles();
+}
+
+//=====================================================
+//====================== Metrics ======================
+//=====================================================
+
+// Cost of a scoped timer, and histogram percentiles against exact ones
+void benchmarkMetrics() {
+    const int samples = 1000000;
+    const int threadCount = 8;
+
+    cout << "\nMetrics (" << samples << " samples)\n";
+    resetMetric(METRIC_HISTORY);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < samples; i++) {
+        strMetricTimer timer(METRIC_HISTORY);
+    }
+    cout << "  scoped timer, 1 thread    : " << fixed << setprecision(1) << secondsSince(start) * 1e9 / samples << " ns/op\n";
+
+    start = BenchClock::now();
+    vector<thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < samples / threadCount; i++) {
+                strMetricTimer timer(METRIC_HISTORY);
+            }
+        });
+    }
+    for (thread& worker : threads) worker.join();
+    cout << "  scoped timer, " << threadCount << " threads   : " << secondsSince(start) * 1e9 / samples << " ns/op\n";
+
+    // Log-normal-ish latencies from 1 us to ~100 ms
+    resetMetric(METRIC_HISTORY);
+    vector<uint64_t> values(samples);
+    mt19937_64 random(42);
+    lognormal_distribution<double> latency(11.0, 1.5);
+    for (uint64_t& value : values) {
+        value = static_cast<uint64_t>(min(1e11, latency(random)));
+        recordMetricNanos(METRIC_HISTORY, value);
+    }
+    sort(values.begin(), values.end());
+    for (double fraction : { 0.50, 0.99, 0.999 }) {
+        uint64_t exact = values[static_cast<size_t>(ceil(fraction * samples)) - 1];
+        uint64_t estimate = getMetricPercentile(Metrics.Histograms[METRIC_HISTORY], fraction);
+        cout << "  p" << setw(5) << left << formatDouble(fraction * 100, 1) << right << " exact " << setw(10) << formatNanos(exact)
+            << "  histogram " << setw(10) << formatNanos(estimate) << "  error "
+            << setprecision(2) << 100.0 * (static_cast<double>(estimate) - exact) / exact << " %\n";
+    }
+    resetMetric(METRIC_HISTORY);
+}
+
+//=====================================================
+//==================== Async Logger ===================
+//=====================================================
+
+// Compare open/write/close per log line with the async writer thread
+void benchmarkLogger() {
+    const int lines = 100000;
+    const int flushedLines = 1000;
+    const string message = "Transaction TXN17000000000000abcd - Type: DEPOSIT - Amount: 100.00 - From: AC00000042";
+
+    cout << "\nLogger (" << lines << " lines)\n";
+    flushLogger();
+    remove(LogFileName.c_str());
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < lines; i++) {
+        appendLineToFile(LogFileName, "[" + getCurrentTimestamp() + "] [INFO] [User: SYSTEM] " + message);
+    }
+    cout << "  open/append/close per line : " << fixed << setprecision(2)
+        << secondsSince(start) * 1e6 / lines << " us/line\n";
+    remove(LogFileName.c_str());
+
+    start = BenchClock::now();
+    for (int i = 0; i < lines; i++) {
+        logMessage(message, INFO);
+    }
+    double queued = secondsSince(start);
+    flushLogger();
+    cout << "  async logMessage (INFO)    : " << queued * 1e6 / lines << " us/line caller latency, "
+        << secondsSince(start) * 1e6 / lines << " us/line until written\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < flushedLines; i++) {
+        logMessage(message, WARNING);
+    }
+    cout << "  async logMessage (WARNING) : " << secondsSince(start) * 1e6 / flushedLines
+        << " us/line (waits for write)\n";
+}
+
+//=====================================================
+//=================== Session Cache ===================
+//=====================================================
+
+// Compare per-iteration session decrypt (old menu loop) with the stat-validated cache
+void benchmarkSessionCache() {
+    const int uncachedLoads = 200;
+    const int cachedLoads = 100000;
+
+    cout << "\nSession cache\n";
+
+    // Keep the real session file untouched
+    SessionCache.SessionPath = "session_benchmark.bsess";
+    strUser user;
+    user.UserName = "benchmark";
+    user.Password = "0123456789abcdef0123456789abcdef";
+    user.Permissions = -1;
+    saveCurrentUserSession(user);
+
+    strUser loaded;
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < uncachedLoads; i++) {
+        getSessionPath();
+        releaseCachedEncryptionKey();
+        SessionCache.Checked = false;
+        loadCurrentUserSession(loaded);
+    }
+    cout << "  path + key file + decrypt : " << fixed << setprecision(2)
+        << secondsSince(start) * 1e6 / uncachedLoads << " us/menu iteration\n";
+
+    start = BenchClock::now();
+    for (int i = 0; i < cachedLoads; i++) {
+        loadCurrentUserSession(loaded);
+    }
+    cout << "  cached (stat only)        : " << secondsSince(start) * 1e6 / cachedLoads << " us/menu iteration\n";
+
+    remove(SessionCache.SessionPath.c_str());
+    releaseCachedEncryptionKey();
+    SessionCache = strSessionCache();
+}
+
+//=====================================================
+//=================== Client Store ====================
+//=====================================================
+
+// Menu loop: return to the main menu (and sometimes deposit) with a full reload vs a refresh
+void benchmarkClientStore() {
+    const int clientCount = 10000;
+    const int reloadIterations = 100;
+    const int refreshIterations = 10000;
+
+    printBenchHeader("Client store: reload per menu iteration vs refresh on change");
+
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    saveClientsToFile(ClientsFileName, makeSyntheticClients(clientCount));
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+
+    // One iteration in ten posts a deposit through the journal, like the deposit screen
+    auto menuIteration = [&](int i, bool refresh) {
+        if (i % 10 == 0) {
+            strClient& client = vClients[i % vClients.size()];
+            client.AccountBalance += 100;
+            commitBalanceChange(vClients, "TXN" + formatInt(i), { { client.AccountNumber, 100 } });
+        }
+        if (refresh) {
+            refreshClientsFromFile(ClientsFileName, vClients);
+        }
+        else {
+            vClients = loadClientsDataFromFile(ClientsFileName);
+        }
+    };
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < reloadIterations; i++) {
+        menuIteration(i, false);
+    }
+    printBenchRow("reload every iteration", clientCount, reloadIterations, secondsSince(start));
+
+    ClientStore.Reloads = ClientStore.ReloadsAvoided = ClientStore.StatChecks = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < refreshIterations; i++) {
+        menuIteration(i, true);
+    }
+    printBenchRow(ClientStore.WatchFd >= 0 ? "refresh (inotify)" : "refresh (stat)", clientCount,
+        refreshIterations, secondsSince(start));
+    cout << "  " << ClientStore.Reloads << " reloads, " << ClientStore.ReloadsAvoided << " avoided, "
+        << ClientStore.StatChecks << " stat checks\n";
+
+    stopClientStoreWatch();
+    ClientStore.Reloads = ClientStore.ReloadsAvoided = ClientStore.StatChecks = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < refreshIterations; i++) {
+        menuIteration(i, true);
+    }
+    printBenchRow("refresh (stat only)", clientCount, refreshIterations, secondsSince(start));
+    cout << "  " << ClientStore.Reloads << " reloads, " << ClientStore.ReloadsAvoided << " avoided, "
+        << ClientStore.StatChecks << " stat checks\n";
+
+    // A write by another process must still be picked up
+    vector<strClient> external = makeSyntheticClients(clientCount);
+    external[0].AccountBalance = 4242;
+    {
+        ofstream out(ClientsFileName, ios::trunc);
+        for (const strClient& client : external) {
+            out << serializeClientRecord(client) << "\n";
+        }
+    }
+    refreshClientsFromFile(ClientsFileName, vClients);
+    if (vClients.empty() || vClients[0].AccountBalance != 4242) {
+        cout << "  ERROR: external change to the clients file was not reloaded\n";
+    }
+
+    // So must one made while a load reads the files: with the watch running, and on a first load before it starts
+    for (bool watching : { true, false }) {
+        ClientStore = strClientStore();
+        if (watching) {
+            beginClientStoreSync(ClientsFileName);
+        }
+        strFileStamp clientsStamp = readFileStamp(ClientsFileName);
+        strFileStamp journalStamp = readFileStamp(getJournalFileName(ClientsFileName));
+        external[0].AccountBalance += 100000;
+        {
+            ofstream out(ClientsFileName, ios::trunc);
+            for (const strClient& client : external) {
+                out << serializeClientRecord(client) << "\n";
+            }
+        }
+        markClientStoreSynced(ClientsFileName, vClients, clientsStamp, journalStamp);
+        refreshClientsFromFile(ClientsFileName, vClients);
+        if (vClients.empty() || vClients[0].AccountBalance != external[0].AccountBalance) {
+            cout << "  ERROR: change made during a load was not reloaded (" << (watching ? "watch" : "first load") << ")\n";
+        }
+    }
+    stopClientStoreWatch();
+
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    ClientStore = strClientStore();
+}
+
+//=====================================================
+//================= Load Allocations ==================
+//=====================================================
+
+// Synthetic client whose name is longer than the short-string buffer, as most real names are
+strClient makeLongNameClient(int i) {
+    strClient client = makeSyntheticClient(i);
+    client.Name = "Account Holder " + formatInt(i);
+    return client;
+}
+// Print time and heap allocations of one load
+void printLoadAllocations(const string& name, double seconds, long long allocations, size_t records) {
+    cout << "  " << left << setw(30) << name << right << fixed
+        << setw(9) << setprecision(3) << seconds << " s"
+        << setw(12) << allocations << " allocations"
+        << setw(9) << setprecision(2) << (records > 0 ? static_cast<double>(allocations) / records : 0) << " per record\n";
+}
+// Heap allocations and time of a first load, a journal replay and a reload
+void benchmarkLoadAllocations() {
+    const int clientCount = 1000000;
+    const int journalRecords = JournalCheckpointInterval - 1;
+
+    cout << "\nLoad allocations (" << clientCount << " clients, " << journalRecords << " journal records)\n";
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    remove(getAccountDictionaryFileName(ClientsFileName).c_str());
+    AccountIds = strAccountDictionary();
+    invalidateClientStore();
+    {
+        ofstream out(ClientsFileName, ios::binary | ios::trunc);
+        string block;
+        for (int i = 0; i < clientCount; i++) {
+            block += serializeClientRecord(makeLongNameClient(i));
+            block += '\n';
+            flushGeneratedLines(out, block, false);
+        }
+        flushGeneratedLines(out, block, true);
+    }
+
+    long long allocations = HeapAllocations.load();
+    BenchClock::time_point start = BenchClock::now();
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    printLoadAllocations("first load", secondsSince(start), HeapAllocations.load() - allocations, vClients.size());
+
+    for (int i = 0; i < journalRecords; i++) {
+        appendBalanceJournal(ClientsFileName, "TXN" + formatInt(i), { { vClients[i * 7 % clientCount].AccountNumber, 100 } });
+    }
+    allocations = HeapAllocations.load();
+    start = BenchClock::now();
+    replayBalanceJournal(ClientsFileName, vClients);
+    printLoadAllocations("journal replay", secondsSince(start), HeapAllocations.load() - allocations, journalRecords);
+
+    allocations = HeapAllocations.load();
+    start = BenchClock::now();
+    vClients = loadClientsDataFromFile(ClientsFileName);
+    printLoadAllocations("reload into a new vector", secondsSince(start), HeapAllocations.load() - allocations,
+        vClients.size());
+    Money newTotal = sumClientBalances(vClients);
+
+    allocations = HeapAllocations.load();
+    start = BenchClock::now();
+    loadClientsDataFromFile(ClientsFileName, vClients);
+    printLoadAllocations("reload in place", secondsSince(start), HeapAllocations.load() - allocations, vClients.size());
+
+    if (sumClientBalances(vClients) != newTotal || vClients.size() != static_cast<size_t>(clientCount) ||
+        vClients[42].Name != makeLongNameClient(42).Name) {
+        cout << "  ERROR: reloads differ\n";
+    }
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+
+    // A reload over a short line and a bad balance must not keep what the reused records held
+    {
+        ofstream out(ClientsFileName, ios::binary | ios::trunc);
+        for (int i = 0; i < 3; i++) out << serializeClientRecord(makeSyntheticClient(i)) << '\n';
+    }
+    loadClientsDataFromFile(ClientsFileName, vClients);
+    strClient badBalance = makeSyntheticClient(3);
+    {
+        ofstream out(ClientsFileName, ios::binary | ios::trunc);
+        out << serializeClientRecord(makeSyntheticClient(0)) << '\n';
+        out << "AC99999999" << Separator << "1234\n";
+        out << badBalance.AccountNumber << Separator << badBalance.PinCode << Separator << badBalance.Name <<
+            Separator << badBalance.Phone << Separator << "12x4\n";
+    }
+    loadClientsDataFromFile(ClientsFileName, vClients);
+    bool leftOver = vClients.size() != 2 || vClients[1].AccountNumber != badBalance.AccountNumber ||
+        vClients[1].AccountBalance != 0;
+    for (const strClient& client : vClients) {
+        leftOver = leftOver || client.AccountNumber == makeSyntheticClient(1).AccountNumber;
+    }
+    cout << "  reload over malformed lines: " << (leftOver ? "ERROR: records of the previous load survived" : "OK") << "\n";
+    ClientStore = strClientStore();
+}
+
+//=====================================================
+//================== Client Columns ===================
+//=====================================================
+
+// Balance summary straight off vector<strClient>, the way the report used to walk it
+strBalanceSummary summarizeClientRecords(const vector<strClient>& vClients) {
+    strBalanceSummary summary;
+    summary.Count = vClients.size();
+    summary.Minimum = vClients.empty() ? 0 : vClients[0].AccountBalance;
+    summary.Maximum = summary.Minimum;
+    for (const strClient& client : vClients) {
+        Money balance = client.AccountBalance;
+        summary.Total += balance;
+        summary.Minimum = min(summary.Minimum, balance);
+        summary.Maximum = max(summary.Maximum, balance);
+        summary.Negative += balance < 0;
+        size_t bucket = 0;
+        while (bucket < BalanceBucketCount - 1 && balance >= BalanceBucketBounds[bucket]) bucket++;
+        summary.Buckets[bucket]++;
+    }
+    return summary;
+}
+// Aggregate 1M and 10M balances: record walk vs balance column kernels
+void benchmarkClientColumns() {
+    const int scales[] = { 1000000, 10000000 };
+    const int repeats = 5;
+
+    printBenchHeader("Balance aggregates: vector<strClient> walk vs balance column kernels");
+
+    for (int scale : scales) {
+        vector<strClient> vClients;
+        vClients.reserve(scale);
+        for (int i = 0; i < scale; i++) {
+            strClient client = makeSyntheticClient(i);
+            client.Name = "Client " + formatInt(i % 100000);     // Repeated names, as in real data
+            client.AccountBalance = static_cast<Money>(i) * 7919 % 20000000 - 100000;
+            vClients.push_back(move(client));
+        }
+
+        strBalanceSummary records;
+        BenchClock::time_point start = BenchClock::now();
+        for (int r = 0; r < repeats; r++) {
+            records = summarizeClientRecords(vClients);
+        }
+        printBenchRow("record walk (summary)", scale, repeats, secondsSince(start));
+
+        strClientColumns columns;
+        start = BenchClock::now();
+        buildClientColumns(vClients, columns);
+        printBenchRow("build columns", scale, 1, secondsSince(start));
+
+        strBalanceSummary summary;
+        start = BenchClock::now();
+        for (int r = 0; r < repeats; r++) {
+            summary = summarizeBalanceColumn(columns.Balances);
+        }
+        printBenchRow("column kernels (summary)", scale, repeats, secondsSince(start));
+
+        // Total only: the existing record sum vs the column kernel (one balance bumped per repeat
+        // so neither loop can be hoisted)
+        Money recordTotal = 0;
+        start = BenchClock::now();
+        for (int r = 0; r < repeats; r++) {
+            vClients[r].AccountBalance++;
+            recordTotal += sumClientBalances(vClients);
+        }
+        printBenchRow("record walk (total only)", scale, repeats, secondsSince(start));
+
+        Money total = 0;
+        start = BenchClock::now();
+        for (int r = 0; r < repeats; r++) {
+            columns.Balances[r]++;
+            total += sumBalanceColumn(columns.Balances.data(), columns.Balances.size());
+        }
+        printBenchRow("column kernel (total only)", scale, repeats, secondsSince(start));
+
+        cout << "  " << getArenaCount(columns.Names) << " distinct names, "
+            << (columns.Balances.size() * sizeof(Money) + columns.AccountIds.size() * sizeof(uint32_t) +
+                columns.NameIds.size() * sizeof(uint32_t) + columns.Names.Chars.size() +
+                (columns.Names.Offsets.size() + columns.Names.Slots.size()) * sizeof(uint32_t)) / (1024 * 1024)
+            << " MB of columns vs " << vClients.size() * sizeof(strClient) / (1024 * 1024) << " MB of records\n";
+
+        bool matches = records.Total == summary.Total && records.Minimum == summary.Minimum &&
+            records.Maximum == summary.Maximum && records.Negative == summary.Negative &&
+            total == recordTotal && equal(begin(records.Buckets), end(records.Buckets), begin(summary.Buckets));
+        for (size_t i = 0; matches && i < vClients.size(); i += 9973) {
+            matches = getColumnAccount(columns, i) == vClients[i].AccountNumber && getColumnName(columns, i) == vClients[i].Name;
+        }
+        if (!matches) {
+            cout << "  ERROR: column summary does not match the records\n";
+        }
+    }
+}
+
+//=====================================================
+//==================== Durability =====================
+//=====================================================
+
+// Print throughput and commit latency percentiles (latencies in microseconds, sorted in place)
+void printCommitLatency(const string& name, vector<double>& latencies, double seconds, long long syncs) {
+    sort(latencies.begin(), latencies.end());
+    cout << "  " << left << setw(34) << name << right << fixed << setprecision(0)
+        << setw(10) << latencies.size() / seconds << " ops/s"
+        << setw(10) << setprecision(1) << latencies[latencies.size() / 2] << " us p50"
+        << setw(10) << latencies[latencies.size() * 99 / 100] << " us p99"
+        << setw(8) << syncs << " syncs\n";
+}
+// Postings under each durability mode: one menu-style thread, then concurrent committers
+void benchmarkDurability() {
+    const int clientCount = 1000;
+    const int postings = 300;
+    const int postingsPerGroup = 10;
+    const int threadCount = 8;
+    const int commitsPerThread = 100;
+    struct strModeCase { string Name; DurabilityMode Mode; long long WindowMicros; };
+    const strModeCase modes[] = {
+        { "none", DURABILITY_NONE, 0 },
+        { "fsync", DURABILITY_FSYNC, 0 },
+        { "group (200 us)", DURABILITY_GROUP, 200 },
+        { "group (1000 us)", DURABILITY_GROUP, 1000 },
+    };
+
+    cout << "\nDurability: " << postings << " postings from one thread (ledger + journal)\n";
+    for (const strModeCase& modeCase : modes) {
+        resetLedgerFiles();
+        remove(getJournalFileName(ClientsFileName).c_str());
+        remove(getCheckpointFileName(ClientsFileName).c_str());
+        vector<strClient> vClients = makeSyntheticClients(clientCount);
+        saveClientsToFile(ClientsFileName, vClients);
+        setDurabilityMode(modeCase.Mode, modeCase.WindowMicros);
+        long long syncsBefore = Durability.Syncs;
+
+        // Postings one by one, then back to back in groups of postingsPerGroup (as the server loop does)
+        for (int perGroup : { 1, postingsPerGroup }) {
+            vector<double> latencies;
+            BenchClock::time_point start = BenchClock::now();
+            for (int i = 0; i < postings; i += perGroup) {
+                BenchClock::time_point posted = BenchClock::now();
+                beginDurableGroup();
+                for (int j = i; j < i + perGroup; j++) {
+                    strClient& client = vClients[j % clientCount];
+                    client.AccountBalance += 100;
+                    Transaction transaction = createDepositTransaction(client.AccountNumber, 100);
+                    saveTransactionToFile(transaction);
+                    commitBalanceChange(vClients, transaction.TransactionID, { { client.AccountNumber, 100 } });
+                }
+                endDurableGroup();
+                latencies.insert(latencies.end(), perGroup, secondsSince(posted) * 1e6);
+            }
+            printCommitLatency(modeCase.Name + (perGroup > 1 ? ", " + formatInt(perGroup) + " per group" : ""),
+                latencies, secondsSince(start), Durability.Syncs - syncsBefore);
+            syncsBefore = Durability.Syncs;
+        }
+    }
+
+    cout << "\nDurability: " << threadCount << " threads x " << commitsPerThread << " commits (shared log file)\n";
+    const string logFile = "durability_benchmark.log";
+    for (const strModeCase& modeCase : modes) {
+        remove(logFile.c_str());
+        setDurabilityMode(modeCase.Mode, modeCase.WindowMicros);
+        long long syncsBefore = Durability.Syncs;
+
+        mutex fileLock;
+        ofstream out(logFile, ios::binary | ios::app);
+        vector<vector<double>> threadLatencies(threadCount);
+        vector<thread> threads;
+        BenchClock::time_point start = BenchClock::now();
+        for (int t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < commitsPerThread; i++) {
+                    BenchClock::time_point posted = BenchClock::now();
+                    {
+                        lock_guard<mutex> guard(fileLock);
+                        out << serializeTransactionRecord(makeSyntheticTransaction(t * commitsPerThread + i, clientCount)) << "\n";
+                        out.flush();
+                    }
+                    noteDurableWrite(logFile);
+                    commitDurableWrites();
+                    threadLatencies[t].push_back(secondsSince(posted) * 1e6);
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+        double seconds = secondsSince(start);
+
+        vector<double> latencies;
+        for (const vector<double>& perThread : threadLatencies) {
+            latencies.insert(latencies.end(), perThread.begin(), perThread.end());
+        }
+        printCommitLatency(modeCase.Name, latencies, seconds, Durability.Syncs - syncsBefore);
+    }
+
+    // A group open on this thread must not stop another thread's commit from syncing
+    setDurabilityMode(DURABILITY_GROUP, 20000);
+    beginDurableGroup();
+    long long syncsBefore = Durability.Syncs;
+    thread([&]() {
+        noteDurableWrite(logFile);
+        commitDurableWrites();
+    }).join();
+    bool syncedBeside = Durability.Syncs > syncsBefore;
+    endDurableGroup();
+    cout << "  commit beside another thread's group: " << (syncedBeside ? "synced: OK" : "skipped: ERROR") << "\n";
+
+    // A failed sync round fails every commit it covered, followers included
+    atomic<int> reportedSynced{ 0 };
+    vector<thread> committers;
+    for (int t = 0; t < threadCount; t++) {
+        committers.emplace_back([&]() {
+            noteDurableWrite("missing_folder/durability_benchmark.log");
+            if (commitDurableWrites()) reportedSynced++;
+        });
+    }
+    for (thread& committer : committers) {
+        committer.join();
+    }
+    cout << "  failed sync round: " << reportedSynced.load() << " of " << threadCount << " commits reported synced"
+        << (reportedSynced.load() == 0 ? ": OK" : ": ERROR") << "\n";
+
+    remove(logFile.c_str());
+    resetLedgerFiles();
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    setDurabilityMode(DURABILITY_NONE);
+}
+
+//=====================================================
+//================= Batch Transactions ================
+//=====================================================
+
+// Write a synthetic batch file: deposits, withdrawals and transfers, plus a few invalid lines
+void writeSyntheticBatchFile(const string& fileName, int count, int clientCount) {
+    ofstream out(fileName, ios::trunc);
+    for (int i = 0; i < count; i++) {
+        string account = makeSyntheticClient(i % clientCount).AccountNumber;
+        string amount = formatInt(10 + i % 90) + ".50";
+        if (i % 1000 == 999) {
+            out << "TRANSFER" << Separator << account << Separator << "NOSUCHACCOUNT" << Separator << amount << "\n";
+        }
+        else if (i % 3 == 0) {
+            out << "DEPOSIT" << Separator << account << Separator << amount << Separator << "Payroll" << "\n";
+        }
+        else if (i % 3 == 1) {
+            out << "WITHDRAW" << Separator << account << Separator << amount << "\n";
+        }
+        else {
+            out << "TRANSFER" << Separator << account << Separator
+                << makeSyntheticClient((i * 31 + 7) % clientCount).AccountNumber << Separator << amount << "\n";
+        }
+    }
+}
+// Compare one screen-style commit per operation with the batch engine's single commit
+void benchmarkBatchTransactions() {
+    const int clientCount = 100000;
+    const int perOperationCount = 5000;
+    const int batchCount = 100000;
+    const string batchFile = "batch_benchmark.txt";
+
+    printBenchHeader("Batch transactions: per-operation commit vs one batch commit");
+
+    resetLedgerFiles();
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    vector<strClient> vClients = makeSyntheticClients(clientCount);
+    saveClientsToFile(ClientsFileName, vClients);
+    writeSyntheticBatchFile(batchFile, batchCount, clientCount);
+
+    // Screen path: ledger append + journal commit for every operation
+    string content;
+    readFileToString(batchFile, content);
+    int ops = 0;
+    size_t lineNumber = 0;
+    BenchClock::time_point start = BenchClock::now();
+    forEachLine(content, [&](string_view line) {
+        if (ops >= perOperationCount) return;
+        strBatchOperation operation;
+        Transaction transaction;
+        string error;
+        ops++;
+        if (!parseBatchOperation(line, ++lineNumber, operation, error) ||
+            !applyBatchOperation(operation, vClients, transaction).empty()) {
+            return;
+        }
+        saveTransactionToFile(transaction);
+        commitBalanceChange(vClients, transaction.TransactionID, buildBatchJournalLegs({ transaction }));
+    });
+    printBenchRow("commit per operation", clientCount, ops, secondsSince(start));
+
+    // Batch path: validate all in memory, one ledger append, one clients file write
+    resetLedgerFiles();
+    vClients = makeSyntheticClients(clientCount);
+    saveClientsToFile(ClientsFileName, vClients);
+    strBatchReport report = runBatchFile(batchFile, vClients);
+    printBenchRow("batch (one commit)", clientCount, static_cast<int>(report.Operations),
+        report.ApplySeconds + report.CommitSeconds);
+    cout << "  apply " << fixed << setprecision(3) << report.ApplySeconds << " s, commit "
+        << report.CommitSeconds << " s, " << report.Applied << " applied, "
+        << report.Failures.size() << " failed\n";
+
+    vector<strClient> reloaded = loadClientsDataFromFile(ClientsFileName);
+    bool matches = reloaded.size() == vClients.size();
+    for (size_t i = 0; matches && i < reloaded.size(); i++) {
+        matches = reloaded[i].AccountBalance == vClients[i].AccountBalance;
+    }
+    if (!matches || loadLedgerTransactions(TransactionsFileName).size() != report.Applied) {
+        cout << "  ERROR: committed batch does not match in-memory state\n";
+    }
+
+    remove(batchFile.c_str());
+    resetLedgerFiles();
+}
+
+//=====================================================
+//================= Concurrent Ledger =================
+//=====================================================
+
+// Post a mix of deposits, withdrawals and transfers from several threads; returns seconds
+double runConcurrentPostings(strConcurrentLedger& ledger, const vector<string>& accounts,
+    int threadCount, int opsPerThread, Money& netDeposits) {
+    vector<Money> threadNet(threadCount, 0);
+    vector<thread> workers;
+    BenchClock::time_point start = BenchClock::now();
+
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t state = 0x9E3779B97F4A7C15ULL * (t + 1);
+            Money net = 0;
+            for (int i = 0; i < opsPerThread; i++) {
+                state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+                const string& from = accounts[state % accounts.size()];
+                const string& to = accounts[(state >> 24) % accounts.size()];
+                Money amount = 100 + static_cast<Money>(state % 5000);
+
+                switch (i % 3) {
+                case 0:
+                    if (concurrentDeposit(ledger, from, amount).empty()) net += amount;
+                    break;
+                case 1:
+                    if (concurrentWithdraw(ledger, from, amount).empty()) net -= amount;
+                    break;
+                default:
+                    if (concurrentTransfer(ledger, from, to, amount).empty()) net -= calculateTransferFee(amount);
+                    break;
+                }
+            }
+            threadNet[t] = net;
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+
+    double seconds = secondsSince(start);
+    for (Money net : threadNet) {
+        netDeposits += net;
+    }
+    return seconds;
+}
+// Throughput of striped locks vs a single global lock from 1 to N threads
+void benchmarkConcurrentLedger() {
+    const int clientCount = 100000;
+    const int opsPerThread = 200000;
+    int maxThreads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    vector<strClient> vClients = makeSyntheticClients(clientCount);
+    vector<string> accounts;
+    Money initialTotal = 0;
+    for (const strClient& client : vClients) {
+        accounts.push_back(client.AccountNumber);
+        initialTotal += client.AccountBalance;
+    }
+
+    cout << "\nConcurrent ledger (" << clientCount << " accounts, " << opsPerThread << " ops/thread)\n";
+    cout << "  " << left << setw(10) << "threads" << right << setw(22) << "global lock ops/s"
+        << setw(22) << "striped ops/s" << setw(10) << "speedup" << "\n";
+
+    for (int threads : threadCounts) {
+        double throughput[2];
+        for (int mode = 0; mode < 2; mode++) {
+            strConcurrentLedger ledger;
+            openConcurrentLedger(ledger, vClients, mode == 0 ? 1 : ConcurrentLedgerStripes);
+
+            Money netDeposits = 0;
+            double seconds = runConcurrentPostings(ledger, accounts, threads, opsPerThread, netDeposits);
+            throughput[mode] = static_cast<double>(threads) * opsPerThread / seconds;
+
+            if (sumClientBalances(snapshotConcurrentLedger(ledger)) != initialTotal + netDeposits) {
+                cout << "  ERROR: balances do not add up after " << threads << " threads\n";
+            }
+        }
+        cout << "  " << left << setw(10) << threads << right << fixed << setprecision(0)
+            << setw(22) << throughput[0] << setw(22) << throughput[1]
+            << setw(9) << setprecision(2) << throughput[1] / throughput[0] << "x\n";
+    }
+}
+
+//=====================================================
+//=================== Teller Server ===================
+//=====================================================
+
+#ifndef _WIN32
+// Load generator: many teller connections against an in-process server, rps and latency percentiles
+void benchmarkTellerServer() {
+    const int clientCount = 10000;
+    const int connections = 200;
+    const int requestsPerConnection = 200;
+    const string socketPath = "bench_server.sock";
+
+    cout << "\nTeller server (" << connections << " connections x " << requestsPerConnection
+        << " requests, 70% BALANCE / 30% postings)\n";
+
+    resetLedgerFiles();
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove(getCheckpointFileName(ClientsFileName).c_str());
+    saveClientsToFile(ClientsFileName, makeSyntheticClients(clientCount));
+
+    strUser teller;
+    teller.UserName = "teller";
+    teller.Password = hashPassword("Teller#2026");
+    teller.Permissions = Permission::pAll;
+    saveUsersToFile(UsersFileName, { teller });
+
+    ServerControl.StopRequested = false;
+    ServerControl.Requests = 0;
+    thread server([&]() { runBankServer(socketPath); });
+    while (!ServerControl.Ready) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    vector<vector<double>> latencies(connections);
+    atomic<int> failures{ 0 };
+    vector<thread> tellers;
+    BenchClock::time_point start = BenchClock::now();
+
+    for (int c = 0; c < connections; c++) {
+        tellers.emplace_back([&, c]() {
+            int socketFd = connectToBankServer(socketPath);
+            string buffer;
+            vector<string> response;
+            if (socketFd < 0 || !sendServerRequest(socketFd, buffer, "LOGIN" + Separator + "teller" + Separator + "Teller#2026", response)) {
+                failures++;
+                return;
+            }
+
+            latencies[c].reserve(requestsPerConnection);
+            for (int i = 0; i < requestsPerConnection; i++) {
+                int n = c * requestsPerConnection + i;
+                string account = makeSyntheticClient(n % clientCount).AccountNumber;
+                string request;
+                switch (n % 10) {
+                case 0:  request = "DEPOSIT" + Separator + account + Separator + "25.00"; break;
+                case 1:  request = "WITHDRAW" + Separator + account + Separator + "10.00"; break;
+                case 2:  request = "TRANSFER" + Separator + account + Separator +
+                    makeSyntheticClient((n * 31 + 7) % clientCount).AccountNumber + Separator + "5.00"; break;
+                default: request = "BALANCE" + Separator + account; break;
+                }
+
+                BenchClock::time_point sent = BenchClock::now();
+                if (!sendServerRequest(socketFd, buffer, request, response) || response[0].compare(0, 2, "OK") != 0) {
+                    failures++;
+                }
+                latencies[c].push_back(secondsSince(sent) * 1e6);
+            }
+            sendServerRequest(socketFd, buffer, "QUIT", response);
+            close(socketFd);
+        });
+    }
+    for (thread& teller : tellers) {
+        teller.join();
+    }
+    double seconds = secondsSince(start);
+
+    // Requests sent behind a login wait for its verification and are answered in order; a changed
+    // Users file is read again
+    strUser added = teller;
+    added.UserName = "teller2";
+    saveUsersToFile(UsersFileName, { teller, added });
+    string account = makeSyntheticClient(0).AccountNumber;
+    string pipelined = "LOGIN" + Separator + "teller" + Separator + "wrong\n" + "BALANCE" + Separator + account + "\n" +
+        "LOGIN" + Separator + "teller2" + Separator + "Teller#2026\n" + "BALANCE" + Separator + account + "\n";
+    vector<string> expected = { "ERR" + Separator + "Invalid", "ERR" + Separator + "Please login",
+        "OK" + Separator + "Welcome", "OK" + Separator + account };
+    int socketFd = connectToBankServer(socketPath);
+    bool ordered = socketFd >= 0 && send(socketFd, pipelined.data(), pipelined.size(), 0) ==
+        static_cast<ssize_t>(pipelined.size());
+    string buffer, line;
+    for (const string& prefix : expected) {
+        ordered = ordered && readServerLine(socketFd, buffer, line) && line.compare(0, prefix.size(), prefix) == 0;
+    }
+    if (socketFd >= 0) close(socketFd);
+    cout << "  requests behind a login   : " << (ordered ? "answered in order: OK" : "ERROR") << "\n";
+
+    ServerControl.StopRequested = true;
+    server.join();
+
+    vector<double> all;
+    for (const vector<double>& connectionLatencies : latencies) {
+        all.insert(all.end(), connectionLatencies.begin(), connectionLatencies.end());
+    }
+    sort(all.begin(), all.end());
+    if (all.empty()) {
+        cout << "  ERROR: no requests completed\n";
+        return;
+    }
+
+    cout << "  throughput : " << fixed << setprecision(0) << all.size() / seconds << " requests/s ("
+        << failures.load() << " failed)\n";
+    cout << "  latency    : p50 " << setprecision(1) << all[all.size() / 2] << " us, p99 "
+        << all[all.size() * 99 / 100] << " us, max " << all.back() << " us\n";
+
+    resetLedgerFiles();
+    remove(UsersFileName.c_str());
+}
+#endif
+
+//=====================================================
+//================== Screen Renderer ==================
+//=====================================================
+
+#ifndef _WIN32
+// Clients list of 100k rows and screen clears, written to /dev/null: cout + setw vs the screen buffer
+void benchmarkScreenRenderer() {
+    const int clientCount = 100000;
+    const int clears = 200;
+    vector<strClient> vClients = makeSyntheticClients(clientCount);
+
+    printBenchHeader("Screen rendering: cout + setw per cell vs one buffer per page");
+
+    // Both paths see stdout as /dev/null; results are printed after it is restored
+    cout.flush();
+    fflush(stdout);
+    int savedStdout = dup(STDOUT_FILENO);
+    int nullFd = open("/dev/null", O_WRONLY);
+    dup2(nullFd, STDOUT_FILENO);
+    close(nullFd);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (const strClient& Client : vClients) {
+        string balanceColor = (Client.AccountBalance >= 0) ? GREEN : RED;
+        cout << CYAN << "| " << RESET << left << setw(18) << Client.AccountNumber
+            << CYAN << "| " << RESET << setw(12) << Client.PinCode
+            << CYAN << "| " << RESET << setw(30) << Client.Name
+            << CYAN << "| " << RESET << setw(15) << Client.Phone
+            << CYAN << "| " << RESET << balanceColor << setw(21)
+            << fixed << setprecision(2) << formatCurrency(Client.AccountBalance)
+            << CYAN << "|\n" << RESET;
+    }
+    cout.flush();
+    double coutSeconds = secondsSince(start);
+
+    ScreenBuffer.Interactive = 0;
+    ScreenBuffer.Writes = 0;
+    vector<strTableColumn> columns = {
+        { "Account Number", 18 }, { "PIN Code", 12 }, { "Client Name", 30 }, { "Phone", 15 }, { "Balance", 21 } };
+    start = BenchClock::now();
+    showPagedTable(columns, vClients.size(), [&](string& row, size_t i) {
+        const strClient& client = vClients[i];
+        appendTextCell(row, client.AccountNumber, 18);
+        appendTextCell(row, client.PinCode, 12);
+        appendTextCell(row, client.Name, 30);
+        appendTextCell(row, client.Phone, 15);
+        appendMoneyCell(row, client.AccountBalance, 21, client.AccountBalance >= 0 ? GREEN : RED);
+        appendRowEnd(row);
+    });
+    writeScreenBuffer();
+    double bufferSeconds = secondsSince(start);
+    size_t writes = ScreenBuffer.Writes;
+
+    start = BenchClock::now();
+    for (int i = 0; i < clears; i++) {
+        if (system("clear") != 0) break;
+    }
+    double systemClearSeconds = secondsSince(start);
+
+    start = BenchClock::now();
+    for (int i = 0; i < clears; i++) {
+        clearScreen();
+    }
+    double ansiClearSeconds = secondsSince(start);
+
+    cout.flush();
+    fflush(stdout);
+    dup2(savedStdout, STDOUT_FILENO);
+    close(savedStdout);
+
+    printBenchRow("cout + setw (rows)", clientCount, clientCount, coutSeconds);
+    printBenchRow("screen buffer (rows)", clientCount, clientCount, bufferSeconds);
+    cout << "  " << writes << " writes for " << clientCount << " rows (" << ScreenPageRows << " rows per page)\n";
+    printBenchRow("system(\"clear\")", 0, clears, systemClearSeconds);
+    printBenchRow("ANSI clear", 0, clears, ansiClearSeconds);
+
+    ScreenBuffer = strScreenBuffer();
+}
+#endif
+
+//=====================================================
+//================== Benchmark Suite ==================
+// "generate" writes a synthetic Clients.txt, Users.txt
+// and Transactions.txt at the scale given on the command
+// line; "suite" generates the same data, then times the
+// hot paths on it. Suite results can be written as JSON
+// (--json <file>) to compare versions.
+//=====================================================
+
+struct strSuiteOptions {
+    int    Clients = 100000;
+    int    Transactions = 1000000;
+    int    Users = 100;
+    int    Operations = 10000;              // Postings / lookups per flow case
+    string JsonFile;                        // "" = print only
+};
+struct strSuiteResult {
+    string    Case;
+    long long Operations = 0;
+    double    Seconds = 0;
+    long long Bytes = 0;                    // Bytes processed, 0 = not a throughput case
+    double    P50Micros = -1;               // Per-operation latency, -1 = not measured
+    double    P99Micros = -1;
+};
+
+const string BenchmarkVersion = "v1.4.1";
+strSuiteOptions SuiteOptions;
+vector<strSuiteResult> SuiteResults;
+
+// Write synthetic Clients.txt, Users.txt and a single-file Transactions.txt (migrated to segments on open)
+void generateDataset(int clientCount, int transactionCount, int userCount) {
+    resetLedgerFiles();
+    remove(getJournalFileName(ClientsFileName).c_str());
+    remove((ClientsFileName + ".ckpt").c_str());
+    invalidateClientStore();
+
+    BenchClock::time_point start = BenchClock::now();
+    string block;
+    {
+        ofstream out(ClientsFileName, ios::binary | ios::trunc);
+        for (int i = 0; i < clientCount; i++) {
+            block += serializeClientRecord(makeSyntheticClient(i));
+            block += '\n';
+            flushGeneratedLines(out, block, false);
+        }
+        flushGeneratedLines(out, block, true);
+    }
+    {
+        // One hash for every user: hashing is deliberately slow and not what is generated here
+        string password = hashPassword("Bench1234");
+        ofstream out(UsersFileName, ios::binary | ios::trunc);
+        for (int i = 0; i < userCount; i++) {
+            strUser user;
+            user.UserName = "user" + formatInt(i);
+            user.Password = password;
+            user.Permissions = (i == 0) ? Permission::pAll : (i % 2 ? Permission::pTransactions : Permission::pListClients);
+            block += serializeUserRecord(user);
+            block += '\n';
+        }
+        flushGeneratedLines(out, block, true);
+    }
+    {
+        ofstream out(TransactionsFileName, ios::binary | ios::trunc);
+        for (int i = 0; i < transactionCount; i++) {
+            block += serializeTransactionRecord(makeSyntheticTransaction(i, max(1, clientCount)));
+            block += '\n';
+            flushGeneratedLines(out, block, false);
+        }
+        flushGeneratedLines(out, block, true);
+    }
+
+    cout << "  generated " << clientCount << " clients (" << fileSizeOf(ClientsFileName) / (1024 * 1024) << " MB), "
+        << userCount << " users, " << transactionCount << " transactions ("
+        << fileSizeOf(TransactionsFileName) / (1024 * 1024) << " MB) in "
+        << fixed << setprecision(1) << secondsSince(start) << " s\n";
+}
+// Value at a fraction of sorted latencies
+double latencyPercentile(const vector<double>& sortedLatencies, double fraction) {
+    if (sortedLatencies.empty()) return -1;
+    size_t rank = static_cast<size_t>(ceil(fraction * sortedLatencies.size()));
+    return sortedLatencies[max<size_t>(rank, 1) - 1];
+}
+// Keep and print one suite result
+void addSuiteResult(const string& name, long long operations, double seconds, long long bytes = 0,
+    vector<double> latencies = {}) {
+    strSuiteResult result;
+    result.Case = name;
+    result.Operations = operations;
+    result.Seconds = seconds;
+    result.Bytes = bytes;
+    sort(latencies.begin(), latencies.end());
+    result.P50Micros = latencyPercentile(latencies, 0.50);
+    result.P99Micros = latencyPercentile(latencies, 0.99);
+    SuiteResults.push_back(result);
+
+    cout << "  " << left << setw(22) << name << right << fixed
+        << setw(11) << operations << " ops"
+        << setw(10) << setprecision(3) << seconds << " s"
+        << setw(13) << setprecision(0) << (seconds > 0 ? operations / seconds : 0) << " ops/s";
+    if (bytes > 0) cout << setw(9) << setprecision(1) << bytes / seconds / (1024 * 1024) << " MB/s";
+    if (result.P50Micros >= 0) {
+        cout << setw(10) << setprecision(1) << result.P50Micros << " us p50"
+            << setw(10) << result.P99Micros << " us p99";
+    }
+    cout << "\n";
+}
+// Escape a string for a JSON value
+string escapeJson(const string& text) {
+    string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+// Write the suite results and their scale as JSON
+bool writeSuiteJson(const string& fileName) {
+    ofstream out(fileName, ios::trunc);
+    if (!out.is_open()) {
+        cerr << "Cannot write " << fileName << "\n";
+        return false;
+    }
+
+    out << fixed << setprecision(6);
+    out << "{\n"
+        << "  \"version\": \"" << BenchmarkVersion << "\",\n"
+        << "  \"timestamp\": \"" << getCurrentTimestamp() << "\",\n"
+        << "  \"hardware_threads\": " << max(1u, thread::hardware_concurrency()) << ",\n"
+        << "  \"clients\": " << SuiteOptions.Clients << ",\n"
+        << "  \"transactions\": " << SuiteOptions.Transactions << ",\n"
+        << "  \"users\": " << SuiteOptions.Users << ",\n"
+        << "  \"operations\": " << SuiteOptions.Operations << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < SuiteResults.size(); i++) {
+        const strSuiteResult& result = SuiteResults[i];
+        out << "    { \"case\": \"" << escapeJson(result.Case) << "\""
+            << ", \"operations\": " << result.Operations
+            << ", \"seconds\": " << result.Seconds
+            << ", \"ops_per_sec\": " << (result.Seconds > 0 ? result.Operations / result.Seconds : 0);
+        if (result.Bytes > 0) out << ", \"mb_per_sec\": " << result.Bytes / result.Seconds / (1024 * 1024);
+        if (result.P50Micros >= 0) out << ", \"p50_us\": " << result.P50Micros << ", \"p99_us\": " << result.P99Micros;
+        out << " }" << (i + 1 < SuiteResults.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+// Write the dataset only (kept in BenchmarkData for manual runs)
+void benchmarkGenerateDataset() {
+    cout << "\nDataset\n";
+    generateDataset(SuiteOptions.Clients, SuiteOptions.Transactions, SuiteOptions.Users);
+}
+// Record codecs: serialize and parse the generated records
+void runSuiteCodecs(const vector<strClient>& vClients) {
+    const int records = max(1, min(SuiteOptions.Clients, 1000000));
+    vector<string> lines(records);
+    long long bytes = 0;
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < records; i++) {
+        lines[i] = serializeClientRecord(vClients[i % vClients.size()]);
+        bytes += lines[i].size() + 1;
+    }
+    addSuiteResult("serialize_client", records, secondsSince(start), bytes);
+
+    strClient client;
+    string error;
+    start = BenchClock::now();
+    for (const string& line : lines) parseClientRecord(line, client, error);
+    addSuiteResult("parse_client", records, secondsSince(start), bytes);
+
+    vector<Transaction> transactions(records);
+    for (int i = 0; i < records; i++) transactions[i] = makeSyntheticTransaction(i, SuiteOptions.Clients);
+    bytes = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < records; i++) {
+        lines[i] = serializeTransactionRecord(transactions[i]);
+        bytes += lines[i].size() + 1;
+    }
+    addSuiteResult("serialize_transaction", records, secondsSince(start), bytes);
+
+    Transaction txn;
+    start = BenchClock::now();
+    for (const string& line : lines) parseTransactionRecord(line, txn, error);
+    addSuiteResult("parse_transaction", records, secondsSince(start), bytes);
+}
+// Generate the dataset, then time loads, saves, lookups, postings and history on it
+void benchmarkSuite() {
+    const int operations = SuiteOptions.Operations;
+    cout << "\nSuite (" << SuiteOptions.Clients << " clients, " << SuiteOptions.Transactions << " transactions, "
+        << operations << " operations per flow)\n";
+    SuiteResults.clear();
+    if (SuiteOptions.Clients < 2) {
+        cout << "  the suite needs at least 2 clients\n";
+        return;
+    }
+    generateDataset(SuiteOptions.Clients, SuiteOptions.Transactions, SuiteOptions.Users);
+
+    BenchClock::time_point start = BenchClock::now();
+    openLedger(TransactionsFileName);
+    addSuiteResult("ledger_open_migrate", SuiteOptions.Transactions, secondsSince(start), getLedgerSize(TransactionsFileName));
+
+    start = BenchClock::now();
+    ensureTransactionIndex(TransactionsFileName);
+    addSuiteResult("history_index_build", SuiteOptions.Transactions, secondsSince(start));
+
+    long long clientBytes = fileSizeOf(ClientsFileName);
+    start = BenchClock::now();
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    addSuiteResult("load_clients", vClients.size(), secondsSince(start), clientBytes);
+
+    start = BenchClock::now();
+    vector<strUser> vUsers = loadUsersDataFromFile(UsersFileName);
+    addSuiteResult("load_users", vUsers.size(), secondsSince(start), fileSizeOf(UsersFileName));
+
+    mt19937 random(7);
+    uniform_int_distribution<int> anyClient(0, SuiteOptions.Clients - 1);
+    size_t found = 0;
+    start = BenchClock::now();
+    for (int i = 0; i < operations; i++) {
+        found += findClientByAccountNumber(makeSyntheticClient(anyClient(random)).AccountNumber, vClients) != nullptr;
+    }
+    addSuiteResult("lookup_client", operations, secondsSince(start));
+
+    // Deposit as the screen does it after confirmation (balance change without the success message)
+    vector<double> latencies;
+    start = BenchClock::now();
+    for (int i = 0; i < operations; i++) {
+        BenchClock::time_point posted = BenchClock::now();
+        strClient* client = findClientByAccountNumber(makeSyntheticClient(anyClient(random)).AccountNumber, vClients);
+        client->AccountBalance += 100;
+        Transaction transaction = createDepositTransaction(client->AccountNumber, 100);
+        saveTransactionToFile(transaction);
+        commitBalanceChange(vClients, transaction.TransactionID, { { client->AccountNumber, 100 } });
+        latencies.push_back(secondsSince(posted) * 1e6);
+    }
+    addSuiteResult("deposit_flow", operations, secondsSince(start), 0, latencies);
+
+    latencies.clear();
+    start = BenchClock::now();
+    for (int i = 0; i < operations; i++) {
+        BenchClock::time_point posted = BenchClock::now();
+        int from = anyClient(random);
+        int to = (from + 1 + anyClient(random) % (SuiteOptions.Clients - 1)) % SuiteOptions.Clients;
+        strClient* fromClient = nullptr;
+        strClient* toClient = nullptr;
+        string fromAccount = makeSyntheticClient(from).AccountNumber;
+        string toAccount = makeSyntheticClient(to).AccountNumber;
+        Money fee = calculateTransferFee(100);
+        if (checkTransferAccounts(fromAccount, toAccount, fromClient, toClient, vClients).empty() &&
+            checkTransferAmount(100, fee, fromClient).empty()) {
+            executeTransfer(fromClient, toClient, 100, fee);
+            Transaction transaction = createTransferTransaction(fromAccount, toAccount, 100, fee, "Transfer to " + toClient->Name);
+            saveTransactionToFile(transaction);
+            commitBalanceChange(vClients, transaction.TransactionID, { { fromAccount, -(100 + fee) }, { toAccount, 100 } });
+        }
+        latencies.push_back(secondsSince(posted) * 1e6);
+    }
+    addSuiteResult("transfer_flow", operations, secondsSince(start), 0, latencies);
+
+    latencies.clear();
+    size_t rows = 0;
+    const int queries = max(1, operations / 10);
+    start = BenchClock::now();
+    for (int i = 0; i < queries; i++) {
+        BenchClock::time_point queried = BenchClock::now();
+        rows += loadAccountTransactions(TransactionsFileName, makeSyntheticClient(anyClient(random)).AccountNumber).size();
+        latencies.push_back(secondsSince(queried) * 1e6);
+    }
+    addSuiteResult("history_query", queries, secondsSince(start), 0, latencies);
+
+    start = BenchClock::now();
+    saveClientsToFileAtomic(ClientsFileName, vClients);
+    addSuiteResult("save_clients", vClients.size(), secondsSince(start), fileSizeOf(ClientsFileName));
+
+    runSuiteCodecs(vClients);
+    if (found + rows == 0) cout << "  (no clients found)\n";
+
+    if (!SuiteOptions.JsonFile.empty() && writeSuiteJson(SuiteOptions.JsonFile)) {
+        cout << "  results written to " << SuiteOptions.JsonFile << "\n";
+    }
+    resetLedgerFiles();
+}
+
+//=====================================================
+//==================== Account Ids ====================
+// The per-account history index keyed by account string
+// (as before the account dictionary) against the same
+// index keyed by dense account id, on the suite's scale
+// (--clients / --transactions).
+//=====================================================
+
+typedef unordered_map<string, vector<long long>> StringKeyedIndex;
+
+// Give freed heap back to the OS so the next memory delta counts only new allocations
+void releaseFreeHeap() {
+#ifdef __linux__
+    malloc_trim(0);
+#endif
+}
+// Index the whole ledger by account string, as the sidecar loader did; bytes = old sidecar size
+void buildStringKeyedIndex(StringKeyedIndex& index, long long& bytes) {
+    bytes = 0;
+    forEachLedgerLine(TransactionsFileName, 0, [&](long long offset, long long nextOffset, string_view line) {
+        string_view fields[4];
+        if (splitFieldViews(trimView(line), Separator, fields, 4) < 4) return;
+        string fromAccount(trimView(fields[2]));
+        string toAccount(trimView(fields[3]));
+        index[fromAccount].push_back(offset);
+        if (!toAccount.empty() && toAccount != fromAccount) index[toAccount].push_back(offset);
+        bytes += static_cast<long long>(to_string(offset).size() + to_string(nextOffset).size() +
+            fromAccount.size() + toAccount.size() + 3 * Separator.size() + 1);
+    });
+}
+// History of one account through the string-keyed index
+size_t loadAccountTransactionsByString(const StringKeyedIndex& index, const string& accountNumber) {
+    auto entry = index.find(accountNumber);
+    if (entry == index.end()) return 0;
+
+    strLedgerView view;
+    openLedgerView(TransactionsFileName, view);
+    string_view line;
+    string error;
+    strTransactionView record;
+    vector<Transaction> transactions;
+    transactions.reserve(entry->second.size());
+    for (long long offset : entry->second) {
+        if (readLedgerViewLine(view, offset, line) && parseTransactionView(line, record, error)) {
+            transactions.push_back(toTransaction(record));
+        }
+    }
+    closeLedgerView(view);
+    return transactions.size();
+}
+// Print one memory / time row
+void printAccountIdRow(const string& name, double memoryMB, double seconds) {
+    cout << "  " << left << setw(40) << name << right << fixed
+        << setw(9) << setprecision(1) << memoryMB << " MB"
+        << setw(10) << setprecision(3) << seconds << " s\n";
+}
+#ifndef _WIN32
+// Processes that loaded the same dictionary add accounts at once; every id they used must name their account
+void checkAccountIdProcesses(int processCount, int perProcess) {
+    ensureAccountDictionary();
+    size_t known = getAccountIdCount();
+    vector<pid_t> children;
+    for (int p = 0; p < processCount; p++) {
+        pid_t pid = forkBenchProcess();
+        if (pid == 0) {
+            ofstream out("account_ids" + to_string(p) + ".txt", ios::trunc);
+            for (int i = 0; i < perProcess; i++) {
+                string account = "NEW" + to_string(p) + "-" + to_string(i);
+                out << internAccountId(account) << Separator << account << "\n";
+                if (i % 10 == 9 && !flushAccountDictionary()) {
+                    out << "flush failed\n";
+                }
+            }
+            out.close();
+            _exit(out ? 0 : 1);
+        }
+        if (pid > 0) {
+            children.push_back(pid);
+        }
+    }
+    for (pid_t child : children) {
+        waitpid(child, nullptr, 0);
+    }
+
+    // What the children flushed is read back as a fresh process would
+    AccountIds.FileName.clear();
+    ensureAccountDictionary();
+    long long wrong = 0, checked = 0;
+    for (int p = 0; p < processCount; p++) {
+        string fileName = "account_ids" + to_string(p) + ".txt";
+        string content;
+        readFileToString(fileName, content);
+        forEachLine(content, [&](string_view line) {
+            string_view fields[2];
+            uint32_t id = NoAccountId;
+            if (splitFieldViews(line, Separator, fields, 2) != 2 ||
+                from_chars(fields[0].data(), fields[0].data() + fields[0].size(), id).ec != errc() ||
+                getAccountNumberById(id) != fields[1]) {
+                wrong++;
+            }
+            checked++;
+        });
+        remove(fileName.c_str());
+    }
+    cout << "  " << processCount << " processes adding accounts: " << getAccountIdCount() - known << " new ids, "
+        << checked << " used, " << wrong << " naming another account\n";
+    if (wrong > 0 || getAccountIdCount() - known != static_cast<size_t>(processCount) * perProcess) {
+        cout << "  ERROR: processes gave the same id to different accounts\n";
+    }
+}
+#endif
+// String-keyed versus id-keyed account structures: memory, build and history queries
+void benchmarkAccountIds() {
+    const int clientCount = max(1, SuiteOptions.Clients);
+    const int transactionCount = SuiteOptions.Transactions;
+    const int queries = 2000;
+
+    cout << "\nAccount ids (" << clientCount << " accounts, " << transactionCount << " ledger lines)\n";
+    remove(getAccountDictionaryFileName(ClientsFileName).c_str());
+    AccountIds = strAccountDictionary();
+    generateDataset(clientCount, transactionCount, 0);
+    openLedger(TransactionsFileName);
+
+    BenchClock::time_point start = BenchClock::now();
+    vector<strClient> vClients = loadClientsDataFromFile(ClientsFileName);
+    const strStringArena& accounts = AccountIds.Accounts;
+    double dictionaryMB = static_cast<double>(accounts.Chars.capacity() +
+        (accounts.Offsets.capacity() + accounts.Slots.capacity()) * sizeof(uint32_t)) / (1024 * 1024);
+    printAccountIdRow("load clients + assign ids", dictionaryMB, secondsSince(start));
+
+    releaseFreeHeap();
+    double memoryBefore = privateMemoryMB();
+    start = BenchClock::now();
+    StringKeyedIndex stringIndex;
+    long long stringSidecarBytes = 0;
+    buildStringKeyedIndex(stringIndex, stringSidecarBytes);
+    printAccountIdRow("history index, string keys", privateMemoryMB() - memoryBefore, secondsSince(start));
+
+    releaseFreeHeap();
+    memoryBefore = privateMemoryMB();
+    start = BenchClock::now();
+    rebuildTransactionIndex(TransactionsFileName);
+    printAccountIdRow("history index, account ids", privateMemoryMB() - memoryBefore, secondsSince(start));
+
+    TransactionIndex = strTransactionIndex();
+    start = BenchClock::now();
+    ensureTransactionIndex(TransactionsFileName);
+    printAccountIdRow("id sidecar load (per session)", 0, secondsSince(start));
+    cout << "  sidecar: " << stringSidecarBytes / (1024 * 1024) << " MB with account strings, "
+        << fileSizeOf(getTransactionIndexFileName(TransactionsFileName)) / (1024 * 1024) << " MB with ids\n";
+
+    vector<string> accountNumbers;
+    for (int i = 0; i < queries; i++) {
+        accountNumbers.push_back(makeSyntheticClient(i * 7919 % clientCount).AccountNumber);
+    }
+    size_t stringRows = 0, idRows = 0;
+    start = BenchClock::now();
+    for (const string& account : accountNumbers) stringRows += loadAccountTransactionsByString(stringIndex, account);
+    double stringSeconds = secondsSince(start);
+    start = BenchClock::now();
+    for (const string& account : accountNumbers) idRows += loadAccountTransactions(TransactionsFileName, account).size();
+    double idSeconds = secondsSince(start);
+    cout << "  history queries: " << setprecision(0) << queries / stringSeconds << " /s string keys, "
+        << queries / idSeconds << " /s account ids (" << idRows / queries << " rows avg)\n";
+
+    // Activity count per account over the whole ledger: hash every key, or count into a vector by id
+    start = BenchClock::now();
+    unordered_map<string, size_t> stringCounts;
+    forEachLedgerLine(TransactionsFileName, 0, [&](long long, long long, string_view line) {
+        string_view fields[4];
+        if (splitFieldViews(trimView(line), Separator, fields, 4) == 4) stringCounts[string(trimView(fields[2]))]++;
+    });
+    stringSeconds = secondsSince(start);
+    start = BenchClock::now();
+    vector<size_t> idCounts(getAccountIdCount());
+    forEachLedgerLine(TransactionsFileName, 0, [&](long long, long long, string_view line) {
+        string_view fields[4];
+        if (splitFieldViews(trimView(line), Separator, fields, 4) == 4) {
+            uint32_t id = getAccountId(trimView(fields[2]));
+            if (id < idCounts.size()) idCounts[id]++;
+        }
+    });
+    idSeconds = secondsSince(start);
+    cout << "  ledger scan by account: " << setprecision(2) << stringSeconds << " s string keys, "
+        << idSeconds << " s account ids\n";
+
+    if (stringRows != idRows || stringCounts.size() != static_cast<size_t>(count_if(idCounts.begin(), idCounts.end(),
+        [](size_t count) { return count > 0; }))) {
+        cout << "  ERROR: string and id results differ\n";
+    }
+#ifndef _WIN32
+    checkAccountIdProcesses(4, 1000);
+#endif
+    resetLedgerFiles();
+}
+
+//=====================================================
+//==================== Main Function ==================
+//=====================================================
+
+struct strBenchmark {
+    string Name;
+    void (*Run)();
+    bool   RunByDefault = true;             // false = only when named
+};
+// Read "--clients N" style options; other arguments are benchmark names. False on a bad option.
+bool parseSuiteOptions(int argc, char* argv[], vector<string>& names) {
+    for (int i = 1; i < argc; i++) {
+        string argument = argv[i];
+        if (argument.compare(0, 2, "--") != 0) {
+            names.push_back(argument);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << argument << "\n";
+            return false;
+        }
+
+        string value = argv[++i];
+        if (argument == "--json") {
+            // Paths are relative to where the program was started, not BenchmarkData
+            bool absolute = !value.empty() && (value[0] == '/' || value[0] == '\\' || value.find(':') != string::npos);
+            SuiteOptions.JsonFile = absolute ? value : "../" + value;
+            continue;
+        }
+
+        int number = 0;
+        const char* last = value.data() + value.size();
+        if (from_chars(value.data(), last, number).ptr != last || number < 0) {
+            cerr << "Invalid number for " << argument << ": " << value << "\n";
+            return false;
+        }
+        if (argument == "--clients") SuiteOptions.Clients = number;
+        else if (argument == "--transactions") SuiteOptions.Transactions = number;
+        else if (argument == "--users") SuiteOptions.Users = number;
+        else if (argument == "--operations") SuiteOptions.Operations = number;
+        else {
+            cerr << "Unknown option " << argument << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (sodium_init() < 0) {
+        cerr << "libsodium initialization failed\n";
+        return 1;
+    }
+
+    vector<strBenchmark> benchmarks = {
+        { "journal", benchmarkBalancePersistence },
+        { "binary",  benchmarkBinaryClients },
+        { "lookup",  benchmarkAccountLookup },
+        { "parse",   benchmarkRecordParsing },
+        { "load",    benchmarkParallelLoading },
+        { "history", benchmarkTransactionHistory },
+        { "recent",  benchmarkRecentTransactions },
+        { "txnid",   benchmarkTransactionIdLookup },
+        { "ids",     benchmarkTransactionIds },
+        { "accountids", benchmarkAccountIds },
+        { "ledger",  benchmarkSegmentedLedger },
+        { "ledgerview", benchmarkLedgerView },
+        { "logger",  benchmarkLogger },
+        { "metrics", benchmarkMetrics },
+        { "session", benchmarkSessionCache },
+        { "clientstore", benchmarkClientStore },
+        { "allocations", benchmarkLoadAllocations },
+        { "columns", benchmarkClientColumns },
+        { "durability", benchmarkDurability },
+        { "batch",   benchmarkBatchTransactions },
+        { "concurrent", benchmarkConcurrentLedger },
+#ifndef _WIN32
+        { "server",  benchmarkTellerServer },
+        { "render",  benchmarkScreenRenderer },
+#endif
+        { "suite",   benchmarkSuite, false },
+        { "generate", benchmarkGenerateDataset, false },
+    };
+
+    vector<string> names;
+    if (!parseSuiteOptions(argc, argv, names)) {
+        return 1;
+    }
+
+    // The other benchmarks measure code paths, not the disk; "durability" compares the modes
+    setDurabilityMode(DURABILITY_NONE);
+
+    mkdir("BenchmarkData");
+    if (chdir("BenchmarkData") != 0) {
+        cerr << "Cannot enter BenchmarkData folder\n";
+        return 1;
+    }
+
+    for (const strBenchmark& benchmark : benchmarks) {
+        bool selected = names.empty() && benchmark.RunByDefault;
+        for (const string& name : names) {
+            if (benchmark.Name == name) selected = true;
+        }
+        if (selected) {
+            benchmark.Run();
+        }
+    }
+    return 0;
+}